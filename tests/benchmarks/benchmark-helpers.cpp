@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tests/benchmarks/benchmark-helpers.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#include <sys/resource.h>
+#include <time.h>
+
+namespace {
+
+std::atomic<uint64_t> g_nAllocations{0};
+
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+  g_nAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+namespace ndn {
+namespace tests {
+
+uint64_t
+getAllocationCount()
+{
+  return g_nAllocations.load(std::memory_order_relaxed);
+}
+
+size_t
+getPeakRss()
+{
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+time::nanoseconds
+CpuTimer::now()
+{
+  timespec ts{};
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return time::seconds(ts.tv_sec) + time::nanoseconds(ts.tv_nsec);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const BenchmarkResult& result)
+{
+  if (result.nOperations == 0) {
+    return os << "no " << result.unit << "s processed";
+  }
+
+  double cpuSeconds = result.cpuTime.count() / 1e9;
+  return os << std::fixed << std::setprecision(1)
+            << (cpuSeconds > 0 ? result.nOperations / cpuSeconds : 0) << " " << result.unit << "s/s, "
+            << std::setprecision(2)
+            << static_cast<double>(result.nAllocations) / result.nOperations
+            << " allocs/" << result.unit << ", "
+            << result.cpuTime.count() / 1e3 / result.nOperations << " us CPU/" << result.unit;
+}
+
+} // namespace tests
+} // namespace ndn
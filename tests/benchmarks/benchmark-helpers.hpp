@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_TESTS_BENCHMARKS_BENCHMARK_HELPERS_HPP
+#define NDN_TOOLS_TESTS_BENCHMARKS_BENCHMARK_HELPERS_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace tests {
+
+/** \brief Returns the number of calls to operator new made so far by this process.
+ */
+uint64_t
+getAllocationCount();
+
+/** \brief Returns the peak resident set size of this process so far, in bytes.
+ */
+size_t
+getPeakRss();
+
+/** \brief Measures the CPU time consumed by this process.
+ */
+class CpuTimer
+{
+public:
+  CpuTimer()
+    : m_start(now())
+  {
+  }
+
+  time::nanoseconds
+  elapsed() const
+  {
+    return now() - m_start;
+  }
+
+private:
+  static time::nanoseconds
+  now();
+
+private:
+  time::nanoseconds m_start;
+};
+
+/** \brief Cost of a repeated operation, e.g. fetching one segment.
+ */
+struct BenchmarkResult
+{
+  std::string unit;        ///< name of one operation, e.g. "segment"
+  uint64_t nOperations;    ///< number of operations performed
+  time::nanoseconds cpuTime;
+  uint64_t nAllocations;
+};
+
+/** \brief Prints operations per CPU second, allocations per operation, and CPU time per operation.
+ */
+std::ostream&
+operator<<(std::ostream& os, const BenchmarkResult& result);
+
+} // namespace tests
+} // namespace ndn
+
+#endif // NDN_TOOLS_TESTS_BENCHMARKS_BENCHMARK_HELPERS_HPP
@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ndn-tools chunks pipelines benchmark
+#include "tests/boost-test.hpp"
+
+#include "tests/benchmarks/benchmark-helpers.hpp"
+#include "tests/chunks/pipeline-interests-fixture.hpp"
+
+#include "tools/chunks/catchunks/consumer.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-aimd.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-cubic.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-fixed.hpp"
+#include "tools/chunks/putchunks/segmenter.hpp"
+
+#include <ndn-cxx/security/validator-null.hpp>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <random>
+#include <sstream>
+#include <streambuf>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/** \brief Parameters of the emulated transfer.
+ *
+ *  They can be changed on the command line after a "--" separator, for example:
+ *
+ *      bench-chunks-pipelines -- --segments 50000 --loss 0.01 --reorder 0.05 --delay 20
+ */
+struct BenchmarkParameters
+{
+  uint64_t nSegments = 10000;
+  size_t segmentSize = 4096;
+  double lossRate = 0.0;         ///< probability that an Interest is dropped
+  double reorderRate = 0.0;      ///< probability that a Data is delayed by twice the link delay
+  time::milliseconds delay = 10_ms; ///< time between sending an Interest and receiving its Data
+};
+
+static BenchmarkParameters
+parseParameters()
+{
+  namespace po = boost::program_options;
+
+  BenchmarkParameters params;
+  time::milliseconds::rep delay = params.delay.count();
+  po::options_description desc("Benchmark options");
+  desc.add_options()
+    ("segments", po::value<uint64_t>(&params.nSegments)->default_value(params.nSegments),
+                 "number of segments to fetch")
+    ("size",     po::value<size_t>(&params.segmentSize)->default_value(params.segmentSize),
+                 "payload size of each segment, in bytes")
+    ("loss",     po::value<double>(&params.lossRate)->default_value(params.lossRate),
+                 "probability that an Interest is lost")
+    ("reorder",  po::value<double>(&params.reorderRate)->default_value(params.reorderRate),
+                 "probability that a Data packet is delayed and thus reordered")
+    ("delay",    po::value<time::milliseconds::rep>(&delay)->default_value(delay),
+                 "round-trip delay of the emulated link, in milliseconds")
+    ;
+
+  auto& suite = boost::unit_test::framework::master_test_suite();
+  po::variables_map vm;
+  po::store(po::parse_command_line(suite.argc, suite.argv, desc), vm);
+  po::notify(vm);
+
+  if (params.nSegments == 0) {
+    NDN_THROW(std::invalid_argument("--segments must be positive"));
+  }
+  params.delay = time::milliseconds(delay);
+  return params;
+}
+
+/** \brief A stream buffer that discards everything written to it, counting the bytes.
+ */
+class CountingBuffer : public std::streambuf
+{
+public:
+  uint64_t
+  getCount() const
+  {
+    return m_count;
+  }
+
+protected:
+  int_type
+  overflow(int_type ch) final
+  {
+    ++m_count;
+    return ch;
+  }
+
+  std::streamsize
+  xsputn(const char_type*, std::streamsize count) final
+  {
+    m_count += count;
+    return count;
+  }
+
+private:
+  uint64_t m_count = 0;
+};
+
+/** \brief Answers every Interest sent by the pipeline after the link delay,
+ *         unless the Interest is lost on the emulated link.
+ *
+ *  All Data packets are built and signed beforehand, so that only the consumer side is measured.
+ */
+class PipelineBenchmarkFixture : public PipelineInterestsFixture
+{
+protected:
+  PipelineBenchmarkFixture()
+    : PipelineInterestsFixture(util::DummyClientFace::Options{false, false})
+    , params(parseParameters())
+    , rttEstimator(make_shared<RttEstimatorWithStats::Options>())
+  {
+    opt.isQuiet = true;
+    opt.maxPipelineSize = 64;
+
+    // segments carry the nested payload and the hash of the next segment, as served by putchunks
+    nDataSegments = params.nSegments;
+    std::istringstream is(std::string(params.segmentSize * nDataSegments, 'x'));
+    Producer::Options producerOpts;
+    producerOpts.maxSegmentSize = params.segmentSize + 32;
+    m_data = makeChainedSegments(Name(name).appendVersion(0), is, producerOpts);
+    BOOST_REQUIRE_EQUAL(m_data.size(), nDataSegments);
+    signData(*m_data.front());
+
+    face.onSendInterest.connect([this] (const Interest& interest) { forwardInterest(interest); });
+  }
+
+  /** \brief Runs the event loop until the transfer is finished and measures its cost.
+   */
+  BenchmarkResult
+  transfer(const std::function<bool()>& isFinished)
+  {
+    auto startTime = time::steady_clock::now();
+    uint64_t nAllocations = getAllocationCount();
+    CpuTimer timer;
+
+    while (!isFinished() && !hasFailed &&
+           time::steady_clock::now() - startTime < MAX_TRANSFER_TIME) {
+      advanceClocks(1_ms);
+    }
+
+    BenchmarkResult result{"segment", nDataSegments, timer.elapsed(),
+                           getAllocationCount() - nAllocations};
+    transferTime = time::steady_clock::now() - startTime;
+    BOOST_REQUIRE(isFinished());
+    BOOST_REQUIRE(!hasFailed);
+    return result;
+  }
+
+  void
+  runPipeline(const std::string& label, unique_ptr<PipelineInterests> pipeline)
+  {
+    auto pipelinePtr = pipeline.get();
+    setPipeline(std::move(pipeline));
+    run(name);
+    auto result = transfer([pipelinePtr] { return pipelinePtr->isFinished(); });
+    report(label, result);
+  }
+
+  void
+  report(const std::string& label, const BenchmarkResult& result) const
+  {
+    std::cout << label << ": " << result << "; "
+              << nDropped << " Interests dropped, "
+              << time::duration_cast<time::milliseconds>(transferTime) << " emulated transfer time"
+              << std::endl;
+  }
+
+private:
+  void
+  forwardInterest(const Interest& interest)
+  {
+    if (m_dist(m_rng) < params.lossRate) {
+      nDropped++;
+      return;
+    }
+
+    auto delay = params.delay;
+    if (m_dist(m_rng) < params.reorderRate) {
+      delay += params.delay;
+    }
+
+    uint64_t segNo = interest.getName()[-1].toSegment();
+    m_scheduler.schedule(delay, [this, segNo] { face.receive(*m_data.at(segNo)); });
+  }
+
+protected:
+  static constexpr time::seconds MAX_TRANSFER_TIME{3600};
+
+  const BenchmarkParameters params;
+  Options opt;
+  RttEstimatorWithStats rttEstimator;
+  uint64_t nDropped = 0;
+  time::nanoseconds transferTime = 0_ns;
+
+private:
+  Scheduler m_scheduler{m_io};
+  std::mt19937 m_rng{0};
+  std::uniform_real_distribution<double> m_dist{0.0, 1.0};
+  std::vector<shared_ptr<Data>> m_data;
+};
+
+constexpr time::seconds PipelineBenchmarkFixture::MAX_TRANSFER_TIME;
+
+BOOST_FIXTURE_TEST_SUITE(ChunksPipelines, PipelineBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(Fixed)
+{
+  runPipeline("fixed", make_unique<PipelineInterestsFixed>(face, opt));
+}
+
+BOOST_AUTO_TEST_CASE(Aimd)
+{
+  runPipeline("aimd", make_unique<PipelineInterestsAimd>(face, rttEstimator, opt));
+}
+
+BOOST_AUTO_TEST_CASE(Cubic)
+{
+  runPipeline("cubic", make_unique<PipelineInterestsCubic>(face, rttEstimator, opt));
+}
+
+BOOST_AUTO_TEST_CASE(ConsumerWithAimd)
+{
+  CountingBuffer countingBuffer;
+  std::ostream os(&countingBuffer);
+  Consumer consumer(security::getAcceptAllValidator(), os);
+
+  auto versionedName = Name(name).appendVersion(0);
+  consumer.run(make_unique<DiscoverVersion>(face, versionedName, opt),
+               make_unique<PipelineInterestsAimd>(face, rttEstimator, opt));
+  auto result = transfer([&consumer] { return consumer.isFinished(); });
+  report("consumer+aimd", result);
+  BOOST_CHECK_EQUAL(countingBuffer.getCount(), params.segmentSize * nDataSegments);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ndn-tools chunks producer benchmark
+#include "tests/boost-test.hpp"
+
+#include "tests/benchmarks/benchmark-helpers.hpp"
+#include "tests/io-fixture.hpp"
+#include "tests/key-chain-fixture.hpp"
+
+#include "tools/chunks/putchunks/producer.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+/** \brief Parameters of the sweep.
+ *
+ *  They can be changed on the command line after a "--" separator, for example:
+ *
+ *      bench-chunks-producer -- --input-size 1000000 100000000 --segment-size 1400 8000 \
+ *                               --signing sha256 ecdsa --interests 1000000
+ */
+struct BenchmarkParameters
+{
+  std::vector<size_t> inputSizes{1000000, 16000000};
+  std::vector<size_t> segmentSizes{1400, 4400, 8000};
+  std::vector<std::string> signingModes{"sha256", "ecdsa", "rsa"};
+  uint64_t nInterests = 200000;
+};
+
+static BenchmarkParameters
+parseParameters()
+{
+  namespace po = boost::program_options;
+
+  BenchmarkParameters params;
+  po::options_description desc("Benchmark options");
+  desc.add_options()
+    ("input-size",   po::value<std::vector<size_t>>(&params.inputSizes)->multitoken(),
+                     "sizes of the published object, in bytes")
+    ("segment-size", po::value<std::vector<size_t>>(&params.segmentSizes)->multitoken(),
+                     "maximum segment sizes, in bytes")
+    ("signing",      po::value<std::vector<std::string>>(&params.signingModes)->multitoken(),
+                     "signing modes of the first segment: 'sha256', 'ecdsa', 'rsa'")
+    ("interests",    po::value<uint64_t>(&params.nInterests)->default_value(params.nInterests),
+                     "number of Interests to answer for each segment size")
+    ;
+
+  auto& suite = boost::unit_test::framework::master_test_suite();
+  po::variables_map vm;
+  po::store(po::parse_command_line(suite.argc, suite.argv, desc), vm);
+  po::notify(vm);
+  return params;
+}
+
+class ProducerBenchmarkFixture : public IoFixture, public KeyChainFixture
+{
+protected:
+  ProducerBenchmarkFixture()
+    : params(parseParameters())
+  {
+    options.isQuiet = true;
+  }
+
+  security::SigningInfo
+  makeSigningInfo(const std::string& mode)
+  {
+    if (mode == "sha256") {
+      return signingWithSha256();
+    }
+    if (mode == "ecdsa") {
+      return signingByIdentity(m_keyChain.createIdentity("/bench/ecdsa", EcKeyParams()));
+    }
+    if (mode == "rsa") {
+      return signingByIdentity(m_keyChain.createIdentity("/bench/rsa", RsaKeyParams()));
+    }
+    NDN_THROW(std::invalid_argument("unknown signing mode '" + mode + "'"));
+  }
+
+  /** \brief Returns the number of segments created by Producer for an input of @p inputSize bytes.
+   *
+   *  Each segment carries up to maxSegmentSize - 32 bytes of input, followed by the hash of the next
+   *  segment.
+   */
+  static uint64_t
+  getSegmentCount(size_t inputSize, size_t maxSegmentSize)
+  {
+    size_t payloadSize = maxSegmentSize - 32;
+    return std::max<uint64_t>((inputSize + payloadSize - 1) / payloadSize, 1);
+  }
+
+  static std::string
+  formatMegabytes(double bytes)
+  {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << bytes / 1e6 << " MB";
+    return os.str();
+  }
+
+protected:
+  const BenchmarkParameters params;
+  Name prefix = Name("/ndn/chunks/bench").appendVersion(1);
+  Producer::Options options;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ChunksProducer, ProducerBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(PopulateStore)
+{
+  for (const auto& mode : params.signingModes) {
+    options.signingInfo = makeSigningInfo(mode);
+    for (size_t segmentSize : params.segmentSizes) {
+      options.maxSegmentSize = segmentSize;
+      for (size_t inputSize : params.inputSizes) {
+        // the input buffer is built outside of the measured section
+        std::istringstream is(std::string(inputSize, 'a'));
+        util::DummyClientFace face(m_io, {false, true});
+        uint64_t nAllocations = getAllocationCount();
+        CpuTimer timer;
+        Producer producer(prefix, face, m_keyChain, is, options);
+        auto cpuTime = timer.elapsed();
+
+        std::cout << "input=" << inputSize << " segment=" << segmentSize << " signing=" << mode << ": "
+                  << formatMegabytes(inputSize / (cpuTime.count() / 1e9)) << "/s, "
+                  << BenchmarkResult{"segment", getSegmentCount(inputSize, segmentSize), cpuTime,
+                                     getAllocationCount() - nAllocations}
+                  << ", peak RSS " << formatMegabytes(getPeakRss()) << std::endl;
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ServeSegments)
+{
+  size_t inputSize = *std::max_element(params.inputSizes.begin(), params.inputSizes.end());
+  for (size_t segmentSize : params.segmentSizes) {
+    options.maxSegmentSize = segmentSize;
+    std::istringstream is(std::string(inputSize, 'a'));
+    util::DummyClientFace face(m_io, {false, true});
+    Producer producer(prefix, face, m_keyChain, is, options);
+    advanceClocks(1_ms);
+
+    // request the segments in order, wrapping around at the end of the object
+    uint64_t nSegments = getSegmentCount(inputSize, segmentSize);
+    std::vector<Interest> interests;
+    interests.reserve(nSegments);
+    for (uint64_t segNo = 0; segNo < nSegments; ++segNo) {
+      interests.emplace_back(Name(prefix).appendSegment(segNo));
+    }
+
+    uint64_t nSent = 0;
+    util::signal::ScopedConnection conn = face.onSendData.connect([&nSent] (const Data&) { nSent++; });
+
+    uint64_t nAllocations = getAllocationCount();
+    CpuTimer timer;
+    for (uint64_t i = 0; i < params.nInterests; ++i) {
+      face.receive(interests[i % interests.size()]);
+      if (i % 1000 == 999) {
+        m_io.poll();
+      }
+    }
+    m_io.poll();
+    BenchmarkResult result{"Interest", params.nInterests, timer.elapsed(),
+                           getAllocationCount() - nAllocations};
+
+    BOOST_CHECK_EQUAL(nSent, params.nInterests);
+    std::cout << "segment=" << segmentSize << ": " << result
+              << ", peak RSS " << formatMegabytes(getPeakRss()) << std::endl;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
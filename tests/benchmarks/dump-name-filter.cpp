@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ndn-tools dump name filter benchmark
+#include "tests/boost-test.hpp"
+
+#include "tests/benchmarks/benchmark-helpers.hpp"
+#include "tests/test-common.hpp"
+
+#include "tools/dump/ndndump.hpp"
+
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/net/ethernet.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+/** \brief Parameters of the benchmark.
+ *
+ *  They can be changed on the command line after a "--" separator, for example:
+ *
+ *      bench-dump-name-filter -- --packets 2000000 --filter /ndn/edu --regex "/ndn/edu/.*"
+ */
+struct BenchmarkParameters
+{
+  uint64_t nPackets = 500000;
+  std::string filter = "/ndn/edu/*/ping";
+  std::string regex = "/ndn/edu/[^/]+/ping(/.*)?";
+};
+
+static BenchmarkParameters
+parseParameters()
+{
+  namespace po = boost::program_options;
+
+  BenchmarkParameters params;
+  po::options_description desc("Benchmark options");
+  desc.add_options()
+    ("packets", po::value<uint64_t>(&params.nPackets)->default_value(params.nPackets),
+                "number of packets in the capture file")
+    ("filter",  po::value<std::string>(&params.filter)->default_value(params.filter),
+                "name filter, as given to 'ndndump --filter'")
+    ("regex",   po::value<std::string>(&params.regex)->default_value(params.regex),
+                "equivalent regular expression, as given to 'ndndump --regex'")
+    ;
+
+  auto& suite = boost::unit_test::framework::master_test_suite();
+  po::variables_map vm;
+  po::store(po::parse_command_line(suite.argc, suite.argv, desc), vm);
+  po::notify(vm);
+  return params;
+}
+
+/** \brief Discards everything written to it.
+ */
+class NullBuffer : public std::streambuf
+{
+protected:
+  int_type
+  overflow(int_type ch) final
+  {
+    return ch;
+  }
+
+  std::streamsize
+  xsputn(const char_type*, std::streamsize count) final
+  {
+    return count;
+  }
+};
+
+class NameFilterBenchmarkFixture
+{
+protected:
+  NameFilterBenchmarkFixture()
+    : params(parseParameters())
+    , m_file((boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path("bench-dump-%%%%-%%%%.pcap")).string())
+  {
+    writeCaptureFile();
+  }
+
+  ~NameFilterBenchmarkFixture()
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(m_file, ec);
+  }
+
+  /** \brief Writes Ethernet frames with alternating Interests and Data, half of which match
+   *         the default filter.
+   */
+  void
+  writeCaptureFile()
+  {
+    pcap_t* pcap = pcap_open_dead(DLT_EN10MB, 65535);
+    pcap_dumper_t* dumper = pcap_dump_open(pcap, m_file.data());
+    BOOST_REQUIRE(dumper != nullptr);
+
+    const uint16_t ethertype = boost::endian::native_to_big(ethernet::ETHERTYPE_NDN);
+    ethernet::Address host;
+
+    for (uint64_t i = 0; i < params.nPackets; ++i) {
+      Name name(i % 4 < 2 ? "/ndn/edu/arizona/ping" : "/ndn/edu/arizona/traceroute");
+      name.appendNumber(i / 2);
+
+      Block packet = i % 2 == 0 ?
+                     makeInterest(name, false, DEFAULT_INTEREST_LIFETIME, static_cast<uint32_t>(i))->wireEncode() :
+                     makeData(name)->wireEncode();
+      EncodingBuffer buffer(packet);
+      buffer.prependByteArray(reinterpret_cast<const uint8_t*>(&ethertype), ethernet::TYPE_LEN);
+      buffer.prependByteArray(host.data(), host.size());
+      buffer.prependByteArray(host.data(), host.size());
+
+      pcap_pkthdr pkthdr{};
+      pkthdr.caplen = pkthdr.len = buffer.size();
+      pcap_dump(reinterpret_cast<uint8_t*>(dumper), &pkthdr, buffer.buf());
+    }
+
+    pcap_dump_close(dumper);
+    pcap_close(pcap);
+  }
+
+  void
+  run(const std::string& label, NdnDump& dump)
+  {
+    dump.inputFile = m_file;
+    dump.pcapFilter = "";
+
+    NullBuffer nullBuffer;
+    std::streambuf* originalBuffer = std::cout.rdbuf(&nullBuffer);
+    uint64_t nAllocations = getAllocationCount();
+    CpuTimer timer;
+    dump.run();
+    BenchmarkResult result{"packet", params.nPackets, timer.elapsed(),
+                           getAllocationCount() - nAllocations};
+    std::cout.rdbuf(originalBuffer);
+
+    std::cout << label << ": " << result << std::endl;
+  }
+
+protected:
+  const BenchmarkParameters params;
+
+private:
+  const std::string m_file;
+};
+
+BOOST_FIXTURE_TEST_SUITE(DumpNameFilter, NameFilterBenchmarkFixture)
+
+BOOST_AUTO_TEST_CASE(ReadFile)
+{
+  {
+    NdnDump dump;
+    run("no filter", dump);
+  }
+  {
+    NdnDump dump;
+    dump.nameFilter.emplace(params.filter);
+    run("filter=" + params.filter, dump);
+  }
+  {
+    NdnDump dump;
+    dump.nameRegex = std::regex(params.regex);
+    run("regex=" + params.regex, dump);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
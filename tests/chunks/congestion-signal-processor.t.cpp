@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/congestion-signal-processor.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+class CongestionSignalProcessorFixture
+{
+protected:
+  Options opt;
+  CongestionSignalProcessor processor{opt};
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestCongestionSignalProcessor, CongestionSignalProcessorFixture)
+
+BOOST_AUTO_TEST_CASE(OneDecreasePerRound)
+{
+  processor.onData(0, 4);
+  processor.onData(1, 5);
+
+  // a timeout starts a new congestion event
+  auto d1 = processor.onCongestionSignal(CongestionSignal::Timeout, 2, 6);
+  BOOST_CHECK_EQUAL(d1.shouldDecreaseWindow, true);
+  BOOST_CHECK_EQUAL(d1.shouldBackoffRto, true);
+  BOOST_CHECK_EQUAL(d1.pacingDelay, 0_ms);
+
+  // any other signal in the same round is ignored
+  auto d2 = processor.onCongestionSignal(CongestionSignal::CongestionMark, 1, 6);
+  BOOST_CHECK_EQUAL(d2.shouldDecreaseWindow, false);
+  processor.onData(4, 6);
+  auto d3 = processor.onCongestionSignal(CongestionSignal::CongestionNack, 5, 7);
+  BOOST_CHECK_EQUAL(d3.shouldDecreaseWindow, false);
+
+  // once a segment requested after the last decrease is answered, a new event can start
+  processor.onData(7, 8);
+  auto d4 = processor.onCongestionSignal(CongestionSignal::CongestionMark, 7, 8);
+  BOOST_CHECK_EQUAL(d4.shouldDecreaseWindow, true);
+  BOOST_CHECK_EQUAL(d4.shouldBackoffRto, false);
+}
+
+BOOST_AUTO_TEST_CASE(DisableCwa)
+{
+  opt.disableCwa = true;
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    auto d = processor.onCongestionSignal(CongestionSignal::Timeout, i, 5);
+    BOOST_CHECK_EQUAL(d.shouldDecreaseWindow, true);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(IgnoreCongestionMarks)
+{
+  opt.ignoreCongMarks = true;
+  processor.onData(1, 5);
+
+  auto d = processor.onCongestionSignal(CongestionSignal::CongestionMark, 1, 5);
+  BOOST_CHECK_EQUAL(d.shouldDecreaseWindow, false);
+  BOOST_CHECK_EQUAL(d.shouldBackoffRto, false);
+}
+
+BOOST_AUTO_TEST_CASE(NackPacing)
+{
+  processor.onData(0, 4);
+  processor.onData(1, 5);
+
+  // the first round with congestion Nacks is not paced
+  auto d1 = processor.onCongestionSignal(CongestionSignal::CongestionNack, 3, 6);
+  BOOST_CHECK_EQUAL(d1.shouldDecreaseWindow, true);
+  BOOST_CHECK_EQUAL(d1.pacingDelay, 0_ms);
+  BOOST_CHECK_EQUAL(processor.getNackRounds(), 0);
+
+  // Nacks in consecutive rounds double the pacing delay
+  auto d2 = processor.onCongestionSignal(CongestionSignal::CongestionNack, 6, 8);
+  BOOST_CHECK_EQUAL(d2.shouldDecreaseWindow, false);
+  BOOST_CHECK_EQUAL(d2.pacingDelay, 1_ms);
+  BOOST_CHECK_EQUAL(processor.getNackRounds(), 1);
+
+  auto d3 = processor.onCongestionSignal(CongestionSignal::CongestionNack, 9, 10);
+  BOOST_CHECK_EQUAL(d3.shouldDecreaseWindow, true);
+  BOOST_CHECK_EQUAL(d3.pacingDelay, 2_ms);
+  BOOST_CHECK_EQUAL(processor.getNackRounds(), 2);
+
+  // a full round without congestion Nacks resets the backoff
+  processor.onData(11, 12);
+  BOOST_CHECK_EQUAL(processor.getNackRounds(), 3);
+  processor.onData(13, 14);
+  BOOST_CHECK_EQUAL(processor.getNackRounds(), 0);
+
+  auto d4 = processor.onCongestionSignal(CongestionSignal::CongestionNack, 14, 15);
+  BOOST_CHECK_EQUAL(d4.pacingDelay, 0_ms);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCongestionSignalProcessor
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -26,6 +26,7 @@
 #include "tools/chunks/catchunks/consumer.hpp"
 #include "tools/chunks/catchunks/discover-version.hpp"
 #include "tools/chunks/catchunks/pipeline-interests.hpp"
+#include "tools/chunks/common/segment-codec.hpp"
 
 #include "tests/test-common.hpp"
 #include "tests/io-fixture.hpp"
@@ -33,6 +34,12 @@
 #include <ndn-cxx/security/validator-null.hpp>
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
 #if BOOST_VERSION >= 105900
 #include <boost/test/tools/output_test_stream.hpp>
 #else
@@ -131,6 +138,152 @@ BOOST_AUTO_TEST_CASE(OutOfOrderData)
   BOOST_CHECK(output.is_equal(testStrings[2]));
 }
 
+BOOST_AUTO_TEST_CASE(CompressedData)
+{
+  // Segment order: 2 0 1 3, segments 1 and 3 compressed when a codec is available
+
+  Codec codec = isCodecAvailable(Codec::Zstd) ? Codec::Zstd : Codec::Lz4;
+  if (!isCodecAvailable(codec)) {
+    BOOST_TEST_MESSAGE("No compression codec available, skipping");
+    return;
+  }
+
+  const std::vector<std::string> testStrings {
+      "a1b2c3",
+      std::string(1000, 'x'),
+      "Lorem ipsum dolor sit amet",
+      std::string(500, 'y') + std::string(500, 'z'),
+  };
+
+  std::ostringstream output;
+  Consumer cons(security::getAcceptAllValidator(), output);
+
+  std::vector<shared_ptr<Data>> dataStore;
+  for (size_t i = 0; i < testStrings.size(); ++i) {
+    uint32_t contentType = tlv::ContentType_Blob;
+    const auto* buf = reinterpret_cast<const uint8_t*>(testStrings[i].data());
+    auto payload = i % 2 == 1 ?
+                   encodePayload(codec, buf, testStrings[i].size(), contentType) :
+                   std::vector<uint8_t>(buf, buf + testStrings[i].size());
+    BOOST_CHECK_EQUAL(isCompressed(contentType), i % 2 == 1);
+
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+    data->setContentType(contentType);
+    Block content(tlv::Content);
+    content.push_back(makeBinaryBlock(tlv::Content, payload.data(), payload.size()));
+    content.push_back(Block(tlv::SignatureValue));
+    data->setContent(content);
+    dataStore.push_back(data);
+  }
+
+  for (size_t i : {2, 0, 1, 3}) {
+    cons.m_bufferedData[i] = dataStore[i];
+    cons.writeInOrderData();
+  }
+  cons.finish();
+
+  BOOST_CHECK(cons.m_bufferedData.empty());
+  BOOST_CHECK_EQUAL(output.str(), testStrings[0] + testStrings[1] + testStrings[2] + testStrings[3]);
+}
+
+/**
+ * @brief String stream buffer whose writes block until open() is called
+ */
+class GatedStringBuf : public std::stringbuf
+{
+public:
+  void
+  open()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isOpen = true;
+    }
+    m_cv.notify_all();
+  }
+
+protected:
+  std::streamsize
+  xsputn(const char_type* s, std::streamsize n) final
+  {
+    waitUntilOpen();
+    return std::stringbuf::xsputn(s, n);
+  }
+
+  int_type
+  overflow(int_type c) final
+  {
+    waitUntilOpen();
+    return std::stringbuf::overflow(c);
+  }
+
+private:
+  void
+  waitUntilOpen()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_isOpen; });
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_isOpen = false;
+};
+
+BOOST_AUTO_TEST_CASE(SlowOutput)
+{
+  Codec codec = isCodecAvailable(Codec::Zstd) ? Codec::Zstd : Codec::Lz4;
+  if (!isCodecAvailable(codec)) {
+    BOOST_TEST_MESSAGE("No compression codec available, skipping");
+    return;
+  }
+
+  const size_t nSegments = 10;
+  const std::string payload(1000, 'x');
+
+  GatedStringBuf buf;
+  std::ostream output(&buf);
+  Consumer cons(security::getAcceptAllValidator(), output);
+  cons.m_decoderQueueCapacity = 2;
+
+  for (size_t i = 0; i < nSegments; ++i) {
+    uint32_t contentType = tlv::ContentType_Blob;
+    auto encoded = encodePayload(codec, reinterpret_cast<const uint8_t*>(payload.data()),
+                                 payload.size(), contentType);
+    auto data = makeData(Name("/ndn/chunks/test").appendVersion(1).appendSegment(i));
+    data->setContentType(contentType);
+    Block content(tlv::Content);
+    content.push_back(makeBinaryBlock(tlv::Content, encoded.data(), encoded.size()));
+    content.push_back(Block(tlv::SignatureValue));
+    data->setContent(content);
+    cons.m_bufferedData[i] = data;
+  }
+
+  // the decoder thread blocks on its first write, so the queue fills up and writing the
+  // remaining segments blocks instead of queueing them
+  std::atomic<bool> isWritten(false);
+  std::thread writer([&] {
+    cons.writeInOrderData();
+    isWritten = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  BOOST_CHECK(!isWritten);
+  {
+    std::lock_guard<std::mutex> lock(cons.m_decoderMutex);
+    BOOST_CHECK_LE(cons.m_decoderQueue.size(), 2U);
+  }
+
+  buf.open();
+  writer.join();
+  cons.finish();
+
+  BOOST_CHECK(isWritten);
+  BOOST_CHECK(cons.m_bufferedData.empty());
+  BOOST_CHECK(cons.m_decoderQueue.empty());
+  BOOST_CHECK_EQUAL(buf.str().size(), nSegments * payload.size());
+}
+
 class PipelineInterestsDummy : public PipelineInterests
 {
 public:
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/directory-publisher.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/key-chain-fixture.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class DirectoryPublisherFixture : public KeyChainFixture
+{
+protected:
+  DirectoryPublisherFixture()
+  {
+    boost::filesystem::remove_all(root);
+    writeFile("a", "");
+    writeFile("c", std::string(100, 'c'));
+    writeFile("sub/b", std::string(2500, 'b'));
+
+    options.isQuiet = true;
+    options.maxSegmentSize = 1000;
+    options.signingInfo = signingWithSha256();
+  }
+
+  ~DirectoryPublisherFixture()
+  {
+    boost::filesystem::remove_all(root);
+  }
+
+  void
+  writeFile(const std::string& relPath, const std::string& contents)
+  {
+    auto path = inputDir / relPath;
+    boost::filesystem::create_directories(path.parent_path());
+    std::ofstream os(path.string(), std::ios::binary);
+    os << contents;
+  }
+
+  /**
+   * @brief check the hash chain of the segment file at @p path and return its payload
+   */
+  static std::string
+  readObject(const boost::filesystem::path& path)
+  {
+    SegmentFile file(path.string());
+    std::string payload;
+    Block expectedHash;
+    for (size_t i = file.size(); i-- > 0;) {
+      Data data(file.getSegment(i));
+      BOOST_CHECK_EQUAL(data.getSignatureInfo().getSignatureType(), tlv::DigestSha256);
+      BOOST_CHECK_EQUAL(data.getFinalBlock().value(), name::Component::fromSegment(file.size() - 1));
+
+      // the last element is the signature value of the next segment (empty in the last one)
+      Block content = data.getContent();
+      content.parse();
+      BOOST_REQUIRE(!content.elements().empty());
+      if (i + 1 < file.size()) {
+        BOOST_CHECK(content.elements().back() == expectedHash);
+      }
+      if (content.elements().size() > 1) {
+        const auto& chunk = content.elements().front();
+        payload.insert(0, reinterpret_cast<const char*>(chunk.value()), chunk.value_size());
+      }
+      expectedHash = data.getSignatureValue();
+    }
+    return payload;
+  }
+
+protected:
+  boost::filesystem::path root = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "directory-publisher";
+  boost::filesystem::path inputDir = root / "input";
+  boost::filesystem::path storeDir = root / "store";
+  Name prefix = "/ndn/chunks/tree";
+  Producer::Options options;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestDirectoryPublisher, DirectoryPublisherFixture)
+
+BOOST_AUTO_TEST_CASE(Publish)
+{
+  DirectoryPublisher publisher(prefix, m_keyChain, options, 2);
+  auto objects = publisher.publish(inputDir.string(), storeDir.string());
+
+  BOOST_REQUIRE_EQUAL(objects.size(), 3);
+  const auto version = objects[0].versionedName[-1];
+  BOOST_CHECK(version.isVersion());
+  BOOST_CHECK_EQUAL(objects[0].versionedName, Name(prefix).append("a").append(version));
+  BOOST_CHECK_EQUAL(objects[0].size, 0);
+  BOOST_CHECK_EQUAL(objects[1].versionedName, Name(prefix).append("c").append(version));
+  BOOST_CHECK_EQUAL(objects[1].size, 100);
+  BOOST_CHECK_EQUAL(objects[2].versionedName, Name(prefix).append("sub").append("b").append(version));
+  BOOST_CHECK_EQUAL(objects[2].size, 2500);
+
+  BOOST_CHECK_EQUAL(readObject(storeDir / "objects" / "a.store"), "");
+  BOOST_CHECK_EQUAL(readObject(storeDir / "objects" / "c.store"), std::string(100, 'c'));
+  BOOST_CHECK_EQUAL(readObject(storeDir / "objects" / "sub" / "b.store"), std::string(2500, 'b'));
+  BOOST_CHECK_EQUAL(SegmentFile((storeDir / "objects" / "sub" / "b.store").string()).size(), 3);
+
+  auto manifestPath = storeDir / "manifest.store";
+  BOOST_CHECK_EQUAL(SegmentFile::readVersionedName(manifestPath.string()),
+                    Name(publisher.getManifestName()).append(version));
+  BOOST_CHECK_EQUAL(readObject(manifestPath),
+                    objects[0].versionedName.toUri() + " 0\n" +
+                    objects[1].versionedName.toUri() + " 100\n" +
+                    objects[2].versionedName.toUri() + " 2500\n");
+}
+
+BOOST_AUTO_TEST_CASE(StoreInsideInput)
+{
+  storeDir = inputDir / "store";
+  DirectoryPublisher publisher(prefix, m_keyChain, options, 1);
+  BOOST_CHECK_EQUAL(publisher.publish(inputDir.string(), storeDir.string()).size(), 3);
+
+  // the segment files of the first run are not published as input files
+  boost::filesystem::remove(inputDir / "c");
+  auto objects = publisher.publish(inputDir.string(), storeDir.string());
+  BOOST_CHECK_EQUAL(objects.size(), 2);
+  BOOST_CHECK(!boost::filesystem::exists(storeDir / "objects" / "c.store"));
+}
+
+BOOST_AUTO_TEST_CASE(ForeignFileInObjectsDir)
+{
+  auto foreignFile = storeDir / "objects" / "sub" / "notes.txt";
+  boost::filesystem::create_directories(foreignFile.parent_path());
+  std::ofstream(foreignFile.string()) << "keep me";
+
+  DirectoryPublisher publisher(prefix, m_keyChain, options);
+  BOOST_CHECK_THROW(publisher.publish(inputDir.string(), storeDir.string()), std::runtime_error);
+  BOOST_CHECK(boost::filesystem::exists(foreignFile));
+  BOOST_CHECK(!boost::filesystem::exists(storeDir / "manifest.store"));
+}
+
+BOOST_AUTO_TEST_CASE(NotADirectory)
+{
+  DirectoryPublisher publisher(prefix, m_keyChain, options);
+  BOOST_CHECK_THROW(publisher.publish((inputDir / "c").string(), storeDir.string()),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestDirectoryPublisher
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
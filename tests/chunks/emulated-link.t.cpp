@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tests/emulated-link.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-aimd.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-cubic.hpp"
+#include "tools/chunks/putchunks/producer.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/io-fixture.hpp"
+#include "tests/key-chain-fixture.hpp"
+
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class EmulatedLinkFixture : public IoFixture, public KeyChainFixture
+{
+protected:
+  EmulatedLinkFixture()
+    : rttEstimator(make_shared<RttEstimatorWithStats::Options>())
+  {
+    m_keyChain.createIdentity("/EmulatedLinkFixture");
+    producerOptions.maxSegmentSize = 1000;
+    producerOptions.isQuiet = true;
+    pipelineOptions.isQuiet = true;
+  }
+
+  /**
+   * @brief Fetch @p nBytes from a Producer across a link with the given parameters
+   * @return true if the transfer completed within one minute of virtual time
+   */
+  bool
+  transfer(PipelineInterests& pipeline, const EmulatedLink::Options& linkOptions, size_t nBytes)
+  {
+    std::istringstream is(std::string(nBytes, 'a'));
+    producer = make_unique<Producer>(versionedName, producerFace, m_keyChain, is, producerOptions);
+    link = make_unique<EmulatedLink>(consumerFace, producerFace, linkOptions);
+    advanceClocks(1_ms);
+
+    bool hasFailed = false;
+    pipeline.run(versionedName, [this] (const Data&) { nReceived++; },
+                 [&hasFailed] (const std::string&) { hasFailed = true; });
+
+    for (int i = 0; i < 60000 && !pipeline.isFinished() && !hasFailed; ++i) {
+      advanceClocks(1_ms);
+    }
+    return pipeline.isFinished() && !hasFailed;
+  }
+
+protected:
+  util::DummyClientFace consumerFace{m_io, {false, false}};
+  util::DummyClientFace producerFace{m_io, {false, true}};
+  Name versionedName = Name("/ndn/chunks/test").appendVersion(1);
+  Producer::Options producerOptions;
+  Options pipelineOptions;
+  RttEstimatorWithStats rttEstimator;
+  unique_ptr<Producer> producer;
+  unique_ptr<EmulatedLink> link;
+  size_t nReceived = 0;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestEmulatedLink, EmulatedLinkFixture)
+
+BOOST_AUTO_TEST_CASE(DropTail)
+{
+  EmulatedLink::Options linkOptions;
+  linkOptions.queueCapacity = 10;
+
+  PipelineInterestsAimd pipeline(consumerFace, rttEstimator, pipelineOptions);
+  BOOST_REQUIRE(transfer(pipeline, linkOptions, 200000));
+
+  const auto& down = link->getDownstreamCounters();
+  BOOST_CHECK_GT(down.nDropped, 0);
+  BOOST_CHECK_LE(down.maxQueueLength, 10);
+  BOOST_CHECK_EQUAL(down.nMarked, 0);
+  BOOST_CHECK_GT(pipeline.m_nTimeouts, 0);
+  BOOST_CHECK_EQUAL(nReceived, pipeline.m_lastSegmentNo + 1);
+}
+
+BOOST_AUTO_TEST_CASE(CoDel)
+{
+  EmulatedLink::Options linkOptions;
+  linkOptions.queueCapacity = 1000;
+  linkOptions.aqm = Aqm::CoDel;
+
+  PipelineInterestsCubic pipeline(consumerFace, rttEstimator, pipelineOptions);
+  BOOST_REQUIRE(transfer(pipeline, linkOptions, 1000000));
+
+  const auto& down = link->getDownstreamCounters();
+  BOOST_CHECK_EQUAL(down.nDropped, 0);
+  BOOST_CHECK_GT(down.nMarked, 0);
+  BOOST_CHECK_GT(pipeline.m_nCongMarks, 0);
+  BOOST_CHECK_GT(pipeline.m_nMarkDecr, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Red)
+{
+  EmulatedLink::Options linkOptions;
+  linkOptions.queueCapacity = 1000;
+  linkOptions.aqm = Aqm::Red;
+  linkOptions.redWeight = 0.2;
+
+  PipelineInterestsAimd pipeline(consumerFace, rttEstimator, pipelineOptions);
+  BOOST_REQUIRE(transfer(pipeline, linkOptions, 1000000));
+
+  const auto& down = link->getDownstreamCounters();
+  BOOST_CHECK_EQUAL(down.nDropped, 0);
+  BOOST_CHECK_GT(down.nMarked, 0);
+  BOOST_CHECK_GT(pipeline.m_nCongMarks, 0);
+}
+
+BOOST_AUTO_TEST_CASE(RandomLoss)
+{
+  EmulatedLink::Options linkOptions;
+  linkOptions.lossRate = 0.02;
+  linkOptions.seed = 42;
+
+  PipelineInterestsAimd pipeline(consumerFace, rttEstimator, pipelineOptions);
+  BOOST_REQUIRE(transfer(pipeline, linkOptions, 200000));
+
+  const auto& up = link->getUpstreamCounters();
+  const auto& down = link->getDownstreamCounters();
+  BOOST_CHECK_GT(up.nLost + down.nLost, 0);
+  // every lost Interest or Data must have been retransmitted
+  BOOST_CHECK_GE(static_cast<uint64_t>(pipeline.m_nRetransmitted), up.nLost + down.nLost);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestEmulatedLink
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
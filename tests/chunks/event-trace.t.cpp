@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/event-trace.hpp"
+#include "tools/chunks/catchunks/pipeline-interests-fixed.hpp"
+
+#include "pipeline-interests-fixture.hpp"
+
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+class EventTraceFixture : public PipelineInterestsFixture
+{
+public:
+  EventTraceFixture()
+  {
+    opt.isQuiet = true;
+    opt.maxPipelineSize = 2;
+    auto pline = make_unique<PipelineInterestsFixed>(face, opt);
+    pipeline = pline.get();
+    setPipeline(std::move(pline));
+  }
+
+  std::vector<TraceRecord>
+  readTrace()
+  {
+    std::vector<TraceRecord> records;
+    EventTraceReader reader(os);
+    TraceRecord rec;
+    while (reader.read(rec)) {
+      records.push_back(rec);
+    }
+    return records;
+  }
+
+protected:
+  Options opt;
+  PipelineInterestsFixed* pipeline;
+  std::stringstream os;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestEventTrace, EventTraceFixture)
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  {
+    EventTrace trace(*pipeline, os, 8);
+    trace.append({1_ns, 0, SegmentEventType::Sent});
+    trace.append({2_ms, 1234567, SegmentEventType::Retransmitted});
+    trace.append({3_s, 42, SegmentEventType::Nack});
+    BOOST_CHECK_EQUAL(trace.getNDropped(), 0);
+  }
+
+  auto records = readTrace();
+  BOOST_REQUIRE_EQUAL(records.size(), 3);
+  BOOST_CHECK_EQUAL(records[0].age, 1_ns);
+  BOOST_CHECK_EQUAL(records[0].segNo, 0);
+  BOOST_CHECK_EQUAL(records[0].type, SegmentEventType::Sent);
+  BOOST_CHECK_EQUAL(records[1].age, 2_ms);
+  BOOST_CHECK_EQUAL(records[1].segNo, 1234567);
+  BOOST_CHECK_EQUAL(records[1].type, SegmentEventType::Retransmitted);
+  BOOST_CHECK_EQUAL(records[2].age, 3_s);
+  BOOST_CHECK_EQUAL(records[2].segNo, 42);
+  BOOST_CHECK_EQUAL(records[2].type, SegmentEventType::Nack);
+}
+
+BOOST_AUTO_TEST_CASE(PipelineEvents)
+{
+  nDataSegments = 3;
+  {
+    EventTrace trace(*pipeline, os);
+    run(name);
+    advanceClocks(time::nanoseconds(1));
+    face.receive(*makeDataWithSegment(0));
+    advanceClocks(time::nanoseconds(1));
+  }
+
+  auto records = readTrace();
+  BOOST_REQUIRE_EQUAL(records.size(), 4);
+  BOOST_CHECK_EQUAL(records[0].type, SegmentEventType::Sent);
+  BOOST_CHECK_EQUAL(records[0].segNo, 0);
+  BOOST_CHECK_EQUAL(records[1].type, SegmentEventType::Sent);
+  BOOST_CHECK_EQUAL(records[1].segNo, 1);
+  BOOST_CHECK_EQUAL(records[2].type, SegmentEventType::Received);
+  BOOST_CHECK_EQUAL(records[2].segNo, 0);
+  BOOST_CHECK_EQUAL(records[3].type, SegmentEventType::Sent);
+  BOOST_CHECK_EQUAL(records[3].segNo, 2);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidHeader)
+{
+  os << "NOTATRACE-------";
+  BOOST_CHECK_THROW(EventTraceReader{os}, EventTraceReader::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestEventTrace
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
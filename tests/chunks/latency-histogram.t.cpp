@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/latency-histogram.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/test/tools/output_test_stream.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestLatencyHistogram)
+
+BOOST_AUTO_TEST_CASE(Buckets)
+{
+  using H = LatencyHistogram;
+
+  // small values have a bucket each
+  for (uint64_t v = 0; v < H::SUB_BUCKET_COUNT; ++v) {
+    BOOST_CHECK_EQUAL(H::getBucketIndex(v), v);
+  }
+
+  // buckets are contiguous and cover the whole range of uint64_t
+  uint64_t prevUpper = 0;
+  for (size_t i = 1; i < H::BUCKET_COUNT; ++i) {
+    uint64_t lower = H::getBucketLowerBound(i);
+    uint64_t upper = H::getBucketUpperBound(i);
+    BOOST_REQUIRE_EQUAL(lower, prevUpper + 1);
+    BOOST_REQUIRE_EQUAL(H::getBucketIndex(lower), i);
+    BOOST_REQUIRE_EQUAL(H::getBucketIndex(upper), i);
+    // bucket width stays within 1/SUB_BUCKET_COUNT of its lower bound
+    BOOST_REQUIRE_LE(upper - lower, lower / H::SUB_BUCKET_COUNT);
+    prevUpper = upper;
+  }
+  BOOST_CHECK_EQUAL(prevUpper, std::numeric_limits<uint64_t>::max());
+}
+
+BOOST_AUTO_TEST_CASE(Percentiles)
+{
+  LatencyHistogram h;
+  BOOST_CHECK_EQUAL(h.getCount(), 0);
+
+  for (int i = 1; i <= 1000; ++i) {
+    h.record(time::milliseconds(i));
+  }
+  h.record(-1_ms); // counted as zero
+
+  BOOST_CHECK_EQUAL(h.getCount(), 1001);
+  BOOST_CHECK_EQUAL(h.getMin(), 0_ns);
+  BOOST_CHECK_EQUAL(h.getMax(), 1000_ms);
+
+  auto checkPercentile = [&h] (double p, time::milliseconds expected) {
+    auto value = h.getPercentile(p);
+    BOOST_CHECK_GE(value, expected);
+    BOOST_CHECK_LE(value, expected + expected / LatencyHistogram::SUB_BUCKET_COUNT);
+  };
+  checkPercentile(50, 500_ms);
+  checkPercentile(90, 900_ms);
+  checkPercentile(99, 990_ms);
+  checkPercentile(99.9, 999_ms);
+  BOOST_CHECK_EQUAL(h.getPercentile(100), 1000_ms);
+  BOOST_CHECK_EQUAL(h.getPercentile(0), 0_ns);
+}
+
+BOOST_AUTO_TEST_CASE(Save)
+{
+  LatencyHistogram h;
+  h.record(3_ns);
+  h.record(3_ns);
+  h.record(100_ns);
+
+  boost::test_tools::output_test_stream os;
+  h.save(os, "rtt");
+  BOOST_CHECK(os.is_equal("rtt 3 3 2\n"
+                          "rtt 100 101 1\n"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestLatencyHistogram
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
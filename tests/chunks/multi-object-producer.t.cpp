@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/multi-object-producer.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/io-fixture.hpp"
+#include "tests/key-chain-fixture.hpp"
+
+#include <ndn-cxx/metadata-object.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class MultiObjectProducerFixture : public IoFixture, public KeyChainFixture
+{
+protected:
+  MultiObjectProducerFixture()
+  {
+    boost::filesystem::remove_all(dir);
+    writeObject("a.store", Name(prefix).append("a").appendVersion(1), 3);
+    writeObject("sub/dir/b.store", Name(prefix).append("sub").append("b").appendVersion(2), 2);
+    // not under the prefix
+    writeObject("other.store", Name("/other/c").appendVersion(3), 1);
+    // not a segment file
+    {
+      std::ofstream junk((dir / "junk.store").string());
+      junk << "junk";
+    }
+    // ignored extension
+    writeObject("d.bak", Name(prefix).append("d").appendVersion(4), 1);
+
+    options.isQuiet = true;
+    options.cacheSize = 2;
+  }
+
+  ~MultiObjectProducerFixture()
+  {
+    boost::filesystem::remove_all(dir);
+  }
+
+  void
+  writeObject(const std::string& relPath, const Name& versionedName, uint64_t nSegments)
+  {
+    std::vector<shared_ptr<Data>> segments;
+    for (uint64_t segNo = 0; segNo < nSegments; ++segNo) {
+      auto data = makeData(Name(versionedName).appendSegment(segNo));
+      data->setFinalBlock(name::Component::fromSegment(nSegments - 1));
+      segments.push_back(signData(data));
+    }
+    auto path = dir / relPath;
+    boost::filesystem::create_directories(path.parent_path());
+    SegmentFile::write(path.string(), versionedName, segments);
+  }
+
+protected:
+  boost::filesystem::path dir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "multi-object-producer";
+  Name prefix = "/ndn/chunks/objects";
+  util::DummyClientFace face{m_io, {true, true}};
+  Producer::Options options;
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestMultiObjectProducer, MultiObjectProducerFixture)
+
+BOOST_AUTO_TEST_CASE(Index)
+{
+  MultiObjectProducer producer(prefix, face, m_keyChain, dir.string(), options);
+  BOOST_CHECK_EQUAL(producer.getObjectCount(), 2);
+  BOOST_CHECK_EQUAL(producer.m_objects.count(Name(prefix).append("a")), 1);
+  BOOST_CHECK_EQUAL(producer.m_objects.count(Name(prefix).append("sub").append("b")), 1);
+
+  // segment files are not mapped until they are requested
+  for (const auto& entry : producer.m_objects) {
+    BOOST_CHECK(entry.second.file == nullptr);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Discovery)
+{
+  MultiObjectProducer producer(prefix, face, m_keyChain, dir.string(), options);
+  m_io.poll();
+
+  face.receive(MetadataObject::makeDiscoveryInterest(Name(prefix).append("sub").append("b")));
+  face.processEvents();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  MetadataObject mobject(face.sentData.back());
+  BOOST_CHECK_EQUAL(mobject.getVersionedName(), Name(prefix).append("sub").append("b").appendVersion(2));
+
+  // unknown object
+  face.receive(MetadataObject::makeDiscoveryInterest(Name(prefix).append("unknown")));
+  face.processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentNacks.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Segments)
+{
+  MultiObjectProducer producer(prefix, face, m_keyChain, dir.string(), options);
+  m_io.poll();
+
+  Name a = Name(prefix).append("a").appendVersion(1);
+  face.receive(*makeInterest(Name(a).appendSegment(2)));
+  face.receive(*makeInterest(Name(prefix).append("sub").append("b"), true));
+  face.processEvents();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), Name(a).appendSegment(2));
+  BOOST_CHECK_EQUAL(face.sentData[1].getName(),
+                    Name(prefix).append("sub").append("b").appendVersion(2).appendSegment(0));
+  BOOST_CHECK_EQUAL(producer.m_cache.size(), 2);
+
+  // segments are served from the cache, and the least recently used one is evicted
+  face.receive(*makeInterest(Name(a).appendSegment(2)));
+  face.receive(*makeInterest(Name(a).appendSegment(0)));
+  face.processEvents();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 4);
+  BOOST_CHECK_EQUAL(face.sentData[2].getName(), Name(a).appendSegment(2));
+  BOOST_CHECK_EQUAL(face.sentData[3].getName(), Name(a).appendSegment(0));
+  BOOST_CHECK_EQUAL(producer.m_cache.size(), 2);
+
+  // nonexistent segment, wrong version, object outside of the index
+  face.receive(*makeInterest(Name(a).appendSegment(3)));
+  face.receive(*makeInterest(Name(prefix).append("a").appendVersion(5).appendSegment(0)));
+  face.receive(*makeInterest(Name(prefix).append("d").appendVersion(4).appendSegment(0)));
+  face.processEvents();
+  BOOST_CHECK_EQUAL(face.sentData.size(), 4);
+  BOOST_CHECK_EQUAL(face.sentNacks.size(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestMultiObjectProducer
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
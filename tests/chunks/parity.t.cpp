@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/common/parity.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestParity)
+
+BOOST_AUTO_TEST_CASE(ParityName)
+{
+  Name name = makeParityName(Name("/A").appendVersion(1), 3);
+  BOOST_CHECK_EQUAL(name.getPrefix(2), Name("/A").appendVersion(1));
+  BOOST_CHECK_EQUAL(name[2], PARITY_COMPONENT);
+  BOOST_CHECK_EQUAL(name[2].toUri(), "32=parity");
+  BOOST_CHECK_EQUAL(name[3].toSegment(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Recover)
+{
+  std::vector<shared_ptr<Data>> segments;
+  for (size_t i = 0; i < 4; ++i) {
+    auto data = makeData(Name("/A").appendVersion(1).appendSegment(i));
+    std::string payload(10 + 20 * i, 'a' + i); // segments of different lengths
+    data->setContent(reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+    segments.push_back(signData(data));
+  }
+
+  std::vector<Block> wires;
+  for (const auto& data : segments) {
+    wires.push_back(data->wireEncode());
+  }
+  auto payload = computeParity(wires);
+  BOOST_CHECK_EQUAL(payload.size(), wires.back().size());
+  Block parity = makeBinaryBlock(tlv::Content, payload.data(), payload.size());
+
+  for (size_t missing = 0; missing < wires.size(); ++missing) {
+    std::vector<Block> others(wires);
+    others.erase(others.begin() + missing);
+    auto rebuilt = recoverSegment(parity, others);
+    BOOST_REQUIRE(rebuilt != nullptr);
+    BOOST_CHECK_EQUAL(*rebuilt, *segments[missing]);
+  }
+
+  // with two segments missing, the result is not a Data packet
+  std::vector<Block> tooFew(wires.begin(), wires.begin() + 2);
+  BOOST_CHECK(recoverSegment(parity, tooFew) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestParity
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -26,6 +26,7 @@
  */
 
 #include "tools/chunks/catchunks/pipeline-interests-aimd.hpp"
+#include "tools/chunks/common/parity.hpp"
 
 #include "pipeline-interests-fixture.hpp"
 
@@ -593,6 +594,45 @@ BOOST_AUTO_TEST_CASE(StopsWhenFileSizeLessThanChunkSize)
 }
 
 
+BOOST_AUTO_TEST_CASE(ParityRecovery)
+{
+  nDataSegments = 4;
+  opt.fecBlockSize = 4;
+  pipeline->m_ssthresh = 8.0;
+
+  run(name);
+  advanceClocks(time::nanoseconds(1));
+  // segments 0 and 1, and the parity of block 0 outside of the window
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), 3);
+  BOOST_CHECK_EQUAL(face.sentInterests[1].getName(), makeParityName(Name(name).appendVersion(0), 0));
+
+  for (uint64_t i = 0; i < 3; ++i) {
+    face.receive(*makeDataWithSegment(i));
+    advanceClocks(time::nanoseconds(1));
+  }
+  BOOST_CHECK_EQUAL(pipeline->m_nReceived, 3);
+  BOOST_CHECK_EQUAL(pipeline->m_fecBlocks.count(0), 1);
+
+  std::vector<Block> segments;
+  for (uint64_t i = 0; i < nDataSegments; ++i) {
+    segments.push_back(makeDataWithSegment(i)->wireEncode());
+  }
+  auto payload = computeParity(segments);
+  auto parity = makeData(makeParityName(Name(name).appendVersion(0), 0));
+  parity->setContent(payload.data(), payload.size());
+  face.receive(signData(*parity));
+  advanceClocks(time::nanoseconds(1));
+
+  // segment 3 is rebuilt without waiting for it or retransmitting it
+  BOOST_CHECK_EQUAL(pipeline->m_nParityReceived, 1);
+  BOOST_CHECK_EQUAL(pipeline->m_nRecovered, 1);
+  BOOST_CHECK_EQUAL(pipeline->m_nReceived, 4);
+  BOOST_CHECK_EQUAL(pipeline->m_nRetransmitted, 0);
+  BOOST_CHECK(pipeline->m_segmentInfo.empty());
+  BOOST_CHECK(pipeline->m_fecBlocks.empty());
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestPipelineInterestsAimd
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
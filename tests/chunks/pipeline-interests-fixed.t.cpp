@@ -295,6 +295,38 @@ BOOST_AUTO_TEST_CASE(CongestionAllSegments)
   BOOST_CHECK_EQUAL(hasFailed, true);
 }
 
+BOOST_AUTO_TEST_CASE(CongestionBackoffPerSlot)
+{
+  nDataSegments = 13;
+  BOOST_ASSERT(nDataSegments > opt.maxPipelineSize);
+
+  run(name);
+  advanceClocks(time::nanoseconds(1));
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize);
+
+  // first congestion Nack for segment #0 is retried after 1 ms
+  face.receive(makeNack(face.sentInterests[0], lp::NackReason::CONGESTION));
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize + 1);
+  BOOST_CHECK_EQUAL(getSegmentFromPacket(face.sentInterests.back()), 0);
+
+  // second congestion Nack for the same segment doubles the backoff time
+  face.receive(makeNack(face.sentInterests.back(), lp::NackReason::CONGESTION));
+  advanceClocks(1_ms);
+  BOOST_CHECK_EQUAL(face.sentInterests.size(), opt.maxPipelineSize + 1);
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(face.sentInterests.size(), opt.maxPipelineSize + 2);
+  BOOST_CHECK_EQUAL(getSegmentFromPacket(face.sentInterests.back()), 0);
+
+  // the slot is reused for the next segment and its backoff starts over
+  face.receive(*makeDataWithSegment(0));
+  advanceClocks(time::nanoseconds(1));
+  BOOST_CHECK_EQUAL(pipeline->m_nReceived, 1);
+  BOOST_CHECK_EQUAL(pipeline->m_slots[0].segNo, opt.maxPipelineSize);
+  BOOST_CHECK_EQUAL(pipeline->m_slots[0].nCongestionRetries, 0);
+  BOOST_CHECK_EQUAL(hasFailed, false);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestPipelineInterests
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
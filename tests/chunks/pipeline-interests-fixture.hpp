@@ -45,6 +45,14 @@ using namespace ndn::tests;
 class PipelineInterestsFixture : public IoFixture
 {
 protected:
+  PipelineInterestsFixture() = default;
+
+  explicit
+  PipelineInterestsFixture(const util::DummyClientFace::Options& faceOptions)
+    : face(m_io, faceOptions)
+  {
+  }
+
   void
   setPipeline(unique_ptr<PipelineInterests> pline)
   {
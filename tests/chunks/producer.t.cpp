@@ -24,6 +24,7 @@
  */
 
 #include "tools/chunks/putchunks/producer.hpp"
+#include "tools/chunks/common/parity.hpp"
 
 #include "tests/test-common.hpp"
 #include "tests/io-fixture.hpp"
@@ -32,9 +33,13 @@
 #include <ndn-cxx/metadata-object.hpp>
 #include <ndn-cxx/security/pib/identity.hpp>
 #include <ndn-cxx/security/pib/key.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <boost/filesystem.hpp>
+
 #include <cmath>
+#include <fstream>
 #include <sstream>
 
 namespace ndn {
@@ -97,6 +102,20 @@ BOOST_AUTO_TEST_CASE(InputData)
   }
 }
 
+BOOST_AUTO_TEST_CASE(FirstSegmentSigningInfo)
+{
+  auto identity = m_keyChain.createIdentity("/ProducerFixture/other");
+  options.signingInfo = security::signingByIdentity(identity);
+  Producer producer(prefix, face, m_keyChain, testString, options);
+
+  // the first segment is signed as configured, not with the default identity
+  BOOST_REQUIRE(!producer.m_store.empty());
+  const Data& first = *producer.m_store.front();
+  BOOST_REQUIRE(first.getKeyLocator());
+  BOOST_CHECK_EQUAL(first.getKeyLocator()->getName(), identity.getDefaultKey().getName());
+  BOOST_CHECK_NE(first.getKeyLocator()->getName(), keyLocatorName);
+}
+
 BOOST_AUTO_TEST_CASE(RequestSegmentUnspecifiedVersion)
 {
   Producer producer(prefix, face, m_keyChain, testString, options);
@@ -219,6 +238,159 @@ BOOST_AUTO_TEST_CASE(RequestMetadata)
   BOOST_CHECK_EQUAL(face.sentNacks.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(StoreDir)
+{
+  auto storeDir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "producer-store";
+  boost::filesystem::remove_all(storeDir);
+  options.storeDir = storeDir.string();
+  size_t nSegments = std::ceil(static_cast<double>(testString.str().size()) / options.maxSegmentSize);
+
+  std::vector<Data> published;
+  {
+    Producer producer(prefix, face, m_keyChain, testString, options);
+    BOOST_CHECK(!producer.isServingSegmentFile());
+    BOOST_REQUIRE_EQUAL(producer.m_store.size(), nSegments);
+    for (const auto& data : producer.m_store) {
+      published.push_back(*data);
+    }
+  }
+  BOOST_CHECK(boost::filesystem::exists(storeDir / Producer::STORE_FILE_NAME));
+
+  // restart: the input stream is ignored, nothing is re-signed
+  util::DummyClientFace face2(m_io, {true, true});
+  std::istringstream emptyInput;
+  Producer producer(prefix, face2, m_keyChain, emptyInput, options);
+  BOOST_REQUIRE(producer.isServingSegmentFile());
+  BOOST_CHECK(producer.m_store.empty());
+  m_io.poll();
+
+  face2.receive(*makeInterest(prefix, true));
+  face2.receive(*makeInterest(published.at(2).getName()));
+  face2.processEvents();
+
+  BOOST_REQUIRE_EQUAL(face2.sentData.size(), 2);
+  BOOST_CHECK_EQUAL(face2.sentData[0], published.at(0));
+  BOOST_CHECK_EQUAL(face2.sentData[1], published.at(2));
+
+  // the stored version cannot be published under another prefix or version
+  std::istringstream input2("a");
+  BOOST_CHECK_THROW(Producer("/other/prefix", face2, m_keyChain, input2, options),
+                    SegmentFile::Error);
+  BOOST_CHECK_THROW(Producer(Name(prefix).appendVersion(version), face2, m_keyChain, input2, options),
+                    SegmentFile::Error);
+
+  boost::filesystem::remove_all(storeDir);
+}
+
+BOOST_AUTO_TEST_CASE(CorruptSegment)
+{
+  auto storeDir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "producer-store";
+  boost::filesystem::remove_all(storeDir);
+  options.storeDir = storeDir.string();
+  const std::string path = (storeDir / Producer::STORE_FILE_NAME).string();
+
+  Name segmentName;
+  {
+    Producer producer(prefix, face, m_keyChain, testString, options);
+    BOOST_REQUIRE_GE(producer.m_store.size(), 3U);
+    segmentName = producer.m_store.at(1)->getName();
+
+    // change the TLV-TYPE of segment 1, so that it is no longer a Data packet
+    std::ifstream is(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    const Block& wire = producer.m_store.at(1)->wireEncode();
+    auto pos = contents.find(std::string(reinterpret_cast<const char*>(wire.wire()), wire.size()));
+    BOOST_REQUIRE(pos != std::string::npos);
+    contents[pos] = static_cast<char>(tlv::Name);
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os << contents;
+  }
+
+  util::DummyClientFace face2(m_io, {true, true});
+  std::istringstream emptyInput;
+  Producer producer(prefix, face2, m_keyChain, emptyInput, options);
+  BOOST_REQUIRE(producer.isServingSegmentFile());
+  m_io.poll();
+
+  // the corrupt segment is answered with a Nack, and the producer keeps serving
+  face2.receive(*makeInterest(segmentName));
+  face2.receive(*makeInterest(segmentName.getPrefix(-1).appendSegment(2)));
+  face2.processEvents();
+
+  BOOST_CHECK_EQUAL(face2.sentNacks.size(), 1);
+  BOOST_REQUIRE_EQUAL(face2.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face2.sentData[0].getName().at(-1).toSegment(), 2);
+
+  boost::filesystem::remove_all(storeDir);
+}
+
+BOOST_AUTO_TEST_CASE(Parity)
+{
+  options.fecBlockSize = 4;
+  Producer producer(Name(prefix).appendVersion(version), face, m_keyChain, testString, options);
+  m_io.poll();
+  const size_t nSegments = producer.m_store.size();
+  const size_t nBlocks = (nSegments + 3) / 4;
+  BOOST_REQUIRE_GT(nSegments, 5);
+
+  Name versionedName = Name(prefix).appendVersion(version);
+  face.receive(*makeInterest(makeParityName(versionedName, 1)));
+  face.receive(*makeInterest(makeParityName(versionedName, nBlocks)));
+  face.processEvents();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentNacks.size(), 1);
+  const Data& parity = face.sentData.back();
+  BOOST_CHECK_EQUAL(parity.getName(), makeParityName(versionedName, 1));
+  BOOST_CHECK_EQUAL(parity.getFinalBlock().value().toSegment(), nBlocks - 1);
+
+  // segment 5 can be rebuilt from the parity and the rest of block 1
+  std::vector<Block> others;
+  for (size_t segNo : {4, 6, 7}) {
+    others.push_back(producer.m_store.at(segNo)->wireEncode());
+  }
+  auto rebuilt = recoverSegment(parity.getContent(), others);
+  BOOST_REQUIRE(rebuilt != nullptr);
+  BOOST_CHECK_EQUAL(*rebuilt, *producer.m_store.at(5));
+}
+
+BOOST_AUTO_TEST_CASE(Aggregation)
+{
+  options.aggregationWindow = 100_ms;
+  Producer producer(Name(prefix).appendVersion(version), face, m_keyChain, testString, options);
+  m_io.poll();
+
+  Name segmentName = Name(prefix).appendVersion(version).appendSegment(1);
+  face.receive(*makeInterest(segmentName));
+  face.receive(*makeInterest(segmentName));
+  face.receive(*makeInterest(Name(prefix).appendVersion(version).appendSegment(2)));
+  face.receive(*makeInterest(segmentName));
+  advanceClocks(10_ms);
+
+  // every Interest is answered; the duplicates for segment 1 get the Data already sent
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 4);
+  BOOST_CHECK_EQUAL(face.sentNacks.size(), 0);
+  BOOST_CHECK_EQUAL(face.sentData[0].getName(), segmentName);
+  BOOST_CHECK_EQUAL(face.sentData[1].getName(), segmentName);
+  BOOST_CHECK_EQUAL(face.sentData[2].getName().at(-1).toSegment(), 2);
+  BOOST_CHECK_EQUAL(face.sentData[3].getName(), segmentName);
+  BOOST_CHECK_EQUAL(face.sentData[1].wireEncode(), face.sentData[0].wireEncode());
+  BOOST_CHECK_EQUAL(face.sentData[3].wireEncode(), face.sentData[0].wireEncode());
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().getNResponses(), 2);
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().getNAggregated(), 2);
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().size(), 2);
+
+  // once the window has elapsed, segment 1 is looked up again
+  advanceClocks(10_ms, 10);
+  face.receive(*makeInterest(segmentName));
+  advanceClocks(10_ms);
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 5);
+  BOOST_CHECK_EQUAL(face.sentData.back().getName(), segmentName);
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().getNResponses(), 3);
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().getNAggregated(), 2);
+  BOOST_CHECK_EQUAL(producer.getPendingResponses().size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestProducer
 BOOST_AUTO_TEST_SUITE_END() // Chunks
 
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/progress-reporter.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/io-fixture.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class PipelineInterestsProgressDummy : public PipelineInterests
+{
+public:
+  using PipelineInterests::PipelineInterests;
+
+  void
+  receive(size_t size, bool isLast)
+  {
+    m_nReceived++;
+    m_receivedSize += size;
+    if (isLast) {
+      m_hasFinalBlockId = true;
+      m_lastSegmentNo = m_nReceived - 1;
+    }
+  }
+
+  void
+  deliver(const Data& data, bool isLast)
+  {
+    if (isLast) {
+      m_hasFinalBlockId = true;
+      m_lastSegmentNo = data.getName()[-1].toSegment();
+    }
+    onData(data);
+  }
+
+private:
+  void
+  doRun() final
+  {
+  }
+
+  void
+  doCancel() final
+  {
+  }
+};
+
+class ProgressReporterFixture : public IoFixture
+{
+public:
+  ProgressReporterFixture()
+  {
+    boost::filesystem::create_directories(dir);
+  }
+
+  ~ProgressReporterFixture()
+  {
+    boost::filesystem::remove_all(dir);
+  }
+
+  std::string
+  readMetric(const std::string& metric) const
+  {
+    std::ifstream is(path);
+    std::string key, value;
+    while (is >> key >> value) {
+      if (key == metric)
+        return value;
+    }
+    return "";
+  }
+
+protected:
+  util::DummyClientFace face{m_io};
+  Options options;
+  Consumer consumer{security::getAcceptAllValidator()};
+  boost::filesystem::path dir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "progress-reporter";
+  std::string path = (dir / "stats").string();
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestProgressReporter, ProgressReporterFixture)
+
+BOOST_AUTO_TEST_CASE(PeriodicReport)
+{
+  auto pipeline = make_unique<PipelineInterestsProgressDummy>(face, options);
+  auto pipelinePtr = pipeline.get();
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1);
+
+  ProgressReporter reporter(face, consumer, path, 100_ms);
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_reorder_buffer_segments"), "0");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_segments_received"), "");
+
+  consumer.run(make_unique<DiscoverVersion>(face, prefix, options), std::move(pipeline));
+  pipelinePtr->receive(1000, false);
+  consumer.m_bufferedData[1] = makeData(Name(prefix).appendSegment(1));
+
+  // not updated until the next interval
+  advanceClocks(50_ms);
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_segments_received"), "");
+
+  advanceClocks(50_ms);
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_segments_received"), "1");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_bytes_received"), "1000");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_reorder_buffer_segments"), "1");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_finished"), "0");
+  BOOST_CHECK(!boost::filesystem::exists(path + ".tmp"));
+
+  // the final snapshot is written once the transfer is finished, then reporting stops
+  pipelinePtr->receive(1000, true);
+  advanceClocks(100_ms);
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_segments_received"), "2");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_finished"), "1");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_last_segment"), "1");
+
+  boost::filesystem::remove(path);
+  advanceClocks(100_ms, 3);
+  BOOST_CHECK(!boost::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(FinalReportOnCompletion)
+{
+  std::ostringstream output;
+  Consumer consumer(security::getAcceptAllValidator(), output);
+  auto pipeline = make_unique<PipelineInterestsProgressDummy>(face, options);
+  auto pipelinePtr = pipeline.get();
+  Name prefix = Name("/ndn/chunks/test").appendVersion(1);
+
+  ProgressReporter reporter(face, consumer, path, 10_s);
+  consumer.run(make_unique<DiscoverVersion>(face, prefix, options), std::move(pipeline));
+
+  for (uint64_t segNo = 0; segNo < 2; ++segNo) {
+    auto data = makeData(Name(prefix).appendSegment(segNo));
+    Block content(tlv::Content);
+    content.push_back(makeStringBlock(tlv::Content, "segment"));
+    content.push_back(Block(tlv::SignatureValue));
+    data->setContent(content);
+    pipelinePtr->deliver(*data, segNo == 1);
+  }
+
+  // the final snapshot is written as soon as the last segment is received, without waiting
+  // for the next interval, and no report is pending afterwards
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_finished"), "1");
+  BOOST_CHECK_EQUAL(readMetric("ndncatchunks_segments_written"), "2");
+  BOOST_CHECK_EQUAL(output.str(), "segmentsegment");
+
+  boost::filesystem::remove(path);
+  advanceClocks(1_s, 20);
+  BOOST_CHECK(!boost::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(Unwritable)
+{
+  BOOST_CHECK_THROW(ProgressReporter(face, consumer, (dir / "nonexistent" / "stats").string(), 1_s),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestProgressReporter
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/segment-cache.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestSegmentCache)
+
+BOOST_AUTO_TEST_CASE(Lru)
+{
+  SegmentCache cache(2);
+  auto d1 = makeData("/A/1");
+  auto d2 = makeData("/A/2");
+  auto d3 = makeData("/A/3");
+
+  cache.insert(d1);
+  cache.insert(d2);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find("/A/1") == d1); // /A/2 becomes the least recently used
+
+  cache.insert(d3);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find("/A/2") == nullptr);
+  BOOST_CHECK(cache.find("/A/1") == d1);
+  BOOST_CHECK(cache.find("/A/3") == d3);
+
+  // re-inserting an existing segment does not evict anything
+  cache.insert(d1);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.find("/A/3") == d3);
+}
+
+BOOST_AUTO_TEST_CASE(ZeroCapacity)
+{
+  SegmentCache cache(0);
+  cache.insert(makeData("/A/1"));
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK(cache.find("/A/1") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ByteCapacity)
+{
+  auto d1 = makeData("/A/1");
+  auto d2 = makeData("/A/2");
+  auto d3 = makeData("/A/3");
+  const size_t nBytes = d1->wireEncode().size();
+
+  SegmentCache cache(10, nBytes * 2);
+  cache.insert(d1);
+  cache.insert(d2);
+  BOOST_CHECK_EQUAL(cache.getBytes(), nBytes * 2);
+
+  cache.insert(d3);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK_EQUAL(cache.getBytes(), nBytes * 2);
+  BOOST_CHECK_EQUAL(cache.getNEvictions(), 1);
+  BOOST_CHECK(cache.find("/A/1") == nullptr);
+
+  // a segment larger than the byte capacity is not kept
+  SegmentCache small(10, nBytes - 1);
+  small.insert(d1);
+  BOOST_CHECK_EQUAL(small.size(), 0);
+  BOOST_CHECK_EQUAL(small.getBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(HitsAndMisses)
+{
+  SegmentCache cache(10);
+  size_t nLoads = 0;
+  auto load = [&] (uint64_t segNo) -> shared_ptr<const Data> {
+    ++nLoads;
+    return segNo < 4 ? makeData(Name("/A/v").appendSegment(segNo)) : nullptr;
+  };
+
+  BOOST_CHECK(cache.get("/A/v", 2, load) != nullptr);
+  BOOST_CHECK(cache.get("/A/v", 2, load) != nullptr);
+  BOOST_CHECK(cache.get("/A/v", 7, load) == nullptr);
+  BOOST_CHECK_EQUAL(nLoads, 2);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 2);
+  BOOST_CHECK_EQUAL(cache.getNPrefetched(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Prefetch)
+{
+  SegmentCache cache(10, 0, 2);
+  std::vector<uint64_t> loaded;
+  auto load = [&] (uint64_t segNo) -> shared_ptr<const Data> {
+    loaded.push_back(segNo);
+    return segNo < 4 ? makeData(Name("/A/v").appendSegment(segNo)) : nullptr;
+  };
+
+  // a random access does not prefetch
+  BOOST_CHECK(cache.get("/A/v", 2, load) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNPrefetched(), 0);
+
+  // a sequential miss loads the next segments, skipping those already cached, up to the end
+  BOOST_CHECK(cache.get("/A/v", 0, load) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNPrefetched(), 1);
+  BOOST_CHECK(cache.get("/A/v", 1, load) != nullptr);
+  BOOST_CHECK(cache.get("/A/v", 3, load) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 3);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNPrefetched(), 1);
+  BOOST_CHECK_EQUAL(cache.size(), 4);
+
+  std::vector<uint64_t> expected{2, 0, 1, 3, 4};
+  BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(PrefetchLimits)
+{
+  auto load = [] (uint64_t segNo) -> shared_ptr<const Data> {
+    return makeData(Name("/A/v").appendSegment(segNo));
+  };
+  const size_t nBytes = load(0)->wireEncode().size();
+
+  // the prefetch count is clamped to the capacity, so the requested segment is not evicted
+  SegmentCache cache(3, 0, 10);
+  BOOST_CHECK(cache.get("/A/v", 0, load) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNPrefetched(), 2);
+  BOOST_CHECK_EQUAL(cache.getNEvictions(), 0);
+  BOOST_CHECK(cache.find(Name("/A/v").appendSegment(0)) != nullptr);
+
+  // prefetching stops before the byte capacity is exceeded
+  SegmentCache small(10, nBytes * 2, 5);
+  BOOST_CHECK(small.get("/A/v", 0, load) != nullptr);
+  BOOST_CHECK_EQUAL(small.getNPrefetched(), 1);
+  BOOST_CHECK_EQUAL(small.getNEvictions(), 0);
+  BOOST_CHECK(small.find(Name("/A/v").appendSegment(0)) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmentCache
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/common/segment-codec.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_AUTO_TEST_SUITE(TestSegmentCodec)
+
+BOOST_AUTO_TEST_CASE(Parse)
+{
+  BOOST_CHECK(parseCodec("none") == Codec::None);
+  BOOST_CHECK(parseCodec("zstd") == Codec::Zstd);
+  BOOST_CHECK(parseCodec("lz4") == Codec::Lz4);
+  BOOST_CHECK_THROW(parseCodec("gzip"), std::invalid_argument);
+  BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(Codec::Lz4), "lz4");
+  BOOST_CHECK(isCodecAvailable(Codec::None));
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  const std::string text = std::string(2000, 'a') + "{\"key\": \"value\"}" + std::string(2000, 'b');
+  const auto* buf = reinterpret_cast<const uint8_t*>(text.data());
+
+  for (auto codec : {Codec::None, Codec::Zstd, Codec::Lz4}) {
+    BOOST_TEST_CONTEXT("codec " << codec) {
+      uint32_t contentType = 0;
+      auto payload = encodePayload(codec, buf, text.size(), contentType);
+      if (codec == Codec::None || !isCodecAvailable(codec)) {
+        // raw fallback
+        BOOST_CHECK_EQUAL(contentType, tlv::ContentType_Blob);
+        BOOST_CHECK_EQUAL(payload.size(), text.size());
+      }
+      else {
+        BOOST_CHECK(isCompressed(contentType));
+        BOOST_CHECK_LT(payload.size(), text.size() / 10);
+      }
+
+      std::vector<uint8_t> decoded;
+      decodePayload(contentType, payload.data(), payload.size(), decoded);
+      BOOST_CHECK_EQUAL(std::string(decoded.begin(), decoded.end()), text);
+
+      Data data("/A/B");
+      data.setContentType(contentType);
+      Block content(tlv::Content);
+      content.push_back(makeBinaryBlock(tlv::Content, payload.data(), payload.size()));
+      data.setContent(content);
+      if (isCompressed(contentType)) {
+        BOOST_CHECK_EQUAL(getDecodedSize(data), text.size());
+      }
+      else {
+        BOOST_CHECK_EQUAL(getDecodedSize(data), data.getContent().value_size());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Incompressible)
+{
+  const std::vector<uint8_t> input{0x8f, 0x12, 0xa0, 0x3c, 0x77};
+  for (auto codec : {Codec::Zstd, Codec::Lz4}) {
+    uint32_t contentType = 0;
+    auto payload = encodePayload(codec, input.data(), input.size(), contentType);
+    BOOST_CHECK_EQUAL(contentType, tlv::ContentType_Blob);
+    BOOST_CHECK(payload == input);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  std::vector<uint8_t> out;
+  const std::vector<uint8_t> truncated{0x00, 0x01};
+  BOOST_CHECK_THROW(decodePayload(ContentType_Zstd, truncated.data(), truncated.size(), out),
+                    CodecError);
+
+  const std::vector<uint8_t> tooLarge{0xff, 0xff, 0xff, 0xff, 0x00};
+  BOOST_CHECK_THROW(decodePayload(ContentType_Lz4, tooLarge.data(), tooLarge.size(), out),
+                    CodecError);
+
+  const std::vector<uint8_t> garbage{0x00, 0x00, 0x00, 0x10, 0xde, 0xad, 0xbe, 0xef};
+  BOOST_CHECK_THROW(decodePayload(ContentType_Zstd, garbage.data(), garbage.size(), out),
+                    CodecError);
+  BOOST_CHECK_THROW(decodePayload(ContentType_Lz4, garbage.data(), garbage.size(), out),
+                    CodecError);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmentCodec
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
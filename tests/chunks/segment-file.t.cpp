@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/putchunks/segment-file.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+namespace tests {
+
+using namespace ndn::tests;
+
+class SegmentFileFixture
+{
+protected:
+  SegmentFileFixture()
+  {
+    boost::filesystem::create_directories(dir);
+  }
+
+  ~SegmentFileFixture()
+  {
+    boost::filesystem::remove_all(dir);
+  }
+
+  std::string
+  readFile() const
+  {
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), {});
+  }
+
+  void
+  writeFile(const std::string& contents) const
+  {
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    os << contents;
+  }
+
+protected:
+  boost::filesystem::path dir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "segment-file";
+  std::string path = (dir / "segments.store").string();
+  Name versionedName = Name("/ndn/chunks/test").appendVersion(42);
+};
+
+BOOST_AUTO_TEST_SUITE(Chunks)
+BOOST_FIXTURE_TEST_SUITE(TestSegmentFile, SegmentFileFixture)
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  std::vector<shared_ptr<Data>> segments;
+  for (uint64_t segNo = 0; segNo < 5; ++segNo) {
+    auto data = makeData(Name(versionedName).appendSegment(segNo));
+    data->setContent(reinterpret_cast<const uint8_t*>("segment"), 7 + segNo % 2);
+    segments.push_back(signData(data));
+  }
+  SegmentFile::write(path, versionedName, segments);
+  BOOST_CHECK(!boost::filesystem::exists(path + ".tmp"));
+
+  SegmentFile file(path);
+  BOOST_CHECK_EQUAL(file.getVersionedName(), versionedName);
+  BOOST_REQUIRE_EQUAL(file.size(), segments.size());
+  for (size_t segNo = 0; segNo < segments.size(); ++segNo) {
+    BOOST_CHECK_EQUAL(Data(file.getSegment(segNo)), *segments[segNo]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Empty)
+{
+  BOOST_CHECK_THROW(SegmentFile::write(path, versionedName, {}), SegmentFile::Error);
+  BOOST_CHECK(!boost::filesystem::exists(path));
+  BOOST_CHECK(!boost::filesystem::exists(path + ".tmp"));
+}
+
+BOOST_AUTO_TEST_CASE(Invalid)
+{
+  BOOST_CHECK_THROW(SegmentFile((dir / "nonexistent").string()), SegmentFile::Error);
+
+  writeFile("");
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  SegmentFile::write(path, versionedName, {makeData(Name(versionedName).appendSegment(0))});
+  const std::string valid = readFile();
+
+  // bad magic
+  std::string contents = valid;
+  contents[0] = 'X';
+  writeFile(contents);
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  // unsupported format version
+  contents = valid;
+  contents[8] = 2;
+  writeFile(contents);
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  // huge number of segments
+  contents = valid;
+  contents[23] = '\x7f';
+  writeFile(contents);
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  // truncated segment
+  writeFile(valid.substr(0, valid.size() - 1));
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  // no segments, with a consistent offset table
+  const size_t offsetsBegin = 24 + versionedName.wireEncode().size();
+  contents = valid.substr(0, offsetsBegin);
+  contents[16] = 0;
+  contents += std::string(8, '\0');
+  contents[offsetsBegin] = static_cast<char>(offsetsBegin + 8);
+  writeFile(contents);
+  BOOST_CHECK_THROW(SegmentFile{path}, SegmentFile::Error);
+
+  writeFile(valid);
+  BOOST_CHECK_NO_THROW(SegmentFile{path});
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSegmentFile
+BOOST_AUTO_TEST_SUITE_END() // Chunks
+
+} // namespace tests
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/capture-file.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <array>
+#include <fstream>
+#include <iterator>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+struct Record
+{
+  time_t sec;
+  suseconds_t usec;
+  uint32_t caplen;
+  uint32_t len;
+  uint8_t firstByte;
+};
+
+class CaptureFileFixture
+{
+protected:
+  CaptureFileFixture()
+  {
+    boost::filesystem::create_directories(dir);
+  }
+
+  ~CaptureFileFixture()
+  {
+    boost::filesystem::remove_all(dir);
+  }
+
+  void
+  writeFile(const std::vector<uint8_t>& bytes)
+  {
+    std::ofstream os(path, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  }
+
+  static std::vector<uint8_t>
+  readFile(const std::string& filename)
+  {
+    std::ifstream is(filename, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+
+  /**
+   * @brief read the records of all chunks, checking that chunks are not empty
+   */
+  static std::vector<Record>
+  readRecords(const CaptureFile& file)
+  {
+    std::vector<Record> records;
+    for (const auto& chunk : file.getChunks()) {
+      size_t nBefore = records.size();
+      file.forEachRecord(chunk, [&] (const pcap_pkthdr& header, const uint8_t* payload) {
+        records.push_back({header.ts.tv_sec, header.ts.tv_usec, header.caplen, header.len, payload[0]});
+      });
+      BOOST_CHECK_GT(records.size(), nBefore);
+    }
+    return records;
+  }
+
+  template<size_t N>
+  std::array<uint8_t, N>
+  encode(uint64_t value) const
+  {
+    std::array<uint8_t, N> bytes;
+    for (size_t i = 0; i < N; ++i) {
+      size_t shift = isBigEndian ? 8 * (N - 1 - i) : 8 * i;
+      bytes[i] = static_cast<uint8_t>(value >> shift);
+    }
+    return bytes;
+  }
+
+  void
+  put16(uint16_t value)
+  {
+    auto bytes = encode<2>(value);
+    pcapng.insert(pcapng.end(), bytes.begin(), bytes.end());
+  }
+
+  void
+  put32(uint32_t value)
+  {
+    auto bytes = encode<4>(value);
+    pcapng.insert(pcapng.end(), bytes.begin(), bytes.end());
+  }
+
+  /**
+   * @brief append a pcapng block; @p writeBody appends the body, whose size must be a multiple of 4
+   */
+  template<typename F>
+  void
+  appendBlock(uint32_t type, const F& writeBody)
+  {
+    size_t begin = pcapng.size();
+    put32(type);
+    put32(0);
+    writeBody();
+    auto length = static_cast<uint32_t>(pcapng.size() - begin + 4);
+    put32(length);
+
+    auto bytes = encode<4>(length);
+    std::copy(bytes.begin(), bytes.end(), pcapng.begin() + begin + 4);
+  }
+
+  void
+  appendSection(bool bigEndian)
+  {
+    isBigEndian = bigEndian;
+    appendBlock(0x0A0D0D0A, [this] {
+      put32(0x1A2B3C4D);
+      put16(1);
+      put16(0);
+      put32(0xFFFFFFFF); // section length unknown
+      put32(0xFFFFFFFF);
+    });
+  }
+
+  void
+  appendInterface(uint16_t linkType, optional<uint8_t> tsresol = nullopt)
+  {
+    appendBlock(1, [=] {
+      put16(linkType);
+      put16(0);
+      put32(65535);
+      if (tsresol) {
+        put16(9);
+        put16(1);
+        pcapng.insert(pcapng.end(), {*tsresol, 0, 0, 0});
+      }
+      put16(0);
+      put16(0);
+    });
+  }
+
+  void
+  appendEnhancedPacket(uint32_t interfaceId, uint64_t timestamp, uint8_t firstByte, uint32_t size)
+  {
+    appendBlock(6, [=] {
+      put32(interfaceId);
+      put32(static_cast<uint32_t>(timestamp >> 32));
+      put32(static_cast<uint32_t>(timestamp));
+      put32(size);
+      put32(size);
+      pcapng.push_back(firstByte);
+      pcapng.resize(pcapng.size() + (size + 3) / 4 * 4 - 1, 0);
+    });
+  }
+
+  void
+  appendSimplePacket(uint8_t firstByte, uint32_t size)
+  {
+    appendBlock(3, [=] {
+      put32(size);
+      pcapng.push_back(firstByte);
+      pcapng.resize(pcapng.size() + (size + 3) / 4 * 4 - 1, 0);
+    });
+  }
+
+protected:
+  boost::filesystem::path dir = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "capture-file";
+  std::string path = (dir / "capture").string();
+  std::vector<uint8_t> pcapng;
+  bool isBigEndian = false;
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestCaptureFile, CaptureFileFixture)
+
+BOOST_AUTO_TEST_CASE(Pcap)
+{
+  CaptureFile file("tests/dump/nack.pcap", 1 << 20);
+  BOOST_CHECK_EQUAL(file.getLinkType(), DLT_EN10MB);
+  BOOST_CHECK_EQUAL(file.getChunks().size(), 1);
+  BOOST_CHECK_EQUAL(file.isTruncated(), false);
+
+  auto records = readRecords(file);
+  BOOST_REQUIRE_EQUAL(records.size(), 2);
+  BOOST_CHECK_EQUAL(records[0].sec, 1571091605);
+  BOOST_CHECK_EQUAL(records[0].usec, 129263);
+  BOOST_CHECK_EQUAL(records[0].caplen, 102);
+  BOOST_CHECK_EQUAL(records[0].len, 102);
+  BOOST_CHECK_EQUAL(records[1].sec, 1571091605);
+  BOOST_CHECK_EQUAL(records[1].usec, 129702);
+  BOOST_CHECK_EQUAL(records[1].caplen, 115);
+}
+
+BOOST_AUTO_TEST_CASE(PcapChunks)
+{
+  // every record is larger than the chunk size
+  CaptureFile file("tests/dump/linux-sll-tcp6.pcap", 1);
+  BOOST_CHECK_EQUAL(file.getLinkType(), DLT_LINUX_SLL);
+  BOOST_CHECK_EQUAL(file.getChunks().size(), 11);
+
+  CaptureFile whole("tests/dump/linux-sll-tcp6.pcap", 1 << 20);
+  BOOST_CHECK_EQUAL(whole.getChunks().size(), 1);
+
+  auto records = readRecords(file);
+  auto wholeRecords = readRecords(whole);
+  BOOST_REQUIRE_EQUAL(records.size(), wholeRecords.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    BOOST_CHECK_EQUAL(records[i].usec, wholeRecords[i].usec);
+    BOOST_CHECK_EQUAL(records[i].caplen, wholeRecords[i].caplen);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PcapTruncated)
+{
+  auto bytes = readFile("tests/dump/nack.pcap");
+  bytes.resize(bytes.size() - 10);
+  writeFile(bytes);
+
+  CaptureFile file(path, 1 << 20);
+  BOOST_CHECK_EQUAL(file.isTruncated(), true);
+  BOOST_CHECK_EQUAL(readRecords(file).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Pcapng)
+{
+  appendSection(false);
+  appendInterface(DLT_EN10MB, 9); // nanoseconds
+  appendEnhancedPacket(0, 1571091605129263123, 0x11, 60);
+  appendSimplePacket(0x22, 61);
+  appendBlock(5, [this] { put32(0); }); // Interface Statistics Block, skipped
+  appendEnhancedPacket(1, 0, 0x33, 62); // undefined interface, skipped
+
+  // the next section uses the other byte order, and the default resolution of microseconds
+  appendSection(true);
+  appendInterface(DLT_EN10MB);
+  appendInterface(DLT_EN10MB, 0x80 | 10); // 1/1024 s
+  appendEnhancedPacket(1, 1571091605ull * 1024 + 512, 0x44, 63);
+  appendEnhancedPacket(0, 1571091605129702, 0x55, 64);
+  writeFile(pcapng);
+
+  CaptureFile file(path, 1 << 20);
+  BOOST_CHECK_EQUAL(file.getLinkType(), DLT_EN10MB);
+  BOOST_CHECK_EQUAL(file.isTruncated(), false);
+  // a chunk does not span several sections
+  BOOST_REQUIRE_EQUAL(file.getChunks().size(), 2);
+  BOOST_CHECK_EQUAL(file.getChunks()[0].section, 0);
+  BOOST_CHECK_EQUAL(file.getChunks()[1].section, 1);
+
+  auto records = readRecords(file);
+  BOOST_REQUIRE_EQUAL(records.size(), 4);
+  BOOST_CHECK_EQUAL(records[0].sec, 1571091605);
+  BOOST_CHECK_EQUAL(records[0].usec, 129263);
+  BOOST_CHECK_EQUAL(records[0].caplen, 60);
+  BOOST_CHECK_EQUAL(records[0].firstByte, 0x11);
+  BOOST_CHECK_EQUAL(records[1].sec, 0);
+  BOOST_CHECK_EQUAL(records[1].caplen, 61);
+  BOOST_CHECK_EQUAL(records[1].len, 61);
+  BOOST_CHECK_EQUAL(records[1].firstByte, 0x22);
+  BOOST_CHECK_EQUAL(records[2].sec, 1571091605);
+  BOOST_CHECK_EQUAL(records[2].usec, 500000);
+  BOOST_CHECK_EQUAL(records[2].firstByte, 0x44);
+  BOOST_CHECK_EQUAL(records[3].sec, 1571091605);
+  BOOST_CHECK_EQUAL(records[3].usec, 129702);
+  BOOST_CHECK_EQUAL(records[3].caplen, 64);
+  BOOST_CHECK_EQUAL(records[3].firstByte, 0x55);
+}
+
+BOOST_AUTO_TEST_CASE(PcapngChunks)
+{
+  appendSection(false);
+  appendInterface(DLT_LINUX_SLL);
+  for (uint8_t i = 0; i < 10; ++i) {
+    appendEnhancedPacket(0, i, i, 100);
+  }
+  // the last block is cut short
+  pcapng.resize(pcapng.size() - 4);
+  writeFile(pcapng);
+
+  CaptureFile file(path, 250);
+  BOOST_CHECK_EQUAL(file.getLinkType(), DLT_LINUX_SLL);
+  BOOST_CHECK_EQUAL(file.isTruncated(), true);
+  BOOST_CHECK_GT(file.getChunks().size(), 1);
+
+  auto records = readRecords(file);
+  BOOST_REQUIRE_EQUAL(records.size(), 9);
+  for (uint8_t i = 0; i < 9; ++i) {
+    BOOST_CHECK_EQUAL(records[i].firstByte, i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PcapngMixedLinkTypes)
+{
+  appendSection(false);
+  appendInterface(DLT_EN10MB);
+  appendInterface(DLT_LINUX_SLL);
+  writeFile(pcapng);
+
+  BOOST_CHECK_THROW(CaptureFile(path, 1 << 20), CaptureFile::Error);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownFormat)
+{
+  writeFile(std::vector<uint8_t>(64, 0xEE));
+  BOOST_CHECK_THROW(CaptureFile(path, 1 << 20), CaptureFile::Error);
+  BOOST_CHECK_THROW(CaptureFile((dir / "nonexistent").string(), 1 << 20), CaptureFile::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestCaptureFile
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/exchange-tracker.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <algorithm>
+
+#include <boost/test/tools/output_test_stream.hpp>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+class ExchangeTrackerFixture
+{
+protected:
+  ExchangeTrackerFixture()
+  {
+    consumerToProducer.family = FlowKey::Family::IPV4;
+    consumerToProducer.protocol = IPPROTO_UDP;
+    consumerToProducer.srcPort = 40000;
+    consumerToProducer.dstPort = 6363;
+    inet_pton(AF_INET, "192.0.2.1", consumerToProducer.srcAddr.data());
+    inet_pton(AF_INET, "192.0.2.2", consumerToProducer.dstAddr.data());
+    producerToConsumer = consumerToProducer.reverse();
+  }
+
+  void
+  addInterest(ExchangeTracker& tracker, const timeval& ts, const Name& name,
+              bool canBePrefix = false, time::milliseconds lifetime = 4_s)
+  {
+    const Block& wire = name.wireEncode();
+    tracker.addInterest(ts, consumerToProducer, wire.value(), wire.value_size(), canBePrefix, lifetime);
+  }
+
+  optional<time::microseconds>
+  addData(ExchangeTracker& tracker, const timeval& ts, const Name& name)
+  {
+    const Block& wire = name.wireEncode();
+    return tracker.addData(ts, producerToConsumer, wire.value(), wire.value_size());
+  }
+
+  optional<time::microseconds>
+  addNack(ExchangeTracker& tracker, const timeval& ts, const Name& name)
+  {
+    const Block& wire = name.wireEncode();
+    return tracker.addNack(ts, producerToConsumer, wire.value(), wire.value_size());
+  }
+
+protected:
+  FlowKey consumerToProducer;
+  FlowKey producerToConsumer;
+  ExchangeTracker::Options options;
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestExchangeTracker, ExchangeTrackerFixture)
+
+BOOST_AUTO_TEST_CASE(Satisfied)
+{
+  ExchangeTracker tracker(options);
+
+  addInterest(tracker, {1, 0}, "/a/b/c/1");
+  BOOST_CHECK_EQUAL(tracker.size(), 1);
+
+  // a Data on the same direction as the Interest does not match
+  const Block& wire = Name("/a/b/c/1").wireEncode();
+  BOOST_CHECK(!tracker.addData({1, 1000}, consumerToProducer, wire.value(), wire.value_size()));
+  BOOST_CHECK_EQUAL(tracker.getNUnsolicited(), 1);
+
+  auto rtt = addData(tracker, {1, 2500}, "/a/b/c/1");
+  BOOST_REQUIRE(rtt);
+  BOOST_CHECK_EQUAL(rtt->count(), 2500);
+  BOOST_CHECK_EQUAL(tracker.size(), 0);
+
+  // the Interest has been satisfied already
+  BOOST_CHECK(!addData(tracker, {1, 3000}, "/a/b/c/1"));
+  BOOST_CHECK_EQUAL(tracker.getNUnsolicited(), 2);
+
+  auto stats = tracker.getPrefixStatistics("/a/b/c/2");
+  BOOST_REQUIRE(stats != nullptr);
+  BOOST_CHECK_EQUAL(stats->nInterests, 1);
+  BOOST_CHECK_EQUAL(stats->nSatisfied, 1);
+  BOOST_CHECK_EQUAL(stats->minRtt.count(), 2500);
+  BOOST_CHECK_EQUAL(stats->maxRtt.count(), 2500);
+  BOOST_CHECK_EQUAL(stats->rttHistogram[2], 1); // [2,4) ms
+  BOOST_CHECK(tracker.getPrefixStatistics("/x") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(CanBePrefix)
+{
+  ExchangeTracker tracker(options);
+
+  addInterest(tracker, {1, 0}, "/a", false);
+  addInterest(tracker, {1, 0}, "/b", true);
+  BOOST_CHECK(!addData(tracker, {1, 1000}, "/a/v1"));
+  BOOST_CHECK(addData(tracker, {1, 1000}, "/b/v1"));
+  BOOST_CHECK_EQUAL(tracker.size(), 1);
+
+  // a Nack must carry the same name as the Interest
+  BOOST_CHECK(!addNack(tracker, {1, 2000}, "/a/v1"));
+  BOOST_CHECK(addNack(tracker, {1, 2000}, "/a"));
+  BOOST_CHECK_EQUAL(tracker.getPrefixStatistics("/a")->nNacked, 1);
+  BOOST_CHECK_EQUAL(tracker.getPrefixStatistics("/b")->nSatisfied, 1);
+}
+
+BOOST_AUTO_TEST_CASE(Retransmission)
+{
+  ExchangeTracker tracker(options);
+
+  addInterest(tracker, {1, 0}, "/a");
+  addInterest(tracker, {2, 0}, "/a");
+  BOOST_CHECK_EQUAL(tracker.size(), 1);
+
+  // the RTT is measured from the last transmission
+  auto rtt = addData(tracker, {2, 10000}, "/a");
+  BOOST_REQUIRE(rtt);
+  BOOST_CHECK_EQUAL(rtt->count(), 10000);
+  BOOST_CHECK_EQUAL(tracker.getPrefixStatistics("/a")->nInterests, 1);
+}
+
+BOOST_AUTO_TEST_CASE(Timeout)
+{
+  options.depth = 1;
+  ExchangeTracker tracker(options);
+
+  addInterest(tracker, {1, 0}, "/a/1", false, 100_ms);
+  addInterest(tracker, {1, 0}, "/a/2", false, 1_s);
+
+  // the first Interest expires, in capture time, before the Data arrives
+  BOOST_CHECK(!addData(tracker, {1, 200000}, "/a/1"));
+  BOOST_CHECK(addData(tracker, {1, 200000}, "/a/2"));
+  BOOST_CHECK_EQUAL(tracker.size(), 0);
+
+  auto stats = tracker.getPrefixStatistics("/a");
+  BOOST_REQUIRE(stats != nullptr);
+  BOOST_CHECK_EQUAL(stats->nInterests, 2);
+  BOOST_CHECK_EQUAL(stats->nTimedOut, 1);
+  BOOST_CHECK_EQUAL(stats->nSatisfied, 1);
+  BOOST_CHECK_EQUAL(tracker.getNEvicted(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Capacity)
+{
+  options.capacity = 2;
+  options.depth = 1;
+  ExchangeTracker tracker(options);
+
+  addInterest(tracker, {1, 0}, "/a", false, 1_s);
+  addInterest(tracker, {1, 0}, "/b", false, 500_ms);
+  addInterest(tracker, {1, 0}, "/c", false, 2_s);
+
+  // the Interest closest to expiry is evicted, and /c is counted under (other)
+  BOOST_CHECK_EQUAL(tracker.size(), 2);
+  BOOST_CHECK_EQUAL(tracker.getNEvicted(), 1);
+  BOOST_CHECK(!addData(tracker, {1, 1000}, "/b"));
+  BOOST_CHECK(addData(tracker, {1, 1000}, "/a"));
+  BOOST_CHECK(addData(tracker, {1, 1000}, "/c"));
+  BOOST_CHECK(tracker.getPrefixStatistics("/c") == nullptr);
+
+  boost::test_tools::output_test_stream output;
+  tracker.printSummary(output);
+  BOOST_CHECK(output.is_equal(
+    "--- Interest-Data exchanges: 0 pending, 1 evicted, 1 unsolicited Data or Nacks\n"
+    "  /a: 1 Interests, 1 satisfied, 0 nacked, 0 timed out, satisfaction 100%, "
+    "RTT min/avg/max 1.000/1.000/1.000 ms\n"
+    "    <2ms:1\n"
+    "  /b: 1 Interests, 0 satisfied, 0 nacked, 0 timed out\n"
+    "  (other): 1 Interests, 1 satisfied, 0 nacked, 0 timed out, satisfaction 100%, "
+    "RTT min/avg/max 1.000/1.000/1.000 ms\n"
+    "    <2ms:1\n"));
+}
+
+BOOST_AUTO_TEST_CASE(Multicast)
+{
+  ExchangeTracker tracker(options);
+  const Block& wire = Name("/a/b/c/1").wireEncode();
+
+  // Ethernet multicast face: A > 01:00:5e:00:17:aa, answered by B > 01:00:5e:00:17:aa
+  FlowKey interestFlow;
+  interestFlow.family = FlowKey::Family::ETHERNET;
+  const uint8_t a[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0a};
+  const uint8_t b[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0b};
+  const uint8_t group[] = {0x01, 0x00, 0x5e, 0x00, 0x17, 0xaa};
+  std::copy(std::begin(a), std::end(a), interestFlow.srcAddr.begin());
+  std::copy(std::begin(group), std::end(group), interestFlow.dstAddr.begin());
+  BOOST_CHECK(interestFlow.hasGroupDestination());
+  FlowKey dataFlow = interestFlow;
+  std::copy(std::begin(b), std::end(b), dataFlow.srcAddr.begin());
+
+  tracker.addInterest({1, 0}, interestFlow, wire.value(), wire.value_size(), false, 4_s);
+  auto rtt = tracker.addData({1, 1500}, dataFlow, wire.value(), wire.value_size());
+  BOOST_REQUIRE(rtt);
+  BOOST_CHECK_EQUAL(rtt->count(), 1500);
+
+  // LINUX_SLL: the destination address is not captured
+  interestFlow.dstAddr.fill(0);
+  dataFlow.dstAddr.fill(0);
+  BOOST_CHECK(interestFlow.hasGroupDestination());
+  tracker.addInterest({2, 0}, interestFlow, wire.value(), wire.value_size(), false, 4_s);
+  BOOST_CHECK(tracker.addNack({2, 500}, dataFlow, wire.value(), wire.value_size()));
+
+  // UDP multicast face: 192.0.2.1:56363 > 224.0.23.170:56363, answered by 192.0.2.2:56363
+  interestFlow = consumerToProducer;
+  interestFlow.srcPort = interestFlow.dstPort = 56363;
+  inet_pton(AF_INET, "224.0.23.170", interestFlow.dstAddr.data());
+  BOOST_CHECK(interestFlow.hasGroupDestination());
+  dataFlow = interestFlow;
+  inet_pton(AF_INET, "192.0.2.2", dataFlow.srcAddr.data());
+  tracker.addInterest({3, 0}, interestFlow, wire.value(), wire.value_size(), false, 4_s);
+  BOOST_CHECK(tracker.addData({3, 2000}, dataFlow, wire.value(), wire.value_size()));
+
+  // the same Data sent to another group does not match
+  tracker.addInterest({4, 0}, interestFlow, wire.value(), wire.value_size(), false, 4_s);
+  inet_pton(AF_INET, "224.0.23.171", dataFlow.dstAddr.data());
+  BOOST_CHECK(!tracker.addData({4, 2000}, dataFlow, wire.value(), wire.value_size()));
+  BOOST_CHECK_EQUAL(tracker.size(), 1);
+
+  BOOST_CHECK(!consumerToProducer.hasGroupDestination());
+  auto stats = tracker.getPrefixStatistics("/a/b/c");
+  BOOST_REQUIRE(stats != nullptr);
+  BOOST_CHECK_EQUAL(stats->nSatisfied, 2);
+  BOOST_CHECK_EQUAL(stats->nNacked, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestExchangeTracker
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
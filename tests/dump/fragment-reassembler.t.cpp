@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/fragment-reassembler.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/lp/packet.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+class FragmentReassemblerFixture
+{
+protected:
+  FragmentReassemblerFixture()
+  {
+    flow.family = FlowKey::Family::IPV4;
+    flow.protocol = IPPROTO_UDP;
+    flow.srcPort = 6363;
+    flow.dstPort = 6363;
+    inet_pton(AF_INET, "192.0.2.1", flow.srcAddr.data());
+    inet_pton(AF_INET, "192.0.2.2", flow.dstAddr.data());
+  }
+
+  /**
+   * @brief encode fragment @p index of @p packet cut into @p count pieces of equal size
+   */
+  static Block
+  makeFragment(const Block& packet, uint64_t sequence, size_t index, size_t count)
+  {
+    lp::Packet fragment;
+    auto begin = packet.begin() + index * packet.size() / count;
+    auto end = packet.begin() + (index + 1) * packet.size() / count;
+    fragment.add<lp::FragmentField>(std::make_pair(begin, end));
+    fragment.add<lp::FragIndexField>(index);
+    fragment.add<lp::FragCountField>(count);
+    fragment.add<lp::SequenceField>(sequence + index);
+    return fragment.wireEncode();
+  }
+
+  const Buffer*
+  add(FragmentReassembler& reassembler, const timeval& ts, const Block& fragment)
+  {
+    return reassembler.add(ts, flow, fragment.wire(), fragment.size());
+  }
+
+protected:
+  FlowKey flow;
+  FragmentReassembler::Options options;
+  Block packet = makeData("/a/b")->wireEncode();
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestFragmentReassembler, FragmentReassemblerFixture)
+
+BOOST_AUTO_TEST_CASE(Reassemble)
+{
+  FragmentReassembler reassembler(options);
+
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 2, 3)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 3)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.size(), 1);
+
+  // a duplicate fragment is ignored
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 3)) == nullptr);
+
+  // a fragment from another face belongs to another packet
+  flow.srcPort = 6364;
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 1, 3)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.size(), 2);
+  flow.srcPort = 6363;
+
+  const Buffer* reassembled = add(reassembler, {1, 0}, makeFragment(packet, 100, 1, 3));
+  BOOST_REQUIRE(reassembled != nullptr);
+  BOOST_CHECK_EQUAL_COLLECTIONS(reassembled->begin(), reassembled->end(), packet.begin(), packet.end());
+  BOOST_CHECK_EQUAL(reassembler.size(), 1);
+  BOOST_CHECK_EQUAL(reassembler.getNReassembled(), 1);
+  BOOST_CHECK_EQUAL(reassembler.getNInvalid(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(KeepHeaderFields)
+{
+  FragmentReassembler reassembler(options);
+
+  auto interest = makeInterest("/a", false, DEFAULT_INTEREST_LIFETIME, 1);
+  lp::Packet first(makeFragment(interest->wireEncode(), 0, 0, 2));
+  first.add<lp::NackField>(makeNack(*interest, lp::NackReason::CONGESTION).getHeader());
+  BOOST_CHECK(add(reassembler, {1, 0}, first.wireEncode()) == nullptr);
+
+  const Buffer* reassembled = add(reassembler, {1, 0}, makeFragment(interest->wireEncode(), 0, 1, 2));
+  BOOST_REQUIRE(reassembled != nullptr);
+  lp::Packet lpPacket(Block(reassembled->data(), reassembled->size()));
+  BOOST_CHECK(!lpPacket.has<lp::FragCountField>());
+  BOOST_CHECK(!lpPacket.has<lp::SequenceField>());
+  BOOST_REQUIRE(lpPacket.has<lp::NackField>());
+  BOOST_CHECK_EQUAL(lpPacket.get<lp::NackField>().getReason(), lp::NackReason::CONGESTION);
+  auto fragment = lpPacket.get<lp::FragmentField>();
+  BOOST_CHECK(Block(&*fragment.first, std::distance(fragment.first, fragment.second)) ==
+              interest->wireEncode());
+}
+
+BOOST_AUTO_TEST_CASE(Timeout)
+{
+  options.timeout = 100_ms;
+  FragmentReassembler reassembler(options);
+
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 2)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 200000}, makeFragment(packet, 100, 1, 2)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNTimedOut(), 1);
+  BOOST_CHECK_EQUAL(reassembler.size(), 1);
+  BOOST_CHECK_EQUAL(reassembler.getNReassembled(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Capacity)
+{
+  options.capacity = 2;
+  FragmentReassembler reassembler(options);
+
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 2)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 1}, makeFragment(packet, 200, 0, 2)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 2}, makeFragment(packet, 300, 0, 2)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.size(), 2);
+  BOOST_CHECK_EQUAL(reassembler.getNEvicted(), 1);
+
+  // the oldest partial packet was dropped
+  BOOST_CHECK(add(reassembler, {1, 3}, makeFragment(packet, 200, 1, 2)) != nullptr);
+  BOOST_CHECK(add(reassembler, {1, 4}, makeFragment(packet, 300, 1, 2)) != nullptr);
+  BOOST_CHECK(add(reassembler, {1, 5}, makeFragment(packet, 100, 1, 2)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(MaxBytes)
+{
+  options.maxBytes = packet.size();
+  FragmentReassembler reassembler(options);
+
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 2)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 200, 0, 2)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNEvicted(), 0);
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 300, 0, 2)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNEvicted(), 1);
+  BOOST_CHECK_LE(reassembler.getNBytes(), options.maxBytes);
+}
+
+BOOST_AUTO_TEST_CASE(Invalid)
+{
+  options.maxFragCount = 4;
+  FragmentReassembler reassembler(options);
+
+  // FragCount differs from the other fragments of the packet
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 0, 2)) == nullptr);
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 100, 1, 3)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNInvalid(), 1);
+
+  // FragCount is too large
+  BOOST_CHECK(add(reassembler, {1, 0}, makeFragment(packet, 200, 0, 5)) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNInvalid(), 2);
+
+  // Sequence is missing
+  lp::Packet noSequence(makeFragment(packet, 300, 0, 2));
+  noSequence.remove<lp::SequenceField>();
+  BOOST_CHECK(add(reassembler, {1, 0}, noSequence.wireEncode()) == nullptr);
+  BOOST_CHECK_EQUAL(reassembler.getNInvalid(), 3);
+  BOOST_CHECK_EQUAL(reassembler.size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestFragmentReassembler
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
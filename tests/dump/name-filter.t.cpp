@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/name-filter.hpp"
+
+#include "tests/test-common.hpp"
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_AUTO_TEST_SUITE(TestNameFilter)
+
+static bool
+matchWire(const NameFilter& filter, const Name& name)
+{
+  const Block& wire = name.wireEncode();
+  return filter.match(wire.value(), wire.value_size());
+}
+
+static bool
+match(const std::string& pattern, const Name& name)
+{
+  NameFilter filter(pattern);
+  bool isMatch = filter.match(name);
+  BOOST_CHECK_EQUAL(matchWire(filter, name), isMatch);
+  return isMatch;
+}
+
+BOOST_AUTO_TEST_CASE(Parse)
+{
+  BOOST_CHECK_EQUAL(NameFilter("/").size(), 0);
+  BOOST_CHECK_EQUAL(NameFilter("ndn:/a/b").size(), 2);
+  BOOST_CHECK_EQUAL(NameFilter("/a//*/").size(), 2);
+
+  BOOST_CHECK_THROW(NameFilter(""), NameFilter::Error);
+  BOOST_CHECK_THROW(NameFilter("a/b"), NameFilter::Error);
+  BOOST_CHECK_THROW(NameFilter("/a/seg=x"), NameFilter::Error);
+}
+
+BOOST_AUTO_TEST_CASE(IsRegex)
+{
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/"), false);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/ndn/example.com/ping"), false);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/ndn/*/ping/*"), false);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("ndn:/a/seg=0"), false);
+
+  BOOST_CHECK_EQUAL(NameFilter::isRegex(".*ping.*"), true);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/ndn/ping*"), true);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("*/ping"), true);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("^/ndn/"), true);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/ndn/(a|b)"), true);
+  BOOST_CHECK_EQUAL(NameFilter::isRegex("/ndn/[0-9]+"), true);
+}
+
+BOOST_AUTO_TEST_CASE(Prefix)
+{
+  BOOST_CHECK_EQUAL(match("/", "/"), true);
+  BOOST_CHECK_EQUAL(match("/", "/a/b"), true);
+  BOOST_CHECK_EQUAL(match("/a", "/a"), true);
+  BOOST_CHECK_EQUAL(match("/a", "/a/b"), true);
+  BOOST_CHECK_EQUAL(match("/a/b", "/a"), false);
+  BOOST_CHECK_EQUAL(match("/a/b", "/a/c"), false);
+  BOOST_CHECK_EQUAL(match("/a/b", "/ab"), false);
+  BOOST_CHECK_EQUAL(match("/a%20b", "/a%20b/c"), true);
+}
+
+BOOST_AUTO_TEST_CASE(Wildcard)
+{
+  BOOST_CHECK_EQUAL(match("/a/*/c", "/a/b/c"), true);
+  BOOST_CHECK_EQUAL(match("/a/*/c", "/a/x/c/d"), true);
+  BOOST_CHECK_EQUAL(match("/a/*/c", "/a/b"), false);
+  BOOST_CHECK_EQUAL(match("/a/*/c", "/a/b/d"), false);
+  BOOST_CHECK_EQUAL(match("/*", "/"), false);
+  BOOST_CHECK_EQUAL(match("/*", "/z"), true);
+  BOOST_CHECK_EQUAL(match("/a/%2A", "/a/b"), false);
+  BOOST_CHECK_EQUAL(match("/a/%2A", "/a/%2A"), true);
+}
+
+BOOST_AUTO_TEST_CASE(TypedComponents)
+{
+  Name name = Name("/a").appendVersion(3).appendSegment(0);
+  BOOST_CHECK_EQUAL(match("/a/v=3", name), true);
+  BOOST_CHECK_EQUAL(match("/a/*/seg=0", name), true);
+  BOOST_CHECK_EQUAL(match("/a/v=4", name), false);
+  // same TLV-VALUE, different TLV-TYPE
+  BOOST_CHECK_EQUAL(match("/a/seg=3", name), false);
+  BOOST_CHECK_EQUAL(match("/a/%03", name), false);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidWire)
+{
+  NameFilter filter("/a/b");
+  const uint8_t truncated[] = {0x08, 0x01, 0x61, 0x08, 0x05, 0x62};
+  BOOST_CHECK_EQUAL(filter.match(truncated, sizeof(truncated)), false);
+  // components beyond the pattern are not read
+  BOOST_CHECK_EQUAL(filter.match(truncated, 3), false);
+  BOOST_CHECK_EQUAL(NameFilter("/a").match(truncated, sizeof(truncated)), true);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestNameFilter
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
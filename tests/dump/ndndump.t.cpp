@@ -22,6 +22,9 @@
 
 #include "tests/test-common.hpp"
 
+#include <cstring>
+#include <limits>
+
 #include <net/ethernet.h>
 #include <netinet/ip.h>
 #include <netinet/ip6.h>
@@ -191,6 +194,39 @@ BOOST_AUTO_TEST_CASE(Data)
   BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test\n"));
 }
 
+BOOST_AUTO_TEST_CASE(TypedNameComponents)
+{
+  auto data = makeData(Name("/test").appendVersion(7).appendSegment(3));
+  this->receive(*data);
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test/v=7/seg=3\n"));
+
+  // packets that the fast path does not handle are still printed by the ndn-cxx decoder
+  data = makeData(Name("/test").appendSequenceNumber(9));
+  this->receive(*data);
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test/seq=9\n"));
+}
+
+BOOST_AUTO_TEST_CASE(FilterByName)
+{
+  dump.nameFilter.emplace("/test/*/seg=3");
+  this->receive(*makeData(Name("/test").appendVersion(7).appendSegment(3)));
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test/v=7/seg=3\n"));
+  this->receive(*makeData(Name("/test").appendVersion(7).appendSegment(4)));
+  BOOST_CHECK(output.is_equal(""));
+  // slow path
+  this->receive(*makeData(Name("/test").appendSequenceNumber(9).appendSegment(3)));
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test/seq=9/seg=3\n"));
+  this->receive(*makeInterest("/test", false, DEFAULT_INTEREST_LIFETIME, 1));
+  BOOST_CHECK(output.is_equal(""));
+
+  dump.nameFilter = nullopt;
+  dump.nameRegex = std::regex("/test/v=7/.*");
+  this->receive(*makeData(Name("/test").appendVersion(7).appendSegment(4)));
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, DATA: /test/v=7/seg=4\n"));
+  this->receive(*makeData(Name("/test").appendVersion(8)));
+  BOOST_CHECK(output.is_equal(""));
+}
+
 BOOST_AUTO_TEST_CASE(Nack)
 {
   auto interest = makeInterest("/test", false, DEFAULT_INTEREST_LIFETIME, 1);
@@ -220,6 +256,54 @@ BOOST_AUTO_TEST_CASE(LpFragment)
   BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDNLPv2 fragment\n"));
 }
 
+BOOST_AUTO_TEST_CASE(LpFragmentReassembly)
+{
+  dump.m_reassembler = make_unique<FragmentReassembler>(dump.reassemblyOptions);
+
+  auto interest = makeInterest("/test", false, DEFAULT_INTEREST_LIFETIME, 1);
+  auto nack = makeNack(*interest, lp::NackReason::DUPLICATE);
+  const Block& wire = interest->wireEncode();
+  size_t half = wire.size() / 2;
+
+  // the fragments arrive out of order, and the Nack header is on the first one
+  lp::Packet second;
+  second.add<lp::FragmentField>(std::make_pair(wire.begin() + half, wire.end()));
+  second.add<lp::FragIndexField>(1);
+  second.add<lp::FragCountField>(2);
+  second.add<lp::SequenceField>(1001);
+  this->receive(second);
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDNLPv2 fragment 2/2\n"));
+
+  lp::Packet first;
+  first.add<lp::FragmentField>(std::make_pair(wire.begin(), wire.begin() + half));
+  first.add<lp::FragIndexField>(0);
+  first.add<lp::FragCountField>(2);
+  first.add<lp::SequenceField>(1000);
+  first.add<lp::NackField>(nack.getHeader());
+  this->receive(first);
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDNLPv2 fragment 1/2, reassembled, "
+                              "NDNLPv2, NACK (Duplicate): /test?Nonce=00000001\n"));
+  BOOST_CHECK_EQUAL(dump.m_reassembler->getNReassembled(), 1);
+  BOOST_CHECK_EQUAL(dump.m_reassembler->size(), 0);
+
+  // without other header fields, the reassembled packet is the bare network packet
+  auto data = makeData("/test");
+  const Block& dataWire = data->wireEncode();
+  for (size_t i = 0; i < 3; ++i) {
+    lp::Packet fragment;
+    auto begin = dataWire.begin() + i * dataWire.size() / 3;
+    auto end = dataWire.begin() + (i + 1) * dataWire.size() / 3;
+    fragment.add<lp::FragmentField>(std::make_pair(begin, end));
+    fragment.add<lp::FragIndexField>(i);
+    fragment.add<lp::FragCountField>(3);
+    fragment.add<lp::SequenceField>(2000 + i);
+    this->receive(fragment);
+  }
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDNLPv2 fragment 1/3\n"
+                              "0.000000 Ethernet, NDNLPv2 fragment 2/3\n"
+                              "0.000000 Ethernet, NDNLPv2 fragment 3/3, reassembled, DATA: /test\n"));
+}
+
 BOOST_AUTO_TEST_CASE(LpIdle)
 {
   lp::Packet lpPacket;
@@ -244,6 +328,25 @@ BOOST_AUTO_TEST_CASE(IncompleteNdnPacket)
   BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDN truncated packet, length 4\n"));
 }
 
+BOOST_AUTO_TEST_CASE(TruncatedCapture)
+{
+  EncodingBuffer buffer(makeInterest("/test", false, DEFAULT_INTEREST_LIFETIME, 1)->wireEncode());
+  ethernet::Address host;
+  buffer.prependByteArray(reinterpret_cast<const uint8_t*>(&s_ethertypeNdn), ethernet::TYPE_LEN);
+  buffer.prependByteArray(host.data(), host.size());
+  buffer.prependByteArray(host.data(), host.size());
+
+  // only the captured bytes are decoded, however long the original packet was
+  pcap_pkthdr pkthdr{};
+  pkthdr.caplen = ethernet::HDR_LEN + 4;
+  pkthdr.len = std::numeric_limits<uint32_t>::max();
+  {
+    StdCoutRedirector redirect(output);
+    dump.printPacket(&pkthdr, buffer.buf());
+  }
+  BOOST_CHECK(output.is_equal("0.000000 Ethernet, NDN truncated packet, length 4\n"));
+}
+
 BOOST_AUTO_TEST_CASE(UnsupportedNdnPacket)
 {
   EncodingBuffer buffer(encoding::makeEmptyBlock(tlv::Name));
@@ -379,6 +482,48 @@ BOOST_AUTO_TEST_CASE(MalformedTcpHeader)
   BOOST_CHECK(output.is_equal("IP 0.0.0.0 > 0.0.0.0, TCP truncated header, 40 bytes missing\n"));
 }
 
+BOOST_AUTO_TEST_CASE(TcpStream)
+{
+  dump.wantTimestamp = false;
+  dump.m_tcpReassembler = make_unique<TcpReassembler>(dump.tcpReassemblyOptions);
+
+  Buffer stream;
+  for (const Block& packet : {makeInterest("/a", false, DEFAULT_INTEREST_LIFETIME, 1)->wireEncode(),
+                              makeInterest("/b", false, DEFAULT_INTEREST_LIFETIME, 2)->wireEncode()}) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  size_t split = stream.size();
+  Block data = makeData("/c")->wireEncode();
+  stream.insert(stream.end(), data.begin(), data.end());
+
+  tcphdr tcpHdr{};
+  tcpHdr.TH_OFF = 0x5;
+  auto receiveSegment = [&] (size_t begin, size_t end) {
+    uint32_t sequence = endian::native_to_big(static_cast<uint32_t>(1000 + begin));
+    std::memcpy(reinterpret_cast<uint8_t*>(&tcpHdr) + 4, &sequence, sizeof(sequence));
+    EncodingBuffer pkt;
+    pkt.prependByteArray(stream.data() + begin, end - begin);
+    this->receiveTcp4(pkt, &tcpHdr);
+  };
+
+  receiveSegment(0, 4);
+  BOOST_CHECK(output.is_equal("IP 0.0.0.0 > 0.0.0.0, TCP, length 4, NDN partial packet\n"));
+
+  // each packet completed by a segment is printed on its own line
+  receiveSegment(4, split);
+  const std::string prefix = "IP 0.0.0.0 > 0.0.0.0, TCP, length " + to_string(split - 4) + ", ";
+  BOOST_CHECK(output.is_equal(prefix + "INTEREST: /a?Nonce=00000001\n" +
+                              prefix + "INTEREST: /b?Nonce=00000002\n"));
+
+  receiveSegment(split, stream.size());
+  BOOST_CHECK(output.is_equal("IP 0.0.0.0 > 0.0.0.0, TCP, length " + to_string(data.size()) +
+                              ", DATA: /c\n"));
+
+  // an acknowledgment without payload is not printed
+  receiveSegment(stream.size(), stream.size());
+  BOOST_CHECK(output.is_empty());
+}
+
 BOOST_AUTO_TEST_CASE(MalformedUdpHeader)
 {
   dump.wantTimestamp = false;
@@ -445,6 +590,79 @@ BOOST_AUTO_TEST_CASE(FromFile)
   BOOST_CHECK(output.is_equal(expected));
 }
 
+BOOST_AUTO_TEST_CASE(Statistics)
+{
+  dump.pcapFilter = "";
+  dump.wantStatistics = true;
+  this->readFile("tests/dump/nack.pcap");
+
+  // packets are only counted; each direction of the TCP connection is a separate face
+  const std::string expected =
+    "--- 1571091605.129263 - 1571091605.129702: 2 packets, 1 prefixes, 2 faces\n"
+    "  PREFIX                                           INTERESTS      DATA     NACKS         BYTES\n"
+    "  /producer/nack/no-route                                  1         0         1            72  NoRoute=1\n"
+    "  FACE                                             INTERESTS      DATA     NACKS         BYTES\n"
+    "  tcp 127.0.0.1:59212 > 127.0.0.1:6363                     1         0         0            36\n"
+    "  tcp 127.0.0.1:6363 > 127.0.0.1:59212                     0         0         1            36  NoRoute=1\n";
+  BOOST_CHECK(output.is_equal(expected));
+}
+
+BOOST_AUTO_TEST_CASE(RoundTripTime)
+{
+  dump.pcapFilter = "";
+  dump.wantRtt = true;
+  this->readFile("tests/dump/nack.pcap");
+
+  // the Nack is captured on the reverse direction of the TCP connection
+  const std::string expected =
+    "1571091605.129263 IP 127.0.0.1 > 127.0.0.1, TCP, length 36, "
+    "INTEREST: /producer/nack/no-route?Nonce=827bcac4\n"
+    "1571091605.129702 IP 127.0.0.1 > 127.0.0.1, TCP, length 49, "
+    "NDNLPv2, NACK (NoRoute): /producer/nack/no-route?Nonce=827bcac4, RTT 0.439 ms\n"
+    "--- Interest-Data exchanges: 0 pending, 0 evicted, 0 unsolicited Data or Nacks\n"
+    "  /producer/nack/no-route: 1 Interests, 0 satisfied, 1 nacked, 0 timed out, "
+    "satisfaction 0%, RTT min/avg/max 0.439/0.439/0.439 ms\n"
+    "    <1ms:1\n";
+  BOOST_CHECK(output.is_equal(expected));
+}
+
+BOOST_AUTO_TEST_CASE(JsonFormat)
+{
+  dump.pcapFilter = "";
+  dump.outputFormat = OutputFormat::JSON;
+  dump.wantRtt = true;
+  this->readFile("tests/dump/nack.pcap");
+
+  // the summary of '--rtt' goes to the standard error
+  const std::string expected =
+    "{\"time\":1571091605.129263,\"type\":\"interest\",\"proto\":\"tcp\","
+    "\"src\":\"127.0.0.1\",\"sport\":59212,\"dst\":\"127.0.0.1\",\"dport\":6363,"
+    "\"name\":[\"producer\",\"nack\",\"no-route\"],\"nonce\":\"827bcac4\",\"lifetime\":4000,"
+    "\"size\":36,\"length\":102}\n"
+    "{\"time\":1571091605.129702,\"type\":\"nack\",\"proto\":\"tcp\","
+    "\"src\":\"127.0.0.1\",\"sport\":6363,\"dst\":\"127.0.0.1\",\"dport\":59212,"
+    "\"name\":[\"producer\",\"nack\",\"no-route\"],\"nonce\":\"827bcac4\",\"lifetime\":4000,"
+    "\"reason\":\"NoRoute\",\"rtt\":0.439,\"size\":36,\"length\":115}\n";
+  BOOST_CHECK(output.is_equal(expected));
+}
+
+BOOST_AUTO_TEST_CASE(BinaryFormat)
+{
+  dump.pcapFilter = "";
+  dump.outputFormat = OutputFormat::BINARY;
+  this->readFile("tests/dump/nack.pcap");
+
+  // header, then two records with the same 26-octet name
+  std::string bytes = output.str();
+  BOOST_REQUIRE_EQUAL(bytes.size(), sizeof(BINARY_HEADER) + 2 * (BINARY_RECORD_FIXED_SIZE + 26));
+  BOOST_CHECK_EQUAL(bytes.compare(0, sizeof(BINARY_HEADER), BINARY_HEADER, sizeof(BINARY_HEADER)), 0);
+  size_t second = sizeof(BINARY_HEADER) + BINARY_RECORD_FIXED_SIZE + 26;
+  BOOST_CHECK_EQUAL(bytes[sizeof(BINARY_HEADER) + 4], 1); // Interest
+  BOOST_CHECK_EQUAL(bytes[second + 4], 3); // Nack
+  BOOST_CHECK_EQUAL(bytes.compare(second + BINARY_RECORD_FIXED_SIZE, 26,
+                                  "\x08\x08producer\x08\x04nack\x08\x08no-route"), 0);
+}
+
 BOOST_AUTO_TEST_CASE(LinuxSllTcp4)
 {
   dump.wantTimestamp = false;
@@ -497,6 +715,24 @@ BOOST_AUTO_TEST_CASE(LinuxSllUdp6)
   BOOST_CHECK(output.is_equal(expected));
 }
 
+BOOST_AUTO_TEST_CASE(ParallelDecoding)
+{
+  dump.wantTimestamp = false;
+  dump.nDecoders = 3;
+  dump.fileChunkSize = 1; // one chunk per record, more chunks than output slots
+  this->readFile("tests/dump/linux-sll-tcp6.pcap");
+
+  // packets are printed in capture order
+  const std::string expected =
+    "IP6 2602:fff6:d:b317::39f8 > 2001:660:3302:282c:160::163, TCP, length 42, "
+    "INTEREST: /ndn/edu/arizona/ping/19573?Nonce=7b9e5b2e\n"
+    "IP6 2001:660:3302:282c:160::163 > 2602:fff6:d:b317::39f8, TCP, length 404, "
+    "DATA: /ndn/edu/arizona/ping/19573\n"
+    "IP6 2001:660:3302:282c:160::163 > 2602:fff6:d:b317::39f8, TCP, length 56, "
+    "invalid network packet: Unrecognized element of critical type 9\n";
+  BOOST_CHECK(output.is_equal(expected));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestNdnDump
 BOOST_AUTO_TEST_SUITE_END() // Dump
 
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/packet-mmap-capture.hpp"
+
+#include "tests/test-common.hpp"
+
+#ifdef HAVE_TPACKET_V3
+#include <linux/if_packet.h>
+
+#include <cstring>
+#endif // HAVE_TPACKET_V3
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_AUTO_TEST_SUITE(TestPacketMmapCapture)
+
+#ifdef HAVE_TPACKET_V3
+
+BOOST_AUTO_TEST_CASE(ForEachPacket)
+{
+  // a ring block with two packets, laid out as the kernel does
+  std::vector<uint64_t> storage(512); // 8-byte aligned
+  auto block = reinterpret_cast<uint8_t*>(storage.data());
+  const size_t hdrLen = TPACKET_ALIGN(sizeof(tpacket3_hdr));
+  const std::vector<std::vector<uint8_t>> frames{
+    {0x01, 0x00, 0x5e, 0x00, 0x17, 0xaa, 0x02, 0x00},
+    {0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+  };
+
+  auto desc = reinterpret_cast<tpacket_block_desc*>(block);
+  desc->version = TPACKET_V3;
+  desc->hdr.bh1.num_pkts = static_cast<uint32_t>(frames.size());
+  desc->hdr.bh1.offset_to_first_pkt = TPACKET_ALIGN(sizeof(tpacket_block_desc));
+
+  size_t offset = desc->hdr.bh1.offset_to_first_pkt;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    auto pkt = reinterpret_cast<tpacket3_hdr*>(block + offset);
+    pkt->tp_sec = 1000 + static_cast<uint32_t>(i);
+    pkt->tp_nsec = 123456789;
+    pkt->tp_snaplen = static_cast<uint32_t>(frames[i].size());
+    pkt->tp_len = static_cast<uint32_t>(frames[i].size() + 100); // truncated by the snaplen
+    pkt->tp_mac = static_cast<uint16_t>(hdrLen);
+    std::memcpy(block + offset + hdrLen, frames[i].data(), frames[i].size());
+
+    size_t next = TPACKET_ALIGN(hdrLen + frames[i].size());
+    pkt->tp_next_offset = i + 1 < frames.size() ? static_cast<uint32_t>(next) : 0;
+    offset += next;
+  }
+  BOOST_REQUIRE_LE(offset, storage.size() * sizeof(uint64_t));
+
+  size_t nCalls = 0;
+  size_t nPackets = PacketMmapCapture::forEachPacket(block,
+    [&] (const pcap_pkthdr* pkthdr, const uint8_t* payload) {
+      BOOST_REQUIRE_LT(nCalls, frames.size());
+      const auto& frame = frames[nCalls];
+      BOOST_CHECK_EQUAL(pkthdr->ts.tv_sec, 1000 + static_cast<long>(nCalls));
+      BOOST_CHECK_EQUAL(pkthdr->ts.tv_usec, 123456);
+      BOOST_CHECK_EQUAL(pkthdr->caplen, frame.size());
+      BOOST_CHECK_EQUAL(pkthdr->len, frame.size() + 100);
+      BOOST_CHECK_EQUAL_COLLECTIONS(payload, payload + pkthdr->caplen, frame.begin(), frame.end());
+      ++nCalls;
+    });
+
+  BOOST_CHECK_EQUAL(nPackets, frames.size());
+  BOOST_CHECK_EQUAL(nCalls, frames.size());
+}
+
+BOOST_AUTO_TEST_CASE(EmptyBlock)
+{
+  std::vector<uint64_t> storage(64);
+  auto desc = reinterpret_cast<tpacket_block_desc*>(storage.data());
+  desc->version = TPACKET_V3;
+  desc->hdr.bh1.offset_to_first_pkt = TPACKET_ALIGN(sizeof(tpacket_block_desc));
+
+  size_t nCalls = 0;
+  BOOST_CHECK_EQUAL(PacketMmapCapture::forEachPacket(reinterpret_cast<const uint8_t*>(storage.data()),
+                                                     [&] (const pcap_pkthdr*, const uint8_t*) { ++nCalls; }),
+                    0);
+  BOOST_CHECK_EQUAL(nCalls, 0);
+}
+
+#endif // HAVE_TPACKET_V3
+
+BOOST_AUTO_TEST_CASE(NonexistentInterface)
+{
+  PacketMmapCapture::Options options;
+  options.interface = "ndndump-nonexistent0";
+  BOOST_CHECK_THROW(PacketMmapCapture{options}, PacketMmapCapture::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestPacketMmapCapture
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
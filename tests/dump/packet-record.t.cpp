@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/packet-record.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include <cstring>
+#include <sstream>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+class PacketRecordFixture
+{
+protected:
+  PacketRecordFixture()
+  {
+    record.timestamp = {1571091605, 1263};
+    record.flow.family = FlowKey::Family::IPV6;
+    record.flow.protocol = IPPROTO_UDP;
+    record.flow.srcPort = 56363;
+    record.flow.dstPort = 6363;
+    inet_pton(AF_INET6, "2001:db8::1", record.flow.srcAddr.data());
+    inet_pton(AF_INET6, "2001:db8::2", record.flow.dstAddr.data());
+    record.name = name.value();
+    record.nameSize = name.value_size();
+    record.nonce = nonce;
+    record.lifetime = time::milliseconds(2000);
+    record.packetSize = 40;
+    record.frameSize = 102;
+  }
+
+  template<typename T>
+  T
+  readLittleEndian(const std::string& bytes, size_t offset)
+  {
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(value));
+    return boost::endian::little_to_native(value);
+  }
+
+protected:
+  Block name = Name("/ndn/a%20b").appendSegment(3).wireEncode();
+  const uint8_t nonce[4] = {0x82, 0x7b, 0xca, 0xc4};
+  PacketRecord record;
+  std::ostringstream os;
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestPacketRecord, PacketRecordFixture)
+
+BOOST_AUTO_TEST_CASE(JsonInterest)
+{
+  writeJsonRecord(os, record);
+  BOOST_CHECK_EQUAL(os.str(),
+    "{\"time\":1571091605.001263,\"type\":\"interest\",\"proto\":\"udp\","
+    "\"src\":\"2001:db8::1\",\"sport\":56363,\"dst\":\"2001:db8::2\",\"dport\":6363,"
+    "\"name\":[\"ndn\",\"a%20b\",\"" + name::Component::fromSegment(3).toUri() + "\"],"
+    "\"nonce\":\"827bcac4\",\"lifetime\":2000,\"size\":40,\"length\":102}\n");
+}
+
+BOOST_AUTO_TEST_CASE(JsonNack)
+{
+  record.flow = FlowKey();
+  record.type = TrafficStatistics::PacketType::NACK;
+  record.nackReason = lp::NackReason::NO_ROUTE;
+  record.rtt = time::microseconds(1439);
+  writeJsonRecord(os, record);
+  BOOST_CHECK_EQUAL(os.str(),
+    "{\"time\":1571091605.001263,\"type\":\"nack\","
+    "\"name\":[\"ndn\",\"a%20b\",\"" + name::Component::fromSegment(3).toUri() + "\"],"
+    "\"nonce\":\"827bcac4\",\"lifetime\":2000,\"reason\":\"NoRoute\",\"rtt\":1.439,"
+    "\"size\":40,\"length\":102}\n");
+}
+
+BOOST_AUTO_TEST_CASE(JsonEthernetData)
+{
+  record.flow.family = FlowKey::Family::ETHERNET;
+  record.flow.protocol = 0;
+  record.flow.srcAddr = {0x02, 0, 0, 0, 0, 0x01};
+  record.flow.dstAddr = {0x01, 0x00, 0x5e, 0x00, 0x17, 0xaa};
+  record.type = TrafficStatistics::PacketType::DATA;
+  record.nonce = nullptr;
+  record.lifetime = nullopt;
+  writeJsonRecord(os, record);
+  BOOST_CHECK_EQUAL(os.str(),
+    "{\"time\":1571091605.001263,\"type\":\"data\",\"proto\":\"ether\","
+    "\"src\":\"02:00:00:00:00:01\",\"dst\":\"01:00:5e:00:17:aa\","
+    "\"name\":[\"ndn\",\"a%20b\",\"" + name::Component::fromSegment(3).toUri() + "\"],"
+    "\"size\":40,\"length\":102}\n");
+}
+
+BOOST_AUTO_TEST_CASE(Binary)
+{
+  record.rtt = time::microseconds(1439);
+  writeBinaryRecord(os, record);
+  std::string bytes = os.str();
+
+  BOOST_REQUIRE_EQUAL(bytes.size(), BINARY_RECORD_FIXED_SIZE + name.value_size());
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 0), bytes.size() - 4);
+  BOOST_CHECK_EQUAL(bytes[4], 1); // Interest
+  BOOST_CHECK_EQUAL(bytes[5], 3); // IPv6
+  BOOST_CHECK_EQUAL(bytes[6], IPPROTO_UDP);
+  BOOST_CHECK_EQUAL(bytes[7], 1 | 2 | 4); // nonce, lifetime, RTT
+  BOOST_CHECK_EQUAL(readLittleEndian<int64_t>(bytes, 8), 1571091605);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 16), 1263);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint16_t>(bytes, 20), 56363);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint16_t>(bytes, 22), 6363);
+  BOOST_CHECK(std::equal(record.flow.srcAddr.begin(), record.flow.srcAddr.end(), bytes.begin() + 24,
+                         [] (uint8_t a, char b) { return a == static_cast<uint8_t>(b); }));
+  BOOST_CHECK(std::equal(record.flow.dstAddr.begin(), record.flow.dstAddr.end(), bytes.begin() + 40,
+                         [] (uint8_t a, char b) { return a == static_cast<uint8_t>(b); }));
+  BOOST_CHECK_EQUAL(std::memcmp(bytes.data() + 56, nonce, 4), 0);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 60), 2000);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 64), 0);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 68), 1439);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 72), 40);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 76), 102);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 80), name.value_size());
+  BOOST_CHECK_EQUAL(std::memcmp(bytes.data() + 84, name.value(), name.value_size()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryData)
+{
+  record.type = TrafficStatistics::PacketType::DATA;
+  record.nonce = nullptr;
+  record.lifetime = nullopt;
+  writeBinaryRecord(os, record);
+  std::string bytes = os.str();
+
+  BOOST_REQUIRE_EQUAL(bytes.size(), BINARY_RECORD_FIXED_SIZE + name.value_size());
+  BOOST_CHECK_EQUAL(bytes[4], 2); // Data
+  BOOST_CHECK_EQUAL(bytes[7], 0);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 56), 0);
+  BOOST_CHECK_EQUAL(readLittleEndian<uint32_t>(bytes, 60), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestPacketRecord
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
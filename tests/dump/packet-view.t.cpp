@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/packet-view.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <ndn-cxx/lp/packet.hpp>
+
+#include <boost/lexical_cast.hpp>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_AUTO_TEST_SUITE(TestPacketView)
+
+static std::string
+formatName(const PacketView& packet)
+{
+  return boost::lexical_cast<std::string>(packet.name);
+}
+
+BOOST_AUTO_TEST_CASE(NameUri)
+{
+  std::vector<Name> names{
+    "/A/B",
+    "/hello%20world/%00%FF/~-._",
+    "/.../..../a.b",
+    Name("/A").appendSegment(42),
+    Name("/A").appendVersion(1449227841747).appendSegment(0),
+  };
+
+  for (const auto& name : names) {
+    auto data = makeData(name);
+    PacketView packet;
+    BOOST_REQUIRE(packet.decode(data->wireEncode().wire(), data->wireEncode().size()));
+    BOOST_CHECK_EQUAL(formatName(packet), name.toUri());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Interest)
+{
+  auto interest = makeInterest("/A/B", true, 50_ms, 0x01020304);
+  interest->setMustBeFresh(true);
+  const Block& wire = interest->wireEncode();
+
+  PacketView packet;
+  BOOST_REQUIRE(packet.decode(wire.wire(), wire.size()));
+  BOOST_CHECK(!packet.isLp);
+  BOOST_CHECK_EQUAL(packet.type, tlv::Interest);
+  BOOST_CHECK_EQUAL(packet.wireSize, wire.size());
+  BOOST_CHECK(packet.canBePrefix);
+  BOOST_CHECK(packet.mustBeFresh);
+  BOOST_REQUIRE(packet.lifetime);
+  BOOST_CHECK_EQUAL(*packet.lifetime, 50);
+  BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(AsInterest{packet}),
+                    boost::lexical_cast<std::string>(*interest));
+
+  // default lifetime is not printed, like ndn::Interest does
+  interest->setInterestLifetime(DEFAULT_INTEREST_LIFETIME);
+  const Block& wire2 = interest->wireEncode();
+  BOOST_REQUIRE(packet.decode(wire2.wire(), wire2.size()));
+  BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(AsInterest{packet}),
+                    boost::lexical_cast<std::string>(*interest));
+}
+
+BOOST_AUTO_TEST_CASE(LpHeader)
+{
+  auto interest = makeInterest("/A", false, nullopt, 1);
+  lp::Packet lpPacket(interest->wireEncode());
+  lpPacket.add<lp::SequenceField>(1000);
+  lpPacket.add<lp::NackField>(makeNack(*interest, lp::NackReason::NO_ROUTE).getHeader());
+  Block wire = lpPacket.wireEncode();
+
+  PacketView packet;
+  BOOST_REQUIRE(packet.decode(wire.wire(), wire.size()));
+  BOOST_CHECK(packet.isLp);
+  BOOST_CHECK(!packet.isIdle);
+  BOOST_CHECK(!packet.isFragment);
+  BOOST_CHECK_EQUAL(packet.lpSequence.value(), 1000);
+  BOOST_CHECK_EQUAL(packet.nackReason.value(), lp::NackReason::NO_ROUTE);
+  BOOST_CHECK_EQUAL(packet.type, tlv::Interest);
+  BOOST_CHECK_EQUAL(formatName(packet), "/A");
+}
+
+BOOST_AUTO_TEST_CASE(Unsupported)
+{
+  PacketView packet;
+
+  // truncated
+  auto data = makeData("/A");
+  BOOST_CHECK(!packet.decode(data->wireEncode().wire(), data->wireEncode().size() - 1));
+
+  // name component types other than generic, segment, and version
+  data = makeData(Name("/A").appendTimestamp());
+  BOOST_CHECK(!packet.decode(data->wireEncode().wire(), data->wireEncode().size()));
+
+  // Interest elements that are not printed
+  auto interest = makeInterest("/A");
+  interest->setHopLimit(3);
+  BOOST_CHECK(!packet.decode(interest->wireEncode().wire(), interest->wireEncode().size()));
+
+  // Data without SignatureInfo and SignatureValue
+  const uint8_t unsignedData[] = {
+    0x06, 0x05, // Data
+      0x07, 0x03, // Name
+        0x08, 0x01, 0x41,
+  };
+  BOOST_CHECK(!packet.decode(unsignedData, sizeof(unsignedData)));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestPacketView
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/spsc-ring.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <thread>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_AUTO_TEST_SUITE(TestSpscRing)
+
+BOOST_AUTO_TEST_CASE(FullAndEmpty)
+{
+  SpscRing<int> ring(3);
+  BOOST_CHECK_EQUAL(ring.capacity(), 4);
+  BOOST_CHECK(ring.front() == nullptr);
+
+  for (int i = 0; i < 4; ++i) {
+    int* slot = ring.prepareWrite();
+    BOOST_REQUIRE(slot != nullptr);
+    *slot = i;
+    ring.commitWrite();
+  }
+  BOOST_CHECK(ring.prepareWrite() == nullptr);
+
+  BOOST_REQUIRE(ring.front() != nullptr);
+  BOOST_CHECK_EQUAL(*ring.front(), 0);
+  ring.pop();
+  BOOST_CHECK(ring.prepareWrite() != nullptr);
+
+  for (int i = 1; i < 4; ++i) {
+    BOOST_REQUIRE(ring.front() != nullptr);
+    BOOST_CHECK_EQUAL(*ring.front(), i);
+    ring.pop();
+  }
+  BOOST_CHECK(ring.front() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TwoThreads)
+{
+  const uint64_t nItems = 100000;
+  SpscRing<uint64_t> ring(16);
+
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < nItems; ++i) {
+      uint64_t* slot = nullptr;
+      while ((slot = ring.prepareWrite()) == nullptr) {
+        std::this_thread::yield();
+      }
+      *slot = i;
+      ring.commitWrite();
+    }
+  });
+
+  bool isInOrder = true;
+  for (uint64_t expected = 0; expected < nItems; ) {
+    uint64_t* slot = ring.front();
+    if (slot == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    isInOrder = isInOrder && *slot == expected;
+    ring.pop();
+    ++expected;
+  }
+  producer.join();
+
+  BOOST_CHECK(isInOrder);
+  BOOST_CHECK(ring.front() == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestSpscRing
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
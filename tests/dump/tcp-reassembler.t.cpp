@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/tcp-reassembler.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+
+class TcpReassemblerFixture
+{
+protected:
+  TcpReassemblerFixture()
+  {
+    flow.family = FlowKey::Family::IPV4;
+    flow.protocol = IPPROTO_TCP;
+    flow.srcPort = 6363;
+    flow.dstPort = 40000;
+    inet_pton(AF_INET, "192.0.2.1", flow.srcAddr.data());
+    inet_pton(AF_INET, "192.0.2.2", flow.dstAddr.data());
+
+    // three packets of different types, back to back in the stream
+    for (const Block& packet : {makeInterest("/a", false, DEFAULT_INTEREST_LIFETIME, 1)->wireEncode(),
+                                makeData("/b")->wireEncode(),
+                                makeInterest("/c", false, DEFAULT_INTEREST_LIFETIME, 2)->wireEncode()}) {
+      packets.emplace_back(packet.begin(), packet.end());
+      stream.insert(stream.end(), packet.begin(), packet.end());
+    }
+  }
+
+  /**
+   * @brief add the bytes [@p begin, @p end) of the stream, starting at sequence number 1000
+   * @return number of completed packets
+   */
+  size_t
+  add(TcpReassembler& reassembler, size_t begin, size_t end, bool isSyn = false, bool isFin = false)
+  {
+    TcpReassembler::Segment segment;
+    segment.sequence = static_cast<uint32_t>(1000 + begin - (isSyn ? 1 : 0));
+    segment.isSyn = isSyn;
+    segment.isFin = isFin;
+    segment.payload = stream.data() + begin;
+    segment.size = end - begin;
+    return reassembler.add({1, 0}, flow, segment, [this] (const uint8_t* packet, size_t size) {
+      received.emplace_back(packet, packet + size);
+    });
+  }
+
+protected:
+  FlowKey flow;
+  TcpReassembler::Options options;
+  std::vector<Buffer> packets;
+  Buffer stream;
+  std::vector<Buffer> received;
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestTcpReassembler, TcpReassemblerFixture)
+
+BOOST_AUTO_TEST_CASE(InOrder)
+{
+  TcpReassembler reassembler(options);
+
+  // the first packet spans two segments, the second segment also contains the next two
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 0, true), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 3), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, 3, stream.size()), 3);
+  BOOST_REQUIRE_EQUAL(received.size(), 3);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    BOOST_CHECK_EQUAL_COLLECTIONS(received[i].begin(), received[i].end(),
+                                  packets[i].begin(), packets[i].end());
+  }
+  BOOST_CHECK_EQUAL(reassembler.getNPackets(), 3);
+  BOOST_CHECK_EQUAL(reassembler.getNSkippedBytes(), 0);
+
+  // FIN ends the stream
+  BOOST_CHECK_EQUAL(reassembler.size(), 1);
+  add(reassembler, stream.size(), stream.size(), false, true);
+  BOOST_CHECK_EQUAL(reassembler.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfOrder)
+{
+  TcpReassembler reassembler(options);
+  size_t split = packets[0].size() + 5;
+
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 0, true), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, split, stream.size()), 0);
+
+  // a retransmission overlapping with data already received is trimmed
+  BOOST_CHECK_EQUAL(add(reassembler, 0, split), 3);
+  BOOST_CHECK_EQUAL(add(reassembler, 0, split), 0);
+  BOOST_REQUIRE_EQUAL(received.size(), 3);
+  BOOST_CHECK_EQUAL_COLLECTIONS(received[2].begin(), received[2].end(),
+                                packets[2].begin(), packets[2].end());
+}
+
+BOOST_AUTO_TEST_CASE(MidStream)
+{
+  TcpReassembler reassembler(options);
+
+  // the capture started in the middle of the first packet, framing starts at the next segment
+  BOOST_CHECK_EQUAL(add(reassembler, 2, packets[0].size()), 0);
+  BOOST_CHECK_EQUAL(reassembler.getNSkippedBytes(), packets[0].size() - 2);
+  BOOST_CHECK_EQUAL(add(reassembler, packets[0].size(), stream.size()), 2);
+  BOOST_CHECK_EQUAL(received.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Gap)
+{
+  options.maxEarlyBytes = packets[2].size();
+  TcpReassembler reassembler(options);
+  size_t third = packets[0].size() + packets[1].size();
+
+  // the end of the first packet and the second packet are never captured; the retransmission
+  // of the third packet exceeds the early bytes limit, so the stream continues from there
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 0, true), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 2), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, third, stream.size()), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, third, stream.size()), 1);
+  BOOST_CHECK_EQUAL(reassembler.getNResyncs(), 1);
+  BOOST_REQUIRE_EQUAL(received.size(), 1);
+  BOOST_CHECK_EQUAL_COLLECTIONS(received[0].begin(), received[0].end(),
+                                packets[2].begin(), packets[2].end());
+}
+
+BOOST_AUTO_TEST_CASE(NotNdn)
+{
+  TcpReassembler reassembler(options);
+  stream.insert(stream.begin(), {0x47, 0x45, 0x54, 0x20}); // "GET "
+
+  BOOST_CHECK_EQUAL(add(reassembler, 0, 0, true), 0);
+  BOOST_CHECK_EQUAL(add(reassembler, 0, stream.size()), 0);
+  BOOST_CHECK_EQUAL(reassembler.getNResyncs(), 1);
+  BOOST_CHECK_EQUAL(reassembler.getNSkippedBytes(), stream.size());
+}
+
+BOOST_AUTO_TEST_CASE(Capacity)
+{
+  options.capacity = 2;
+  TcpReassembler reassembler(options);
+
+  for (uint16_t port = 1; port <= 3; ++port) {
+    flow.dstPort = port;
+    add(reassembler, 0, 2);
+  }
+  BOOST_CHECK_EQUAL(reassembler.size(), 2);
+  BOOST_CHECK_EQUAL(reassembler.getNEvicted(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTcpReassembler
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
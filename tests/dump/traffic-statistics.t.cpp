@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/dump/traffic-statistics.hpp"
+
+#include "tests/test-common.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <boost/test/tools/output_test_stream.hpp>
+
+namespace ndn {
+namespace dump {
+namespace tests {
+
+using namespace ndn::tests;
+using PacketType = TrafficStatistics::PacketType;
+
+class TrafficStatisticsFixture
+{
+protected:
+  TrafficStatisticsFixture()
+  {
+    flow.family = FlowKey::Family::IPV4;
+    flow.protocol = IPPROTO_TCP;
+    flow.srcPort = 6363;
+    flow.dstPort = 40000;
+    inet_pton(AF_INET, "192.0.2.1", flow.srcAddr.data());
+    inet_pton(AF_INET, "192.0.2.2", flow.dstAddr.data());
+  }
+
+  void
+  add(TrafficStatistics& stats, const timeval& ts, const Name& name, PacketType type, size_t nBytes,
+      lp::NackReason reason = lp::NackReason::NONE)
+  {
+    const Block& wire = name.wireEncode();
+    stats.add(ts, flow, type, wire.value(), wire.value_size(), nBytes, reason);
+  }
+
+protected:
+  FlowKey flow;
+  TrafficStatistics::Options options;
+  boost::test_tools::output_test_stream output;
+};
+
+BOOST_AUTO_TEST_SUITE(Dump)
+BOOST_FIXTURE_TEST_SUITE(TestTrafficStatistics, TrafficStatisticsFixture)
+
+BOOST_AUTO_TEST_CASE(TopPrefixes)
+{
+  options.depth = 2;
+  options.topN = 2;
+  options.interval = 0_s;
+  TrafficStatistics stats(options, output);
+
+  add(stats, {1, 0}, "/a/b/c", PacketType::INTEREST, 100);
+  add(stats, {1, 500000}, "/a/b/d", PacketType::DATA, 200);
+  add(stats, {2, 0}, "/a/x", PacketType::NACK, 50, lp::NackReason::NO_ROUTE);
+  add(stats, {2, 500000}, "/z", PacketType::INTEREST, 10);
+  BOOST_CHECK_EQUAL(stats.getNPrefixes(), 5); // root, /a, /a/b, /a/x, /z
+  BOOST_CHECK_EQUAL(stats.getNFaces(), 1);
+  BOOST_CHECK(output.is_empty());
+
+  stats.printSnapshot();
+  BOOST_CHECK(output.is_equal(
+    "--- 1.000000 - 2.500000: 4 packets, 3 prefixes, 1 faces\n"
+    "  PREFIX                                           INTERESTS      DATA     NACKS         BYTES\n"
+    "  /a/b                                                     1         1         0           300\n"
+    "  /a/x                                                     0         0         1            50  NoRoute=1\n"
+    "  FACE                                             INTERESTS      DATA     NACKS         BYTES\n"
+    "  tcp 192.0.2.1:6363 > 192.0.2.2:40000                     2         1         1           360  NoRoute=1\n"));
+
+  // counters are reset after each snapshot
+  BOOST_CHECK_EQUAL(stats.getNPrefixes(), 1);
+  BOOST_CHECK_EQUAL(stats.getNFaces(), 0);
+  stats.printSnapshot();
+  BOOST_CHECK(output.is_empty());
+}
+
+BOOST_AUTO_TEST_CASE(Interval)
+{
+  options.depth = 1;
+  TrafficStatistics stats(options, output);
+
+  add(stats, {100, 0}, "/a/b", PacketType::INTEREST, 10);
+  add(stats, {105, 0}, "/a/c", PacketType::INTEREST, 10);
+  BOOST_CHECK(output.is_empty());
+
+  add(stats, {112, 1}, "/a/d", PacketType::INTEREST, 10);
+  BOOST_CHECK(output.is_equal(
+    "--- 100.000000 - 105.000000: 2 packets, 1 prefixes, 1 faces\n"
+    "  PREFIX                                           INTERESTS      DATA     NACKS         BYTES\n"
+    "  /a                                                       2         0         0            20\n"
+    "  FACE                                             INTERESTS      DATA     NACKS         BYTES\n"
+    "  tcp 192.0.2.1:6363 > 192.0.2.2:40000                     2         0         0            20\n"));
+
+  stats.printSnapshot();
+  BOOST_CHECK(output.is_equal(
+    "--- 112.000001 - 112.000001: 1 packets, 1 prefixes, 1 faces\n"
+    "  PREFIX                                           INTERESTS      DATA     NACKS         BYTES\n"
+    "  /a                                                       1         0         0            10\n"
+    "  FACE                                             INTERESTS      DATA     NACKS         BYTES\n"
+    "  tcp 192.0.2.1:6363 > 192.0.2.2:40000                     1         0         0            10\n"));
+}
+
+BOOST_AUTO_TEST_CASE(MaxEntries)
+{
+  options.depth = 1;
+  options.maxEntries = 1;
+  TrafficStatistics stats(options, output);
+
+  add(stats, {0, 0}, "/a", PacketType::INTEREST, 10);
+  add(stats, {0, 0}, "/b", PacketType::INTEREST, 10);
+  BOOST_CHECK_EQUAL(stats.getNPrefixes(), 2);
+
+  stats.printSnapshot();
+  BOOST_CHECK(output.is_equal(
+    "--- 0.000000 - 0.000000: 2 packets, 1 prefixes, 1 faces\n"
+    "  PREFIX                                           INTERESTS      DATA     NACKS         BYTES\n"
+    "  /a                                                       1         0         0            10\n"
+    "  (other)                                                  1         0         0            10\n"
+    "  FACE                                             INTERESTS      DATA     NACKS         BYTES\n"
+    "  tcp 192.0.2.1:6363 > 192.0.2.2:40000                     2         0         0            20\n"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestTrafficStatistics
+BOOST_AUTO_TEST_SUITE_END() // Dump
+
+} // namespace tests
+} // namespace dump
+} // namespace ndn
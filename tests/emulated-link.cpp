@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tests/emulated-link.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace tests {
+
+EmulatedLink::EmulatedLink(util::DummyClientFace& consumerFace, util::DummyClientFace& producerFace,
+                           const Options& options)
+  : m_consumerFace(consumerFace)
+  , m_producerFace(producerFace)
+  , m_options(options)
+  , m_scheduler(consumerFace.getIoService())
+  , m_rng(options.seed)
+{
+  m_connections.emplace_back(m_consumerFace.onSendInterest.connect([this] (const Interest& interest) {
+    enqueue(m_upstream, {interest.wireEncode().size(), {}, nullptr,
+                         [this, interest] { m_producerFace.receive(interest); }});
+  }));
+
+  m_connections.emplace_back(m_producerFace.onSendData.connect([this] (const Data& data) {
+    auto copy = make_shared<Data>(data);
+    enqueue(m_downstream, {data.wireEncode().size(), {}, copy,
+                           [this, copy] { m_consumerFace.receive(*copy); }});
+  }));
+
+  m_connections.emplace_back(m_producerFace.onSendNack.connect([this] (const lp::Nack& nack) {
+    enqueue(m_downstream, {nack.getInterest().wireEncode().size(), {}, nullptr,
+                           [this, nack] { m_consumerFace.receive(nack); }});
+  }));
+}
+
+void
+EmulatedLink::enqueue(Direction& dir, Packet pkt)
+{
+  if (m_options.lossRate > 0.0 && m_dist(m_rng) < m_options.lossRate) {
+    dir.counters.nLost++;
+    return;
+  }
+
+  if (dir.queue.size() >= m_options.queueCapacity) {
+    dir.counters.nDropped++;
+    return;
+  }
+
+  if (m_options.aqm == Aqm::Red && pkt.data != nullptr && shouldMarkRed(dir)) {
+    pkt.data->setCongestionMark(1);
+    dir.counters.nMarked++;
+  }
+
+  pkt.enqueueTime = time::steady_clock::now();
+  dir.queue.push_back(std::move(pkt));
+  dir.counters.nEnqueued++;
+  dir.counters.maxQueueLength = std::max(dir.counters.maxQueueLength, dir.queue.size());
+
+  if (!dir.isTransmitting) {
+    dir.isTransmitting = true;
+    transmitNext(dir);
+  }
+}
+
+void
+EmulatedLink::transmitNext(Direction& dir)
+{
+  if (dir.queue.empty()) {
+    dir.isTransmitting = false;
+    return;
+  }
+
+  Packet pkt = std::move(dir.queue.front());
+  dir.queue.pop_front();
+
+  if (m_options.aqm == Aqm::CoDel && pkt.data != nullptr && shouldMarkCoDel(dir, pkt)) {
+    pkt.data->setCongestionMark(1);
+    dir.counters.nMarked++;
+  }
+
+  auto txTime = getTransmissionTime(pkt.size);
+  m_scheduler.schedule(txTime + m_options.delay, [&dir, deliver = std::move(pkt.deliver)] {
+    dir.counters.nDelivered++;
+    deliver();
+  });
+  m_scheduler.schedule(txTime, [this, &dir] { transmitNext(dir); });
+}
+
+bool
+EmulatedLink::shouldMarkRed(Direction& dir)
+{
+  dir.redAvgQueue = (1.0 - m_options.redWeight) * dir.redAvgQueue +
+                    m_options.redWeight * dir.queue.size();
+
+  if (dir.redAvgQueue < m_options.redMinThreshold) {
+    return false;
+  }
+  if (dir.redAvgQueue >= m_options.redMaxThreshold) {
+    return true;
+  }
+
+  double p = m_options.redMaxProbability * (dir.redAvgQueue - m_options.redMinThreshold) /
+             (m_options.redMaxThreshold - m_options.redMinThreshold);
+  return m_dist(m_rng) < p;
+}
+
+bool
+EmulatedLink::shouldMarkCoDel(Direction& dir, const Packet& pkt)
+{
+  // marking variant of the CoDel algorithm (RFC 8289)
+  auto now = time::steady_clock::now();
+  auto controlLaw = [this] (time::steady_clock::TimePoint t, uint32_t count) {
+    return t + time::duration_cast<time::nanoseconds>(m_options.codelInterval / std::sqrt(count));
+  };
+
+  bool isAboveTarget = false;
+  if (now - pkt.enqueueTime < m_options.codelTarget || dir.queue.empty()) {
+    dir.codelFirstAboveTime = {};
+  }
+  else if (dir.codelFirstAboveTime == time::steady_clock::TimePoint{}) {
+    dir.codelFirstAboveTime = now + m_options.codelInterval;
+  }
+  else {
+    isAboveTarget = now >= dir.codelFirstAboveTime;
+  }
+
+  if (dir.codelIsMarking) {
+    if (!isAboveTarget) {
+      dir.codelIsMarking = false;
+      return false;
+    }
+    if (now >= dir.codelNextMark) {
+      dir.codelCount++;
+      dir.codelNextMark = controlLaw(dir.codelNextMark, dir.codelCount);
+      return true;
+    }
+    return false;
+  }
+
+  if (isAboveTarget) {
+    dir.codelIsMarking = true;
+    // restart from the previous marking rate if the last marking state ended recently
+    bool isRecent = dir.codelCount > 2 && now - dir.codelNextMark < 16 * m_options.codelInterval;
+    dir.codelCount = isRecent ? dir.codelCount - 2 : 1;
+    dir.codelNextMark = controlLaw(now, dir.codelCount);
+    return true;
+  }
+  return false;
+}
+
+time::nanoseconds
+EmulatedLink::getTransmissionTime(size_t size) const
+{
+  if (m_options.bandwidth == 0) {
+    return 0_ns;
+  }
+  return time::nanoseconds(size * 8 * 1000000000ULL / m_options.bandwidth);
+}
+
+} // namespace tests
+} // namespace ndn
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_TESTS_EMULATED_LINK_HPP
+#define NDN_TOOLS_TESTS_EMULATED_LINK_HPP
+
+#include "core/common.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <deque>
+#include <random>
+
+namespace ndn {
+namespace tests {
+
+/** \brief Active queue management scheme used to set congestion marks on Data packets.
+ */
+enum class Aqm {
+  None,  ///< no congestion marks, drop-tail only
+  Red,   ///< Random Early Detection on the average queue length
+  CoDel, ///< Controlled Delay on the queueing delay of each packet
+};
+
+/** \brief An emulated point-to-point link between a consumer face and a producer face.
+ *
+ *  Interests sent by the consumer face are received by the producer face, Data and Nacks
+ *  sent by the producer face are received by the consumer face. Each direction has its
+ *  own drop-tail queue in front of a bottleneck of the configured bandwidth, followed by
+ *  the propagation delay. Random loss is applied before the queue. Data packets leaving
+ *  the queue may carry a congestion mark, decided by the configured AQM scheme.
+ *
+ *  All timing uses time::steady_clock and the io_service of the faces, so the link is
+ *  deterministic when used with ClockFixture.
+ */
+class EmulatedLink : noncopyable
+{
+public:
+  struct Options
+  {
+    uint64_t bandwidth = 10000000;  ///< bottleneck bandwidth in bits/s; zero means unlimited
+    time::nanoseconds delay = 10_ms; ///< one-way propagation delay
+    size_t queueCapacity = 100;     ///< maximum number of packets queued in each direction
+    double lossRate = 0.0;          ///< probability that a packet is lost
+    uint32_t seed = 0;              ///< seed of the random number generator
+
+    Aqm aqm = Aqm::None;
+    size_t redMinThreshold = 10;    ///< RED: average queue length at which marking starts
+    size_t redMaxThreshold = 50;    ///< RED: average queue length at which every packet is marked
+    double redMaxProbability = 0.1; ///< RED: marking probability at redMaxThreshold
+    double redWeight = 0.002;       ///< RED: weight of the average queue length estimator
+    time::nanoseconds codelTarget = 5_ms;     ///< CoDel: acceptable queueing delay
+    time::nanoseconds codelInterval = 100_ms; ///< CoDel: sliding window of the minimum delay
+  };
+
+  struct Counters
+  {
+    uint64_t nEnqueued = 0;  ///< packets accepted into the queue
+    uint64_t nLost = 0;      ///< packets lost at random
+    uint64_t nDropped = 0;   ///< packets dropped because the queue was full
+    uint64_t nMarked = 0;    ///< Data packets that received a congestion mark
+    uint64_t nDelivered = 0; ///< packets delivered to the other face
+    size_t maxQueueLength = 0;
+  };
+
+  EmulatedLink(util::DummyClientFace& consumerFace, util::DummyClientFace& producerFace,
+               const Options& options);
+
+  /** \brief Counters of the consumer-to-producer direction (Interests).
+   */
+  const Counters&
+  getUpstreamCounters() const
+  {
+    return m_upstream.counters;
+  }
+
+  /** \brief Counters of the producer-to-consumer direction (Data and Nacks).
+   */
+  const Counters&
+  getDownstreamCounters() const
+  {
+    return m_downstream.counters;
+  }
+
+private:
+  struct Packet
+  {
+    size_t size;
+    time::steady_clock::TimePoint enqueueTime;
+    shared_ptr<Data> data; ///< set if the packet can carry a congestion mark
+    std::function<void()> deliver;
+  };
+
+  struct Direction
+  {
+    std::deque<Packet> queue;
+    bool isTransmitting = false;
+    Counters counters;
+
+    double redAvgQueue = 0.0;
+    time::steady_clock::TimePoint codelFirstAboveTime;
+    time::steady_clock::TimePoint codelNextMark;
+    bool codelIsMarking = false;
+    uint32_t codelCount = 0;
+  };
+
+  void
+  enqueue(Direction& dir, Packet pkt);
+
+  void
+  transmitNext(Direction& dir);
+
+  bool
+  shouldMarkRed(Direction& dir);
+
+  bool
+  shouldMarkCoDel(Direction& dir, const Packet& pkt);
+
+  time::nanoseconds
+  getTransmissionTime(size_t size) const;
+
+private:
+  util::DummyClientFace& m_consumerFace;
+  util::DummyClientFace& m_producerFace;
+  const Options m_options;
+  Scheduler m_scheduler;
+  std::mt19937 m_rng;
+  std::uniform_real_distribution<double> m_dist{0.0, 1.0};
+  Direction m_upstream;
+  Direction m_downstream;
+  std::vector<util::signal::ScopedConnection> m_connections;
+};
+
+} // namespace tests
+} // namespace ndn
+
+#endif // NDN_TOOLS_TESTS_EMULATED_LINK_HPP
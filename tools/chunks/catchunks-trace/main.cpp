@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "tools/chunks/catchunks/event-trace.hpp"
+#include "core/version.hpp"
+
+#include <fstream>
+
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+namespace ndn {
+namespace chunks {
+
+namespace po = boost::program_options;
+
+static void
+usage(std::ostream& os, const std::string& programName, const po::options_description& desc)
+{
+  os << "Usage: " << programName << " [options] trace-file\n"
+     << "\n"
+     << "Decode a binary event trace written by ndncatchunks --trace.\n"
+     << "\n"
+     << desc;
+}
+
+static void
+printCsv(EventTraceReader& reader, std::ostream& os)
+{
+  os << "time_ns,segment,event\n";
+  TraceRecord rec;
+  while (reader.read(rec)) {
+    os << rec.age.count() << ',' << rec.segNo << ',' << rec.type << '\n';
+  }
+}
+
+static void
+printJson(EventTraceReader& reader, std::ostream& os)
+{
+  os << "[";
+  TraceRecord rec;
+  bool isFirst = true;
+  while (reader.read(rec)) {
+    os << (isFirst ? "\n" : ",\n")
+       << R"(  {"time_ns":)" << rec.age.count()
+       << R"(,"segment":)" << rec.segNo
+       << R"(,"event":")" << rec.type << "\"}";
+    isFirst = false;
+  }
+  os << "\n]\n";
+}
+
+static int
+main(int argc, char* argv[])
+{
+  std::string programName = argv[0];
+  std::string inputPath;
+  std::string format = "csv";
+
+  po::options_description visibleDesc("Options");
+  visibleDesc.add_options()
+    ("help,h",    "print this help message and exit")
+    ("format,f",  po::value<std::string>(&format)->default_value(format),
+                  "output format; valid values are: 'csv', 'json'")
+    ("version,V", "print program version and exit")
+    ;
+
+  po::options_description hiddenDesc;
+  hiddenDesc.add_options()
+    ("trace-file", po::value<std::string>(&inputPath), "trace file to decode");
+
+  po::positional_options_description p;
+  p.add("trace-file", -1);
+
+  po::options_description optDesc;
+  optDesc.add(visibleDesc).add(hiddenDesc);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(optDesc).positional(p).run(), vm);
+    po::notify(vm);
+  }
+  catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+
+  if (vm.count("help") > 0) {
+    usage(std::cout, programName, visibleDesc);
+    return 0;
+  }
+
+  if (vm.count("version") > 0) {
+    std::cout << "ndncatchunks-trace " << tools::VERSION << std::endl;
+    return 0;
+  }
+
+  if (inputPath.empty()) {
+    usage(std::cerr, programName, visibleDesc);
+    return 2;
+  }
+
+  if (format != "csv" && format != "json") {
+    std::cerr << "ERROR: output format not valid" << std::endl;
+    return 2;
+  }
+
+  std::ifstream is(inputPath, std::ios::binary);
+  if (!is) {
+    std::cerr << "ERROR: failed to open " << inputPath << std::endl;
+    return 4;
+  }
+
+  try {
+    EventTraceReader reader(is);
+    if (format == "csv") {
+      printCsv(reader, std::cout);
+    }
+    else {
+      printJson(reader, std::cout);
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+} // namespace chunks
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  return ndn::chunks::main(argc, argv);
+}
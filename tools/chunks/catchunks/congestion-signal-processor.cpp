@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "congestion-signal-processor.hpp"
+#include "data-fetcher.hpp"
+
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+CongestionSignalProcessor::CongestionSignalProcessor(const Options& opts)
+  : m_options(opts)
+{
+}
+
+void
+CongestionSignalProcessor::onData(uint64_t segNo, uint64_t highInterest)
+{
+  recordResponse(segNo, highInterest);
+}
+
+CongestionDecision
+CongestionSignalProcessor::onCongestionSignal(CongestionSignal signal, uint64_t segNo,
+                                              uint64_t highInterest)
+{
+  CongestionDecision decision{signal, segNo, false, false, 0_ms};
+
+  if (signal == CongestionSignal::CongestionNack) {
+    // a Nack is a response too, so it can complete the current round
+    recordResponse(segNo, highInterest);
+    m_hasNackInRound = true;
+    decision.pacingDelay = computePacingDelay();
+  }
+
+  if (signal == CongestionSignal::CongestionMark && m_options.ignoreCongMarks) {
+    return decision;
+  }
+
+  if (m_options.disableCwa || m_highResponse > m_recPoint) {
+    // react to only one congestion event per RTT (conservative window adaptation)
+    m_recPoint = highInterest;
+    decision.shouldDecreaseWindow = true;
+    decision.shouldBackoffRto = signal != CongestionSignal::CongestionMark;
+  }
+
+  return decision;
+}
+
+void
+CongestionSignalProcessor::recordResponse(uint64_t segNo, uint64_t highInterest)
+{
+  m_highResponse = std::max(m_highResponse, segNo);
+
+  if (segNo > m_roundEnd) {
+    // every segment requested before the current round started has been answered
+    m_nNackRounds = m_hasNackInRound ? m_nNackRounds + 1 : 0;
+    m_hasNackInRound = false;
+    m_roundEnd = highInterest;
+  }
+}
+
+time::milliseconds
+CongestionSignalProcessor::computePacingDelay() const
+{
+  if (m_nNackRounds == 0)
+    return 0_ms;
+
+  auto delay = std::min<double>(std::pow(2, m_nNackRounds - 1),
+                                DataFetcher::MAX_CONGESTION_BACKOFF_TIME.count());
+  return time::milliseconds(static_cast<time::milliseconds::rep>(delay));
+}
+
+std::ostream&
+operator<<(std::ostream& os, CongestionSignal signal)
+{
+  switch (signal) {
+  case CongestionSignal::Timeout:
+    os << "Timeout";
+    break;
+  case CongestionSignal::CongestionNack:
+    os << "CongestionNack";
+    break;
+  case CongestionSignal::CongestionMark:
+    os << "CongestionMark";
+    break;
+  }
+  return os;
+}
+
+} // namespace chunks
+} // namespace ndn
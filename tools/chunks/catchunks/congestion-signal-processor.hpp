@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_SIGNAL_PROCESSOR_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_SIGNAL_PROCESSOR_HPP
+
+#include "options.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief kinds of congestion signal an adaptive pipeline can observe
+ */
+enum class CongestionSignal {
+  Timeout,        ///< the retransmission timer or the Interest lifetime expired
+  CongestionNack, ///< a Nack with reason Congestion was received
+  CongestionMark, ///< a Data packet carrying a congestion mark was received
+};
+
+std::ostream&
+operator<<(std::ostream& os, CongestionSignal signal);
+
+/**
+ * @brief Reaction of the pipeline to a single congestion signal
+ */
+struct CongestionDecision
+{
+  CongestionSignal signal;
+  uint64_t segNo;                 ///< segment number on which the signal was observed
+  bool shouldDecreaseWindow;      ///< true if the signal starts a new congestion event
+  bool shouldBackoffRto;          ///< true if the retransmission timer should be backed off
+  time::milliseconds pacingDelay; ///< how long new Interests should be held back (zero = no pacing)
+};
+
+/**
+ * @brief Combines timeouts, congestion Nacks, and congestion marks into per-RTT decisions
+ *
+ * All congestion signals of an adaptive pipeline go through a single instance of this class,
+ * so that the pipeline reacts at most once per round-trip time to any combination of them
+ * (unless Conservative Window Adaptation is disabled). A round ends when a response (Data or
+ * Nack) is received for a segment requested after the round started.
+ *
+ * Congestion Nacks received in consecutive rounds additionally make the pipeline pause sending
+ * for an exponentially increasing amount of time, shared by all segments. The backoff is reset
+ * as soon as a full round completes without any congestion Nack.
+ */
+class CongestionSignalProcessor : noncopyable
+{
+public:
+  explicit
+  CongestionSignalProcessor(const Options& opts);
+
+  /**
+   * @brief notify the reception of a Data packet
+   *
+   * Must be called before onCongestionSignal() if the Data packet carries a congestion mark.
+   *
+   * @param segNo segment number of the received Data
+   * @param highInterest highest segment number requested so far
+   */
+  void
+  onData(uint64_t segNo, uint64_t highInterest);
+
+  /**
+   * @brief decide how the pipeline should react to a congestion signal
+   *
+   * @param signal the kind of congestion signal
+   * @param segNo segment number on which the signal was observed
+   * @param highInterest highest segment number requested so far
+   */
+  CongestionDecision
+  onCongestionSignal(CongestionSignal signal, uint64_t segNo, uint64_t highInterest);
+
+  /**
+   * @return number of consecutive completed rounds that contained at least one congestion Nack
+   */
+  int
+  getNackRounds() const
+  {
+    return m_nNackRounds;
+  }
+
+private:
+  void
+  recordResponse(uint64_t segNo, uint64_t highInterest);
+
+  time::milliseconds
+  computePacingDelay() const;
+
+private:
+  const Options& m_options;
+  uint64_t m_highResponse = 0; ///< highest segment number for which Data or a Nack was received
+  uint64_t m_recPoint = 0;     ///< highest segment number requested when the last window
+                               ///< decrease occurred, fixed until the next congestion event
+  uint64_t m_roundEnd = 0;     ///< highest segment number requested when the current round started
+  bool m_hasNackInRound = false;
+  int m_nNackRounds = 0;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_CONGESTION_SIGNAL_PROCESSOR_HPP
@@ -26,10 +26,13 @@
  */
 
 #include "consumer.hpp"
+#include "tools/chunks/common/segment-codec.hpp"
 
 namespace ndn {
 namespace chunks {
 
+constexpr size_t Consumer::DECODER_QUEUE_CAPACITY;
+
 Consumer::Consumer(security::Validator& validator, std::ostream& os)
   : m_validator(validator)
   , m_outputStream(os)
@@ -37,6 +40,11 @@ Consumer::Consumer(security::Validator& validator, std::ostream& os)
 {
 }
 
+Consumer::~Consumer()
+{
+  stopDecoder();
+}
+
 void
 Consumer::run(unique_ptr<DiscoverVersion> discover, unique_ptr<PipelineInterests> pipeline)
 {
@@ -70,23 +78,116 @@ Consumer::handleData(const Data& data)
       // 'data' passed to callback comes from DataValidationState and was not created with make_shared
       m_bufferedData[getSegmentFromPacket(data)] = dataPtr;
       writeInOrderData();
+
+      if (isFinished() && m_bufferedData.empty()) {
+        afterFinished();
+      }
     },
     [] (const Data&, const security::ValidationError& error) {
       NDN_THROW(DataValidationError(error));
     });
 }
 
+void
+Consumer::printProgress(std::ostream& os) const
+{
+  if (m_pipeline != nullptr) {
+    m_pipeline->printProgress(os);
+  }
+  os << "ndncatchunks_segments_written " << m_nextToPrint << "\n"
+     << "ndncatchunks_reorder_buffer_segments " << m_bufferedData.size() << "\n";
+}
+
 void
 Consumer::writeInOrderData()
 {
   for (auto it = m_bufferedData.begin();
        it != m_bufferedData.end() && it->first == m_nextToPrint;
        it = m_bufferedData.erase(it), ++m_nextToPrint) {
+    if (!m_decoder.joinable() && isCompressed(it->second->getContentType())) {
+      m_shouldStopDecoder = false;
+      m_decoder = std::thread([this] { runDecoder(); });
+    }
+
+    if (m_decoder.joinable()) {
+      // once the decoder is running, it writes every segment to preserve their order;
+      // wait for room in the queue, so that a slow output stream does not let it grow unbounded
+      std::unique_lock<std::mutex> lock(m_decoderMutex);
+      m_decoderSpaceCv.wait(lock, [this] {
+        return m_decoderError || m_decoderQueue.size() < m_decoderQueueCapacity;
+      });
+      if (m_decoderError) {
+        std::rethrow_exception(m_decoderError);
+      }
+      m_decoderQueue.push_back(it->second);
+      m_decoderCv.notify_one();
+      continue;
+    }
+
     const Block& content = it->second->getContent();
     content.parse();
     m_outputStream.write(reinterpret_cast<const char*>(content.get(tlv::Content).value()), content.get(tlv::Content).value_size());
   }
 }
 
+void
+Consumer::runDecoder()
+{
+  std::vector<uint8_t> buffer;
+  std::unique_lock<std::mutex> lock(m_decoderMutex);
+  while (true) {
+    m_decoderCv.wait(lock, [this] { return m_shouldStopDecoder || !m_decoderQueue.empty(); });
+    if (m_decoderQueue.empty()) {
+      return;
+    }
+    auto data = std::move(m_decoderQueue.front());
+    m_decoderQueue.pop_front();
+    lock.unlock();
+    m_decoderSpaceCv.notify_one();
+
+    try {
+      // parse a copy, the event loop thread may still access the Data packet
+      Block content = data->getContent();
+      content.parse();
+      const Block& payload = content.get(tlv::Content);
+      decodePayload(data->getContentType(), payload.value(), payload.value_size(), buffer);
+      m_outputStream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    }
+    catch (const std::exception&) {
+      lock.lock();
+      m_decoderError = std::current_exception();
+      m_decoderQueue.clear();
+      m_decoderSpaceCv.notify_one();
+      return;
+    }
+
+    lock.lock();
+  }
+}
+
+void
+Consumer::stopDecoder()
+{
+  if (!m_decoder.joinable()) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_decoderMutex);
+    m_shouldStopDecoder = true;
+  }
+  m_decoderCv.notify_one();
+  m_decoder.join();
+}
+
+void
+Consumer::finish()
+{
+  stopDecoder();
+  if (m_decoderError) {
+    std::rethrow_exception(m_decoderError);
+  }
+}
+
 } // namespace chunks
 } // namespace ndn
@@ -34,7 +34,11 @@
 #include <ndn-cxx/security/validation-error.hpp>
 #include <ndn-cxx/security/validator.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
+#include <thread>
 
 namespace ndn {
 namespace chunks {
@@ -45,6 +49,11 @@ namespace chunks {
  * Discover the latest version of the data published under a specified prefix, and retrieve all the
  * segments associated to that version. The segments are fetched in order and written to a
  * user-specified stream in the same order.
+ *
+ * Compressed segments (see Codec) are decoded and written by a separate thread, so that
+ * decompression does not delay the processing of incoming packets. At most
+ * DECODER_QUEUE_CAPACITY segments wait for that thread: when the output stream is slower than
+ * the transfer, writing further segments blocks until there is room in the queue.
  */
 class Consumer : noncopyable
 {
@@ -69,22 +78,64 @@ public:
     }
   };
 
+  /**
+   * @brief Default maximum number of in-order segments waiting to be decoded and written
+   */
+  static constexpr size_t DECODER_QUEUE_CAPACITY = 64;
+
   /**
    * @brief Create the consumer
    */
   explicit
   Consumer(security::Validator& validator, std::ostream& os = std::cout);
 
+  ~Consumer();
+
   /**
    * @brief Run the consumer
    */
   void
   run(unique_ptr<DiscoverVersion> discover, unique_ptr<PipelineInterests> pipeline);
 
+  /**
+   * @brief Signals that all segments have been received and passed to the output stage
+   */
+  util::Signal<Consumer> afterFinished;
+
+  /**
+   * @brief Check if the transfer has stopped or all segments have been received
+   */
+  bool
+  isFinished() const
+  {
+    return m_pipeline != nullptr && m_pipeline->isFinished();
+  }
+
+  /**
+   * @brief Print the current state of the transfer, one metric per line
+   */
+  void
+  printProgress(std::ostream& os) const;
+
+  /**
+   * @brief Wait until all segments written so far have reached the output stream
+   *
+   * Must be called once the face has stopped processing events.
+   * @throw CodecError a compressed segment could not be decoded
+   */
+  void
+  finish();
+
 private:
   void
   handleData(const Data& data);
 
+  void
+  runDecoder();
+
+  void
+  stopDecoder();
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   writeInOrderData();
@@ -98,6 +149,19 @@ private:
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::map<uint64_t, shared_ptr<const Data>> m_bufferedData;
+
+private:
+  // decoder stage, started when the first compressed segment is written
+  std::thread m_decoder;
+  std::condition_variable m_decoderCv; ///< signaled when a segment is queued or on stop
+  std::condition_variable m_decoderSpaceCv; ///< signaled when a segment is dequeued or on error
+  bool m_shouldStopDecoder = false;
+  std::exception_ptr m_decoderError;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::mutex m_decoderMutex;
+  std::deque<shared_ptr<const Data>> m_decoderQueue; ///< in-order segments, not yet written
+  size_t m_decoderQueueCapacity = DECODER_QUEUE_CAPACITY;
 };
 
 } // namespace chunks
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "event-trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <boost/endian/conversion.hpp>
+
+namespace ndn {
+namespace chunks {
+
+constexpr size_t EventTrace::DEFAULT_CAPACITY;
+constexpr uint32_t EventTrace::FORMAT_VERSION;
+constexpr uint32_t EventTrace::RECORD_SIZE;
+const time::milliseconds EventTrace::FLUSH_INTERVAL = 100_ms;
+
+static const char TRACE_MAGIC[] = {'N', 'D', 'N', 'T', 'R', 'A', 'C', 'E'};
+
+static size_t
+roundUpToPowerOfTwo(size_t n)
+{
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+EventTrace::EventTrace(PipelineInterests& pipeline, std::ostream& os, size_t capacity)
+  : m_os(os)
+  , m_ring(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)))
+  , m_mask(m_ring.size() - 1)
+{
+  static_assert(sizeof(EncodedRecord) == RECORD_SIZE, "EncodedRecord must not contain padding");
+
+  uint32_t header[] = {boost::endian::native_to_little(FORMAT_VERSION),
+                       boost::endian::native_to_little(RECORD_SIZE)};
+  m_os.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+  m_os.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  m_writer = std::thread([this] { runWriter(); });
+  m_connection = pipeline.afterSegmentEvent.connect([this] (const SegmentEvent& event) {
+    append(event);
+  });
+}
+
+EventTrace::~EventTrace()
+{
+  m_connection.disconnect();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shouldStop = true;
+  }
+  m_cv.notify_one();
+  m_writer.join();
+}
+
+void
+EventTrace::append(const SegmentEvent& event)
+{
+  size_t head = m_head.load(std::memory_order_relaxed);
+  size_t tail = m_tail.load(std::memory_order_acquire);
+  if (head - tail == m_ring.size()) {
+    ++m_nDropped;
+    return;
+  }
+
+  EncodedRecord& rec = m_ring[head & m_mask];
+  rec.age = boost::endian::native_to_little(static_cast<uint64_t>(event.age.count()));
+  rec.segNoAndType = boost::endian::native_to_little((event.segNo << 8) |
+                                                     static_cast<uint8_t>(event.type));
+  m_head.store(head + 1, std::memory_order_release);
+
+  // wake up the writer early when the ring is half full
+  if (head + 1 - tail == m_ring.size() / 2) {
+    m_cv.notify_one();
+  }
+}
+
+void
+EventTrace::runWriter()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_shouldStop) {
+    m_cv.wait_for(lock, FLUSH_INTERVAL);
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+  lock.unlock();
+  drain();
+}
+
+void
+EventTrace::drain()
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  if (head == tail)
+    return;
+
+  // write the pending records in at most two contiguous chunks
+  while (tail != head) {
+    size_t begin = tail & m_mask;
+    size_t count = std::min(head - tail, m_ring.size() - begin);
+    m_os.write(reinterpret_cast<const char*>(&m_ring[begin]), count * sizeof(EncodedRecord));
+    tail += count;
+  }
+  m_os.flush();
+  m_tail.store(tail, std::memory_order_release);
+}
+
+EventTraceReader::EventTraceReader(std::istream& is)
+  : m_is(is)
+{
+  char magic[sizeof(TRACE_MAGIC)];
+  uint32_t header[2];
+  m_is.read(magic, sizeof(magic));
+  m_is.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!m_is || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+    NDN_THROW(Error("Not an ndncatchunks event trace"));
+  }
+
+  if (boost::endian::little_to_native(header[0]) != EventTrace::FORMAT_VERSION ||
+      boost::endian::little_to_native(header[1]) != EventTrace::RECORD_SIZE) {
+    NDN_THROW(Error("Unsupported event trace format version " +
+                    to_string(boost::endian::little_to_native(header[0]))));
+  }
+}
+
+bool
+EventTraceReader::read(TraceRecord& record)
+{
+  uint64_t buf[2];
+  m_is.read(reinterpret_cast<char*>(buf), sizeof(buf));
+  if (m_is.gcount() == 0) {
+    return false;
+  }
+  if (m_is.gcount() != sizeof(buf)) {
+    NDN_THROW(Error("Truncated event trace record"));
+  }
+
+  uint64_t segNoAndType = boost::endian::little_to_native(buf[1]);
+  record.age = time::nanoseconds(boost::endian::little_to_native(buf[0]));
+  record.segNo = segNoAndType >> 8;
+  record.type = static_cast<SegmentEventType>(segNoAndType & 0xFF);
+  return true;
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_EVENT_TRACE_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_EVENT_TRACE_HPP
+
+#include "pipeline-interests.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief A decoded record of a binary event trace
+ */
+struct TraceRecord
+{
+  time::nanoseconds age; ///< time elapsed since the pipeline started
+  uint64_t segNo;
+  SegmentEventType type;
+};
+
+/**
+ * @brief Records per-segment pipeline events into a compact binary trace
+ *
+ * Events are appended to a fixed-size ring buffer by the thread running the pipeline and
+ * written out in large chunks by a background thread, so the pipeline itself never formats
+ * or writes anything. If the writer cannot keep up and the ring is full, events are dropped
+ * and counted.
+ *
+ * The trace starts with a 16-byte header: the magic string "NDNTRACE", the format version,
+ * and the record size (two 32-bit integers). Each record is 16 bytes: the event time in
+ * nanoseconds since the pipeline started, then the segment number shifted left by 8 bits
+ * and OR'ed with the event type. All integers are little-endian.
+ */
+class EventTrace : noncopyable
+{
+public:
+  /**
+   * @param pipeline the pipeline whose events are recorded
+   * @param os binary output stream, must not be used by anyone else while the trace is alive
+   * @param capacity number of records that can be buffered, rounded up to a power of two
+   */
+  EventTrace(PipelineInterests& pipeline, std::ostream& os, size_t capacity = DEFAULT_CAPACITY);
+
+  /**
+   * @brief Flushes all buffered records and stops the writer thread
+   */
+  ~EventTrace();
+
+  /**
+   * @return number of events that were dropped because the ring buffer was full
+   */
+  uint64_t
+  getNDropped() const
+  {
+    return m_nDropped;
+  }
+
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 1 << 16;
+  static constexpr uint32_t FORMAT_VERSION = 1;
+  static constexpr uint32_t RECORD_SIZE = 16;
+  static const time::milliseconds FLUSH_INTERVAL;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  void
+  append(const SegmentEvent& event);
+
+private:
+  void
+  runWriter();
+
+  /**
+   * @brief write all records appended so far to the output stream
+   */
+  void
+  drain();
+
+private:
+  struct EncodedRecord
+  {
+    uint64_t age;
+    uint64_t segNoAndType;
+  };
+
+  std::ostream& m_os;
+  std::vector<EncodedRecord> m_ring;
+  size_t m_mask;
+  std::atomic<size_t> m_head{0}; ///< next slot to be written by the pipeline thread
+  std::atomic<size_t> m_tail{0}; ///< next slot to be read by the writer thread
+  uint64_t m_nDropped = 0;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_shouldStop = false;
+  std::thread m_writer;
+
+  util::signal::ScopedConnection m_connection;
+};
+
+/**
+ * @brief Reads records from a binary event trace written by EventTrace
+ */
+class EventTraceReader : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @brief reads and checks the trace header
+   * @throw Error the header is missing or invalid
+   */
+  explicit
+  EventTraceReader(std::istream& is);
+
+  /**
+   * @brief read the next record
+   * @return false if the end of the trace has been reached
+   * @throw Error the trace is truncated
+   */
+  bool
+  read(TraceRecord& record);
+
+private:
+  std::istream& m_is;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_EVENT_TRACE_HPP
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace chunks {
+
+constexpr int LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t LatencyHistogram::SUB_BUCKET_COUNT;
+constexpr size_t LatencyHistogram::BUCKET_COUNT;
+
+void
+LatencyHistogram::record(time::nanoseconds value)
+{
+  auto v = static_cast<uint64_t>(std::max<time::nanoseconds::rep>(value.count(), 0));
+  m_buckets[getBucketIndex(v)]++;
+  m_count++;
+  m_min = std::min(m_min, v);
+  m_max = std::max(m_max, v);
+}
+
+time::nanoseconds
+LatencyHistogram::getPercentile(double percentile) const
+{
+  BOOST_ASSERT(m_count > 0);
+
+  auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count));
+  rank = std::min(std::max<uint64_t>(rank, 1), m_count);
+
+  uint64_t seen = 0;
+  for (size_t i = getBucketIndex(m_min); i < BUCKET_COUNT; ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      return time::nanoseconds(std::min(getBucketUpperBound(i), m_max));
+    }
+  }
+  return time::nanoseconds(m_max);
+}
+
+void
+LatencyHistogram::save(std::ostream& os, const std::string& label) const
+{
+  for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+    if (m_buckets[i] > 0) {
+      os << label << ' ' << getBucketLowerBound(i) << ' ' << getBucketUpperBound(i)
+         << ' ' << m_buckets[i] << '\n';
+    }
+  }
+}
+
+size_t
+LatencyHistogram::getBucketIndex(uint64_t value)
+{
+  if (value < SUB_BUCKET_COUNT) {
+    return static_cast<size_t>(value);
+  }
+
+  // position of the most significant bit, at least SUB_BUCKET_BITS here
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - SUB_BUCKET_BITS;
+  return (shift + 1) * SUB_BUCKET_COUNT + static_cast<size_t>((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t
+LatencyHistogram::getBucketLowerBound(size_t index)
+{
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+
+  int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+  return (SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+}
+
+uint64_t
+LatencyHistogram::getBucketUpperBound(size_t index)
+{
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+
+  int shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+  return getBucketLowerBound(index) + ((uint64_t(1) << shift) - 1);
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_LATENCY_HISTOGRAM_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_LATENCY_HISTOGRAM_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Log-bucketed histogram of durations with constant memory and O(1) insertion
+ *
+ * Values are recorded in nanoseconds. Every power-of-two range is split into
+ * 2^SUB_BUCKET_BITS linear sub-buckets, so that the value reported for any percentile
+ * is within 1 / 2^SUB_BUCKET_BITS (about 3%) of the true value, regardless of magnitude.
+ * Since bucket boundaries are fixed, histograms saved by different runs can be merged
+ * by adding the counts of identical buckets.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr int SUB_BUCKET_BITS = 5;
+  static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  void
+  record(time::nanoseconds value);
+
+  uint64_t
+  getCount() const
+  {
+    return m_count;
+  }
+
+  time::nanoseconds
+  getMin() const
+  {
+    return time::nanoseconds(m_min);
+  }
+
+  time::nanoseconds
+  getMax() const
+  {
+    return time::nanoseconds(m_max);
+  }
+
+  /**
+   * @brief return the value below which @p percentile percent of the recorded values fall
+   * @param percentile a number in [0, 100]
+   * @pre getCount() > 0
+   *
+   * The returned value is the upper bound of the bucket containing the percentile,
+   * clamped to the maximum recorded value.
+   */
+  time::nanoseconds
+  getPercentile(double percentile) const;
+
+  /**
+   * @brief write all non-empty buckets, one per line
+   *
+   * Each line contains @p label, the lowest and highest value of the bucket in nanoseconds,
+   * and the number of values recorded in the bucket, separated by spaces.
+   */
+  void
+  save(std::ostream& os, const std::string& label) const;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  static size_t
+  getBucketIndex(uint64_t value);
+
+  static uint64_t
+  getBucketLowerBound(size_t index);
+
+  static uint64_t
+  getBucketUpperBound(size_t index);
+
+private:
+  std::array<uint64_t, BUCKET_COUNT> m_buckets{};
+  uint64_t m_count = 0;
+  uint64_t m_min = std::numeric_limits<uint64_t>::max();
+  uint64_t m_max = 0;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_LATENCY_HISTOGRAM_HPP
@@ -31,9 +31,11 @@
 
 #include "consumer.hpp"
 #include "discover-version.hpp"
+#include "event-trace.hpp"
 #include "pipeline-interests-aimd.hpp"
 #include "pipeline-interests-cubic.hpp"
 #include "pipeline-interests-fixed.hpp"
+#include "progress-reporter.hpp"
 #include "statistics-collector.hpp"
 #include "core/version.hpp"
 
@@ -53,8 +55,8 @@ main(int argc, char* argv[])
   std::string programName(argv[0]);
 
   Options options;
-  std::string uri, pipelineType("fixed"), cwndPath, rttPath;
-  time::milliseconds::rep minRto(200), maxRto(60000);
+  std::string uri, pipelineType("fixed"), cwndPath, rttPath, histogramPath, tracePath, statsPath;
+  time::milliseconds::rep minRto(200), maxRto(60000), statsInterval(1000);
   double rtoAlpha(0.125), rtoBeta(0.25);
   int rtoK(8);
 
@@ -74,6 +76,13 @@ main(int argc, char* argv[])
                     "skip version discovery, even if the supplied name does not end with a version component")
     ("quiet,q",     po::bool_switch(&options.isQuiet), "suppress all diagnostic output, except fatal errors")
     ("verbose,v",   po::bool_switch(&options.isVerbose), "turn on verbose output (per segment information")
+    ("trace",       po::value<std::string>(&tracePath),
+                    "write a binary trace of per-segment events to the specified file "
+                    "(use ndncatchunks-trace to decode it)")
+    ("stats-file",  po::value<std::string>(&statsPath),
+                    "periodically rewrite the specified file with live transfer metrics")
+    ("stats-interval", po::value<time::milliseconds::rep>(&statsInterval)->default_value(statsInterval),
+                       "interval between two updates of the stats file, in milliseconds")
     ("version,V",   "print program version and exit")
     ;
 
@@ -93,6 +102,9 @@ main(int argc, char* argv[])
     ("reset-cwnd-to-init", po::bool_switch(&options.resetCwndToInit),
                            "after a timeout or congestion mark, reset the window "
                            "to the initial value instead of resetting to ssthresh")
+    ("fec",           po::value<size_t>(&options.fecBlockSize)->default_value(options.fecBlockSize),
+                      "rebuild lost segments from the parity segments published with "
+                      "'ndnputchunks --fec', using the same block size (0 = disabled)")
     ("init-cwnd",     po::value<double>(&options.initCwnd)->default_value(options.initCwnd),
                       "initial congestion window in segments")
     ("init-ssthresh", po::value<double>(&options.initSsthresh),
@@ -113,6 +125,8 @@ main(int argc, char* argv[])
                   "maximum RTO value, in milliseconds")
     ("log-cwnd",  po::value<std::string>(&cwndPath), "log file for congestion window stats")
     ("log-rtt",   po::value<std::string>(&rttPath), "log file for round-trip time stats")
+    ("log-histogram", po::value<std::string>(&histogramPath),
+                      "file to write the RTT and inter-arrival gap histograms to, at the end of the transfer")
     ;
 
   po::options_description cubicPipeDesc("CUBIC pipeline options");
@@ -189,6 +203,11 @@ main(int argc, char* argv[])
     return 2;
   }
 
+  if (statsInterval <= 0) {
+    std::cerr << "ERROR: stats interval must be positive" << std::endl;
+    return 2;
+  }
+
   try {
     Face face;
     auto discover = make_unique<DiscoverVersion>(face, Name(uri), options);
@@ -197,6 +216,10 @@ main(int argc, char* argv[])
     unique_ptr<RttEstimatorWithStats> rttEstimator;
     std::ofstream statsFileCwnd;
     std::ofstream statsFileRtt;
+    std::ofstream histogramFile;
+    const PipelineInterestsAdaptive* adaptivePipelinePtr = nullptr;
+    std::ofstream traceFile;
+    unique_ptr<EventTrace> eventTrace;
 
     if (pipelineType == "fixed") {
       pipeline = make_unique<PipelineInterestsFixed>(face, options);
@@ -249,6 +272,15 @@ main(int argc, char* argv[])
         statsCollector = make_unique<StatisticsCollector>(*adaptivePipeline, statsFileCwnd, statsFileRtt);
       }
 
+      if (!histogramPath.empty()) {
+        histogramFile.open(histogramPath);
+        if (histogramFile.fail()) {
+          std::cerr << "ERROR: failed to open " << histogramPath << std::endl;
+          return 4;
+        }
+      }
+
+      adaptivePipelinePtr = adaptivePipeline.get();
       pipeline = std::move(adaptivePipeline);
     }
     else {
@@ -256,11 +288,36 @@ main(int argc, char* argv[])
       return 2;
     }
 
+    if (!tracePath.empty()) {
+      traceFile.open(tracePath, std::ios::binary);
+      if (traceFile.fail()) {
+        std::cerr << "ERROR: failed to open " << tracePath << std::endl;
+        return 4;
+      }
+      eventTrace = make_unique<EventTrace>(*pipeline, traceFile);
+    }
+
     Consumer consumer(security::getAcceptAllValidator());
+    unique_ptr<ProgressReporter> progressReporter;
+    if (!statsPath.empty()) {
+      progressReporter = make_unique<ProgressReporter>(face, consumer, statsPath,
+                                                       time::milliseconds(statsInterval));
+    }
+
     BOOST_ASSERT(discover != nullptr);
     BOOST_ASSERT(pipeline != nullptr);
     consumer.run(std::move(discover), std::move(pipeline));
     face.processEvents();
+    consumer.finish();
+
+    if (histogramFile.is_open()) {
+      adaptivePipelinePtr->getRttHistogram().save(histogramFile, "rtt");
+      adaptivePipelinePtr->getInterArrivalHistogram().save(histogramFile, "gap");
+    }
+
+    if (eventTrace != nullptr && eventTrace->getNDropped() > 0 && !options.isQuiet) {
+      std::cerr << "WARNING: " << eventTrace->getNDropped() << " trace events were dropped" << std::endl;
+    }
   }
   catch (const Consumer::ApplicationNackError& e) {
     std::cerr << "ERROR: " << e.what() << std::endl;
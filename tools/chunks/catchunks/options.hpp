@@ -51,6 +51,8 @@ struct Options : noncopyable
   time::milliseconds rtoCheckInterval{10}; ///< interval for checking retransmission timer
   bool ignoreCongMarks = false; ///< disable window decrease after receiving congestion mark
   bool disableCwa = false;      ///< disable conservative window adaptation
+  size_t fecBlockSize = 0;      ///< if not zero, fetch a parity segment for every block of this
+                                ///< many segments and use it to rebuild a lost segment
 
   // AIMD pipeline options
   double aiStep = 1.0;          ///< AIMD additive increase step (in segments)
@@ -28,6 +28,9 @@
 
 #include "pipeline-interests-adaptive.hpp"
 #include "data-fetcher.hpp"
+#include "tools/chunks/common/parity.hpp"
+
+#include <boost/io/ios_state.hpp>
 
 #include <cmath>
 #include <iomanip>
@@ -45,9 +48,9 @@ PipelineInterestsAdaptive::PipelineInterestsAdaptive(Face& face,
   , m_ssthresh(m_options.initSsthresh)
   , m_rttEstimator(rttEstimator)
   , m_scheduler(m_face.getIoService())
-  , m_highData(0)
   , m_highInterest(0)
-  , m_recPoint(0)
+  , m_congestionProcessor(m_options)
+  , m_isPacing(false)
   , m_nInFlight(0)
   , m_nLossDecr(0)
   , m_nMarkDecr(0)
@@ -55,7 +58,11 @@ PipelineInterestsAdaptive::PipelineInterestsAdaptive(Face& face,
   , m_nSkippedRetx(0)
   , m_nRetransmitted(0)
   , m_nCongMarks(0)
+  , m_nCongNacks(0)
+  , m_nNackDecr(0)
   , m_nSent(0)
+  , m_nParityReceived(0)
+  , m_nRecovered(0)
   , m_hasFailure(false)
   , m_failedSegNo(0)
 {
@@ -87,7 +94,9 @@ void
 PipelineInterestsAdaptive::doCancel()
 {
   m_checkRtoEvent.cancel();
+  m_pacingEvent.cancel();
   m_segmentInfo.clear();
+  m_fecBlocks.clear();
 }
 
 void
@@ -97,6 +106,7 @@ PipelineInterestsAdaptive::checkRto()
     return;
 
   bool hasTimeout = false;
+  uint64_t timedOutSegNo = 0;
 
   for (auto& entry : m_segmentInfo) {
     SegmentInfo& segInfo = entry.second;
@@ -104,14 +114,16 @@ PipelineInterestsAdaptive::checkRto()
       auto timeElapsed = time::steady_clock::now() - segInfo.timeSent;
       if (timeElapsed > segInfo.rto) { // timer expired?
         m_nTimeouts++;
+        traceSegment(SegmentEventType::Timeout, entry.first);
         hasTimeout = true;
+        timedOutSegNo = entry.first;
         enqueueForRetransmission(entry.first);
       }
     }
   }
 
   if (hasTimeout) {
-    recordTimeout();
+    handleCongestionSignal(CongestionSignal::Timeout, timedOutSegNo);
     schedulePackets();
   }
 
@@ -171,6 +183,7 @@ PipelineInterestsAdaptive::sendInterest(uint64_t segNo, bool isRetransmission)
 
   m_nInFlight++;
   m_nSent++;
+  traceSegment(isRetransmission ? SegmentEventType::Retransmitted : SegmentEventType::Sent, segNo);
 
   if (isRetransmission) {
     segInfo.state = SegmentState::Retransmitted;
@@ -179,6 +192,9 @@ PipelineInterestsAdaptive::sendInterest(uint64_t segNo, bool isRetransmission)
   else {
     m_highInterest = segNo;
     segInfo.state = SegmentState::FirstTimeSent;
+    if (m_options.fecBlockSize > 0 && segNo % m_options.fecBlockSize == 0) {
+      requestParity(segNo / m_options.fecBlockSize);
+    }
   }
 }
 
@@ -186,6 +202,9 @@ void
 PipelineInterestsAdaptive::schedulePackets()
 {
   BOOST_ASSERT(m_nInFlight >= 0);
+  if (m_isPacing)
+    return;
+
   auto availableWindowSize = static_cast<int64_t>(m_cwnd) - m_nInFlight;
 
   while (availableWindowSize > 0) {
@@ -215,6 +234,12 @@ PipelineInterestsAdaptive::handleData(const Interest& interest, const Data& data
   // Interest was expressed with CanBePrefix=false
   BOOST_ASSERT(data.getName().equals(interest.getName()));
 
+  handleSegment(data, false);
+}
+
+void
+PipelineInterestsAdaptive::handleSegment(const Data& data, bool isRecovered)
+{
   if (!m_hasFinalBlockId && data.getFinalBlock()) {
     m_lastSegmentNo = data.getFinalBlock()->toSegment();
     m_hasFinalBlockId = true;
@@ -235,39 +260,39 @@ PipelineInterestsAdaptive::handleData(const Interest& interest, const Data& data
   }
 
   SegmentInfo& segInfo = segIt->second;
-  time::nanoseconds rtt = time::steady_clock::now() - segInfo.timeSent;
+  auto now = time::steady_clock::now();
+  time::nanoseconds rtt = now - segInfo.timeSent;
+  if (m_lastDataTime != time::steady_clock::TimePoint()) {
+    m_interArrivalHistogram.record(now - m_lastDataTime);
+  }
+  m_lastDataTime = now;
+  traceSegment(SegmentEventType::Received, recvSegNo);
   if (m_options.isVerbose) {
     std::cerr << "Received segment #" << recvSegNo
               << ", rtt=" << rtt.count() / 1e6 << "ms"
               << ", rto=" << segInfo.rto.count() / 1e6 << "ms" << std::endl;
   }
 
-  if (m_highData < recvSegNo) {
-    m_highData = recvSegNo;
-  }
-
   // for segments in retx queue, we must not decrement m_nInFlight
   // because it was already decremented when the segment timed out
   if (segInfo.state != SegmentState::InRetxQueue) {
     m_nInFlight--;
   }
 
+  m_congestionProcessor.onData(recvSegNo, m_highInterest);
+
   // upon finding congestion mark, decrease the window size
   // without retransmitting any packet
-  if (data.getCongestionMark() > 0) {
+  if (isRecovered) {
+    // the segment was lost or late, this is not a sign of available capacity
+  }
+  else if (data.getCongestionMark() > 0) {
     m_nCongMarks++;
     if (!m_options.ignoreCongMarks) {
-      if (m_options.disableCwa || m_highData > m_recPoint) {
-        m_recPoint = m_highInterest;  // react to only one congestion event (timeout or congestion mark)
-                                      // per RTT (conservative window adaptation)
-        m_nMarkDecr++;
-        decreaseWindow();
-
-        if (m_options.isVerbose) {
-          std::cerr << "Received congestion mark, value = " << data.getCongestionMark()
-                    << ", new cwnd = " << m_cwnd << std::endl;
-        }
+      if (m_options.isVerbose) {
+        std::cerr << "Received congestion mark, value = " << data.getCongestionMark() << std::endl;
       }
+      handleCongestionSignal(CongestionSignal::CongestionMark, recvSegNo);
     }
     else {
       increaseWindow();
@@ -279,13 +304,15 @@ PipelineInterestsAdaptive::handleData(const Interest& interest, const Data& data
 
   onData(data);
 
-  // do not sample RTT for retransmitted segments
-  if ((segInfo.state == SegmentState::FirstTimeSent ||
+  // do not sample RTT for retransmitted or recovered segments
+  if (!isRecovered &&
+      (segInfo.state == SegmentState::FirstTimeSent ||
        segInfo.state == SegmentState::InRetxQueue) &&
       m_retxCount.count(recvSegNo) == 0) {
     auto nExpectedSamples = std::max<int64_t>((m_nInFlight + 1) >> 1, 1);
     BOOST_ASSERT(nExpectedSamples > 0);
     m_rttEstimator.addMeasurement(rtt, static_cast<size_t>(nExpectedSamples));
+    m_rttHistogram.record(rtt);
     afterRttMeasurement({recvSegNo, rtt,
                          m_rttEstimator.getSmoothedRtt(),
                          m_rttEstimator.getRttVariation(),
@@ -295,15 +322,106 @@ PipelineInterestsAdaptive::handleData(const Interest& interest, const Data& data
   // remove the entry associated with the received segment
   m_segmentInfo.erase(segIt);
 
+  const uint64_t blockNo = m_options.fecBlockSize > 0 ? recvSegNo / m_options.fecBlockSize : 0;
+  if (m_options.fecBlockSize > 0) {
+    auto& block = m_fecBlocks[blockNo];
+    block.segments.emplace(recvSegNo, data.wireEncode());
+    if (block.segments.size() >= getFecBlockLength(blockNo)) {
+      m_fecBlocks.erase(blockNo);
+    }
+  }
+
   if (allSegmentsReceived()) {
     cancel();
     if (!m_options.isQuiet) {
       printSummary();
     }
+    return;
   }
-  else {
-    schedulePackets();
+
+  schedulePackets();
+
+  if (m_options.fecBlockSize > 0) {
+    tryRecover(blockNo);
+  }
+}
+
+void
+PipelineInterestsAdaptive::requestParity(uint64_t blockNo)
+{
+  auto interest = Interest()
+                  .setName(makeParityName(m_prefix, blockNo))
+                  .setCanBePrefix(false)
+                  .setMustBeFresh(m_options.mustBeFresh)
+                  .setInterestLifetime(m_options.interestLifetime);
+
+  // parity segments are best-effort: a missing one is never retransmitted
+  m_fecBlocks[blockNo].parityHdl = m_face.expressInterest(interest,
+    [this, blockNo] (const Interest&, const Data& data) { handleParity(blockNo, data); },
+    [] (const Interest&, const lp::Nack&) {},
+    [] (const Interest&) {});
+}
+
+void
+PipelineInterestsAdaptive::handleParity(uint64_t blockNo, const Data& data)
+{
+  if (isStopping())
+    return;
+
+  auto it = m_fecBlocks.find(blockNo);
+  if (it == m_fecBlocks.end())
+    return;
+
+  m_nParityReceived++;
+  it->second.parity = data.getContent();
+  tryRecover(blockNo);
+}
+
+void
+PipelineInterestsAdaptive::tryRecover(uint64_t blockNo)
+{
+  auto it = m_fecBlocks.find(blockNo);
+  if (it == m_fecBlocks.end() || !it->second.parity.isValid())
+    return;
+
+  const FecBlock& block = it->second;
+  if (block.segments.size() + 1 != getFecBlockLength(blockNo))
+    return;
+
+  uint64_t missingSegNo = blockNo * m_options.fecBlockSize;
+  while (block.segments.count(missingSegNo) > 0) {
+    ++missingSegNo;
   }
+  if (m_segmentInfo.count(missingSegNo) == 0)
+    return;
+
+  std::vector<Block> others;
+  for (const auto& entry : block.segments) {
+    others.push_back(entry.second);
+  }
+  auto data = recoverSegment(block.parity, others);
+  if (data == nullptr || data->getName() != Name(m_prefix).appendSegment(missingSegNo)) {
+    if (m_options.isVerbose)
+      std::cerr << "Cannot rebuild segment #" << missingSegNo << " from parity" << std::endl;
+    // the block cannot be repaired, wait for retransmissions
+    m_fecBlocks.erase(it);
+    return;
+  }
+
+  m_nRecovered++;
+  if (m_options.isVerbose)
+    std::cerr << "Rebuilt segment #" << missingSegNo << " from parity" << std::endl;
+  handleSegment(*data, true);
+}
+
+uint64_t
+PipelineInterestsAdaptive::getFecBlockLength(uint64_t blockNo) const
+{
+  const uint64_t first = blockNo * m_options.fecBlockSize;
+  if (m_hasFinalBlockId && m_lastSegmentNo < first + m_options.fecBlockSize) {
+    return m_lastSegmentNo >= first ? m_lastSegmentNo - first + 1 : 0;
+  }
+  return m_options.fecBlockSize;
 }
 
 void
@@ -317,15 +435,16 @@ PipelineInterestsAdaptive::handleNack(const Interest& interest, const lp::Nack&
               << " for Interest " << interest << std::endl;
 
   uint64_t segNo = getSegmentFromPacket(interest);
+  traceSegment(SegmentEventType::Nack, segNo);
 
   switch (nack.getReason()) {
     case lp::NackReason::DUPLICATE:
       // ignore duplicates
       break;
     case lp::NackReason::CONGESTION:
-      // treated the same as timeout for now
+      m_nCongNacks++;
       enqueueForRetransmission(segNo);
-      recordTimeout();
+      handleCongestionSignal(CongestionSignal::CongestionNack, segNo);
       schedulePackets();
       break;
     default:
@@ -341,28 +460,57 @@ PipelineInterestsAdaptive::handleLifetimeExpiration(const Interest& interest)
   if (isStopping())
     return;
 
+  uint64_t segNo = getSegmentFromPacket(interest);
   m_nTimeouts++;
-  enqueueForRetransmission(getSegmentFromPacket(interest));
-  recordTimeout();
+  traceSegment(SegmentEventType::Timeout, segNo);
+  enqueueForRetransmission(segNo);
+  handleCongestionSignal(CongestionSignal::Timeout, segNo);
   schedulePackets();
 }
 
 void
-PipelineInterestsAdaptive::recordTimeout()
+PipelineInterestsAdaptive::handleCongestionSignal(CongestionSignal signal, uint64_t segNo)
 {
-  if (m_options.disableCwa || m_highData > m_recPoint) {
-    // react to only one timeout per RTT (conservative window adaptation)
-    m_recPoint = m_highInterest;
+  auto decision = m_congestionProcessor.onCongestionSignal(signal, segNo, m_highInterest);
 
+  if (decision.shouldDecreaseWindow) {
     decreaseWindow();
+    switch (signal) {
+      case CongestionSignal::Timeout:
+        m_nLossDecr++;
+        break;
+      case CongestionSignal::CongestionNack:
+        m_nNackDecr++;
+        break;
+      case CongestionSignal::CongestionMark:
+        m_nMarkDecr++;
+        break;
+    }
+  }
+
+  if (decision.shouldBackoffRto) {
     m_rttEstimator.backoffRto();
-    m_nLossDecr++;
+  }
 
-    if (m_options.isVerbose) {
-      std::cerr << "Packet loss event, new cwnd = " << m_cwnd
-                << ", ssthresh = " << m_ssthresh << std::endl;
+  if (decision.pacingDelay > 0_ms) {
+    // congestion Nacks keep arriving round after round, hold back all new Interests
+    m_isPacing = true;
+    m_pacingEvent = m_scheduler.schedule(decision.pacingDelay, [this] {
+      m_isPacing = false;
+      schedulePackets();
+    });
+  }
+
+  if (m_options.isVerbose && (decision.shouldDecreaseWindow || decision.pacingDelay > 0_ms)) {
+    std::cerr << "Congestion event (" << signal << "), new cwnd = " << m_cwnd
+              << ", ssthresh = " << m_ssthresh;
+    if (decision.pacingDelay > 0_ms) {
+      std::cerr << ", sending paused for " << decision.pacingDelay;
     }
+    std::cerr << std::endl;
   }
+
+  afterCongestionDecision(decision);
 }
 
 void
@@ -429,6 +577,9 @@ PipelineInterestsAdaptive::printOptions() const
       << "\tConservative window adaptation = " << (m_options.disableCwa ? "no" : "yes") << "\n"
       << "\tResetting window to " << (m_options.resetCwndToInit ?
                                         "initial value" : "ssthresh") << " upon loss event\n";
+  if (m_options.fecBlockSize > 0) {
+    std::cerr << "\tParity block size = " << m_options.fecBlockSize << "\n";
+  }
 }
 
 void
@@ -437,21 +588,86 @@ PipelineInterestsAdaptive::printSummary() const
   PipelineInterests::printSummary();
   std::cerr << "Congestion marks: " << m_nCongMarks << " (caused " << m_nMarkDecr << " window decreases)\n"
             << "Timeouts: " << m_nTimeouts << " (caused " << m_nLossDecr << " window decreases)\n"
+            << "Congestion Nacks: " << m_nCongNacks << " (caused " << m_nNackDecr << " window decreases)\n"
             << "Retransmitted segments: " << m_nRetransmitted
             << " (" << (m_nSent == 0 ? 0 : (m_nRetransmitted * 100.0 / m_nSent)) << "%)"
-            << ", skipped: " << m_nSkippedRetx << "\n"
-            << "RTT ";
+            << ", skipped: " << m_nSkippedRetx << "\n";
+  if (m_options.fecBlockSize > 0) {
+    std::cerr << "Rebuilt segments: " << m_nRecovered
+              << " (from " << m_nParityReceived << " parity segments)\n";
+  }
+  std::cerr << "RTT ";
 
   if (m_rttEstimator.getMinRtt() == time::nanoseconds::max() ||
       m_rttEstimator.getMaxRtt() == time::nanoseconds::min()) {
     std::cerr << "stats unavailable\n";
   }
   else {
+    boost::io::ios_flags_saver flagsSaver(std::cerr);
+    boost::io::ios_precision_saver precisionSaver(std::cerr);
     std::cerr << "min/avg/max = " << std::fixed << std::setprecision(3)
               << m_rttEstimator.getMinRtt().count() / 1e6 << "/"
               << m_rttEstimator.getAvgRtt().count() / 1e6 << "/"
               << m_rttEstimator.getMaxRtt().count() / 1e6 << " ms\n";
   }
+
+  printPercentiles("RTT", m_rttHistogram);
+  printPercentiles("Inter-arrival gap", m_interArrivalHistogram);
+}
+
+void
+PipelineInterestsAdaptive::printPercentiles(const std::string& what, const LatencyHistogram& histogram)
+{
+  if (histogram.getCount() == 0)
+    return;
+
+  boost::io::ios_flags_saver flagsSaver(std::cerr);
+  boost::io::ios_precision_saver precisionSaver(std::cerr);
+  std::cerr << what << " p50/p90/p99/p99.9 = " << std::fixed << std::setprecision(3)
+            << histogram.getPercentile(50).count() / 1e6 << "/"
+            << histogram.getPercentile(90).count() / 1e6 << "/"
+            << histogram.getPercentile(99).count() / 1e6 << "/"
+            << histogram.getPercentile(99.9).count() / 1e6 << " ms\n";
+}
+
+void
+PipelineInterestsAdaptive::printProgress(std::ostream& os) const
+{
+  PipelineInterests::printProgress(os);
+  os << "ndncatchunks_cwnd " << m_cwnd << "\n"
+     << "ndncatchunks_ssthresh " << m_ssthresh << "\n"
+     << "ndncatchunks_in_flight " << m_nInFlight << "\n"
+     << "ndncatchunks_retx_queue_length " << m_retxQueue.size() << "\n"
+     << "ndncatchunks_interests_sent " << m_nSent << "\n"
+     << "ndncatchunks_retransmissions " << m_nRetransmitted << "\n"
+     << "ndncatchunks_retransmission_ratio "
+     << (m_nSent == 0 ? 0 : static_cast<double>(m_nRetransmitted) / m_nSent) << "\n"
+     << "ndncatchunks_timeouts " << m_nTimeouts << "\n"
+     << "ndncatchunks_congestion_marks " << m_nCongMarks << "\n"
+     << "ndncatchunks_congestion_nacks " << m_nCongNacks << "\n"
+     << "ndncatchunks_window_decreases " << m_nLossDecr + m_nMarkDecr + m_nNackDecr << "\n"
+     << "ndncatchunks_rto_seconds " << m_rttEstimator.getEstimatedRto().count() / 1e9 << "\n";
+
+  if (m_options.fecBlockSize > 0) {
+    os << "ndncatchunks_fec_parity_received " << m_nParityReceived << "\n"
+       << "ndncatchunks_fec_rebuilt_segments " << m_nRecovered << "\n";
+  }
+
+  if (m_rttEstimator.getMinRtt() != time::nanoseconds::max() &&
+      m_rttEstimator.getMaxRtt() != time::nanoseconds::min()) {
+    os << "ndncatchunks_rtt_smoothed_seconds " << m_rttEstimator.getSmoothedRtt().count() / 1e9 << "\n"
+       << "ndncatchunks_rtt_min_seconds " << m_rttEstimator.getMinRtt().count() / 1e9 << "\n"
+       << "ndncatchunks_rtt_avg_seconds " << m_rttEstimator.getAvgRtt().count() / 1e9 << "\n"
+       << "ndncatchunks_rtt_max_seconds " << m_rttEstimator.getMaxRtt().count() / 1e9 << "\n";
+  }
+
+  if (m_rttHistogram.getCount() > 0) {
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+      os << "ndncatchunks_rtt_seconds{quantile=\"" << q << "\"} "
+         << m_rttHistogram.getPercentile(q * 100).count() / 1e9 << "\n";
+    }
+    os << "ndncatchunks_rtt_seconds_count " << m_rttHistogram.getCount() << "\n";
+  }
 }
 
 std::ostream&
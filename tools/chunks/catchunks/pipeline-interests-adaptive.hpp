@@ -29,11 +29,14 @@
 #ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_ADAPTIVE_HPP
 #define NDN_TOOLS_CHUNKS_CATCHUNKS_PIPELINE_INTERESTS_ADAPTIVE_HPP
 
+#include "congestion-signal-processor.hpp"
+#include "latency-histogram.hpp"
 #include "pipeline-interests.hpp"
 
 #include <ndn-cxx/util/rtt-estimator.hpp>
 #include <ndn-cxx/util/signal.hpp>
 
+#include <map>
 #include <queue>
 #include <unordered_map>
 
@@ -65,6 +68,16 @@ struct SegmentInfo
   SegmentState state;
 };
 
+/**
+ * @brief Parity segment and received segments of a block, kept until the block is complete
+ */
+struct FecBlock
+{
+  ScopedPendingInterestHandle parityHdl;
+  Block parity; ///< payload of the parity segment; invalid until it is received
+  std::map<uint64_t, Block> segments; ///< wire encodings of the received segments
+};
+
 /**
  * @brief Service for retrieving Data via an Interest pipeline
  *
@@ -73,6 +86,11 @@ struct SegmentInfo
  * please refer to the description in section "Interest pipeline types in ndncatchunks" of
  * tools/chunks/README.md
  *
+ * If Options::fecBlockSize is set, the parity segment of each block is requested together with
+ * the first segment of the block, outside of the congestion window. As soon as all segments
+ * of a block but one have arrived, the missing one is rebuilt from the parity instead of
+ * waiting for it to be retransmitted.
+ *
  * Provides retrieved Data on arrival with no ordering guarantees. Data is delivered to the
  * PipelineInterests' user via callback immediately upon arrival.
  */
@@ -111,6 +129,32 @@ public:
    */
   util::Signal<PipelineInterestsAdaptive, RttSample> afterRttMeasurement;
 
+  /**
+   * @brief Signals when the pipeline has reacted to a timeout, congestion Nack, or congestion mark.
+   */
+  util::Signal<PipelineInterestsAdaptive, CongestionDecision> afterCongestionDecision;
+
+  void
+  printProgress(std::ostream& os) const final;
+
+  /**
+   * @brief Returns the distribution of RTT samples taken so far.
+   */
+  const LatencyHistogram&
+  getRttHistogram() const
+  {
+    return m_rttHistogram;
+  }
+
+  /**
+   * @brief Returns the distribution of gaps between the arrivals of two consecutive Data packets.
+   */
+  const LatencyHistogram&
+  getInterArrivalHistogram() const
+  {
+    return m_interArrivalHistogram;
+  }
+
 protected:
   DECLARE_SIGNAL_EMIT(afterCwndChange)
 
@@ -166,14 +210,41 @@ private:
   void
   handleData(const Interest& interest, const Data& data);
 
+  /**
+   * @param isRecovered true if @p data was rebuilt from a parity segment, in which case it
+   *                    neither grows the window nor yields an RTT sample
+   */
+  void
+  handleSegment(const Data& data, bool isRecovered);
+
+  void
+  requestParity(uint64_t blockNo);
+
+  void
+  handleParity(uint64_t blockNo, const Data& data);
+
+  /**
+   * @brief Rebuild the missing segment of block @p blockNo, if possible
+   */
+  void
+  tryRecover(uint64_t blockNo);
+
+  uint64_t
+  getFecBlockLength(uint64_t blockNo) const;
+
   void
   handleNack(const Interest& interest, const lp::Nack& nack);
 
   void
   handleLifetimeExpiration(const Interest& interest);
 
+  /**
+   * @brief React to a congestion signal as decided by the congestion signal processor.
+   *
+   * Decreases the window, backs off the RTO, and pauses sending as needed.
+   */
   void
-  recordTimeout();
+  handleCongestionSignal(CongestionSignal signal, uint64_t segNo);
 
   void
   enqueueForRetransmission(uint64_t segNo);
@@ -188,6 +259,9 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   printSummary() const final;
 
+  static void
+  printPercentiles(const std::string& what, const LatencyHistogram& histogram);
+
 PUBLIC_WITH_TESTS_ELSE_PROTECTED:
   static constexpr double MIN_SSTHRESH = 2.0;
 
@@ -199,10 +273,11 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   Scheduler m_scheduler;
   scheduler::ScopedEventId m_checkRtoEvent;
 
-  uint64_t m_highData; ///< the highest segment number of the Data packet the consumer has received so far
   uint64_t m_highInterest; ///< the highest segment number of the Interests the consumer has sent so far
-  uint64_t m_recPoint; ///< the value of m_highInterest when a packet loss event occurred,
-                       ///< it remains fixed until the next packet loss event happens
+
+  CongestionSignalProcessor m_congestionProcessor;
+  scheduler::ScopedEventId m_pacingEvent;
+  bool m_isPacing; ///< true if sending is paused after repeated congestion Nacks
 
   int64_t m_nInFlight; ///< # of segments in flight
   int64_t m_nLossDecr; ///< # of window decreases caused by packet loss
@@ -212,7 +287,15 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
                           ///< retransmission occurred
   int64_t m_nRetransmitted; ///< # of retransmitted segments
   int64_t m_nCongMarks; ///< # of data packets with congestion mark
+  int64_t m_nCongNacks; ///< # of Nacks with reason Congestion
+  int64_t m_nNackDecr; ///< # of window decreases caused by congestion Nacks
   int64_t m_nSent; ///< # of interest packets sent out (including retransmissions)
+  int64_t m_nParityReceived; ///< # of parity segments received
+  int64_t m_nRecovered; ///< # of segments rebuilt from parity segments
+
+  LatencyHistogram m_rttHistogram;
+  LatencyHistogram m_interArrivalHistogram;
+  time::steady_clock::TimePoint m_lastDataTime; ///< arrival time of the previous Data packet
 
   std::unordered_map<uint64_t, SegmentInfo> m_segmentInfo; ///< keeps all the internal information
                                                            ///< on sent but not acked segments
@@ -220,6 +303,7 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
                                                  ///< if the count reaches to the maximum number of
                                                  ///< timeout/nack retries, the pipeline will be aborted
   std::queue<uint64_t> m_retxQueue;
+  std::unordered_map<uint64_t, FecBlock> m_fecBlocks; ///< incomplete blocks, by block number
 
   bool m_hasFailure;
   uint64_t m_failedSegNo;
@@ -30,14 +30,16 @@
 #include "pipeline-interests-fixed.hpp"
 #include "data-fetcher.hpp"
 
+#include <cmath>
+
 namespace ndn {
 namespace chunks {
 
 PipelineInterestsFixed::PipelineInterestsFixed(Face& face, const Options& opts)
   : PipelineInterests(face, opts)
+  , m_scheduler(m_face.getIoService())
+  , m_slots(m_options.maxPipelineSize)
 {
-  m_segmentFetchers.resize(m_options.maxPipelineSize);
-
   if (m_options.isVerbose) {
     printOptions();
     std::cerr << "\tPipeline size = " << m_options.maxPipelineSize << "\n";
@@ -81,44 +83,65 @@ PipelineInterestsFixed::fetchNextSegment(std::size_t pipeNo)
   if (m_options.isVerbose)
     std::cerr << "Requesting segment #" << nextSegmentNo << std::endl;
 
+  FetchSlot& slot = m_slots[pipeNo];
+  BOOST_ASSERT(!slot.isRunning());
+  slot.segNo = nextSegmentNo;
+  slot.nNacks = 0;
+  slot.nTimeouts = 0;
+  slot.nCongestionRetries = 0;
+  slot.state = FetchState::Running;
+  expressInterest(pipeNo, false);
+
+  return true;
+}
+
+void
+PipelineInterestsFixed::expressInterest(size_t pipeNo, bool isRetransmission)
+{
+  FetchSlot& slot = m_slots[pipeNo];
+  traceSegment(isRetransmission ? SegmentEventType::Retransmitted : SegmentEventType::Sent, slot.segNo);
+
   auto interest = Interest()
-                  .setName(Name(m_prefix).appendSegment(nextSegmentNo))
+                  .setName(Name(m_prefix).appendSegment(slot.segNo))
                   .setCanBePrefix(false)
                   .setMustBeFresh(m_options.mustBeFresh)
                   .setInterestLifetime(m_options.interestLifetime);
 
-  auto fetcher = DataFetcher::fetch(m_face, interest,
-                                    m_options.maxRetriesOnTimeoutOrNack,
-                                    m_options.maxRetriesOnTimeoutOrNack,
-                                    bind(&PipelineInterestsFixed::handleData, this, _1, _2, pipeNo),
-                                    bind(&PipelineInterestsFixed::handleFail, this, _2, pipeNo),
-                                    bind(&PipelineInterestsFixed::handleFail, this, _2, pipeNo),
-                                    m_options.isVerbose);
-
-  BOOST_ASSERT(!m_segmentFetchers[pipeNo].first || !m_segmentFetchers[pipeNo].first->isRunning());
-  m_segmentFetchers[pipeNo] = make_pair(fetcher, nextSegmentNo);
+  // the previous Interest of this slot (if any) has already been satisfied, Nacked, or timed out
+  slot.pendingInterest.release();
+  slot.pendingInterest = m_face.expressInterest(interest,
+    [this, pipeNo] (const Interest& i, const Data& d) { handleData(i, d, pipeNo); },
+    [this, pipeNo] (const Interest& i, const lp::Nack& n) { handleNack(i, n, pipeNo); },
+    [this, pipeNo] (const Interest& i) { handleTimeout(i, pipeNo); });
+}
 
-  return true;
+void
+PipelineInterestsFixed::cancelSlot(FetchSlot& slot)
+{
+  if (slot.isRunning()) {
+    slot.state = FetchState::Stopped;
+    slot.pendingInterest.cancel();
+    slot.retryEvent.cancel();
+  }
 }
 
 void
 PipelineInterestsFixed::doCancel()
 {
-  for (auto& fetcher : m_segmentFetchers) {
-    if (fetcher.first)
-      fetcher.first->cancel();
+  for (auto& slot : m_slots) {
+    cancelSlot(slot);
   }
-
-  m_segmentFetchers.clear();
 }
 
 void
 PipelineInterestsFixed::handleData(const Interest& interest, const Data& data, size_t pipeNo)
 {
-  if (isStopping())
+  if (isStopping() || !m_slots[pipeNo].isRunning())
     return;
 
   BOOST_ASSERT(data.getName().equals(interest.getName()));
+  m_slots[pipeNo].state = FetchState::Stopped;
+  traceSegment(SegmentEventType::Received, m_slots[pipeNo].segNo);
 
   if (m_options.isVerbose)
     std::cerr << "Received segment #" << getSegmentFromPacket(data) << std::endl;
@@ -168,17 +191,17 @@ PipelineInterestsFixed::handleData(const Interest& interest, const Data& data, s
     m_lastSegmentNo = data.getFinalBlock()->toSegment();
     m_hasFinalBlockId = true;
 
-    for (auto& fetcher : m_segmentFetchers) {
-      if (fetcher.first == nullptr)
+    for (auto& slot : m_slots) {
+      if (slot.state == FetchState::Idle)
         continue;
 
-      if (fetcher.second > m_lastSegmentNo) {
+      if (slot.segNo > m_lastSegmentNo) {
         // stop trying to fetch segments that are beyond m_lastSegmentNo
-        fetcher.first->cancel();
+        cancelSlot(slot);
       }
-      else if (fetcher.first->hasError()) { // fetcher.second <= m_lastSegmentNo
+      else if (slot.hasError()) { // slot.segNo <= m_lastSegmentNo
         // there was an error while fetching a segment that is part of the content
-        return onFailure("Failure retrieving segment #" + to_string(fetcher.second));
+        return onFailure("Failure retrieving segment #" + to_string(slot.segNo));
       }
     }
   }
@@ -193,26 +216,104 @@ PipelineInterestsFixed::handleData(const Interest& interest, const Data& data, s
   }
 }
 
-void PipelineInterestsFixed::handleFail(const std::string& reason, std::size_t pipeNo)
+void
+PipelineInterestsFixed::handleNack(const Interest& interest, const lp::Nack& nack, size_t pipeNo)
+{
+  FetchSlot& slot = m_slots[pipeNo];
+  if (isStopping() || !slot.isRunning())
+    return;
+
+  traceSegment(SegmentEventType::Nack, slot.segNo);
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE)
+    ++slot.nNacks;
+
+  if (m_options.isVerbose)
+    std::cerr << "Received Nack with reason " << nack.getReason()
+              << " for Interest " << interest << std::endl;
+
+  if (slot.nNacks > m_options.maxRetriesOnTimeoutOrNack &&
+      m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE) {
+    slot.state = FetchState::Failed;
+    return handleFail("Reached the maximum number of nack retries (" +
+                      to_string(m_options.maxRetriesOnTimeoutOrNack) +
+                      ") while retrieving data for " + interest.getName().toUri(), pipeNo);
+  }
+
+  switch (nack.getReason()) {
+    case lp::NackReason::DUPLICATE: {
+      expressInterest(pipeNo, true);
+      break;
+    }
+    case lp::NackReason::CONGESTION: {
+      time::milliseconds backoffTime(static_cast<uint64_t>(std::pow(2, slot.nCongestionRetries)));
+      if (backoffTime > DataFetcher::MAX_CONGESTION_BACKOFF_TIME) {
+        backoffTime = DataFetcher::MAX_CONGESTION_BACKOFF_TIME;
+      }
+      else {
+        slot.nCongestionRetries++;
+      }
+      slot.retryEvent = m_scheduler.schedule(backoffTime, [this, pipeNo] {
+        expressInterest(pipeNo, true);
+      });
+      break;
+    }
+    default: {
+      slot.state = FetchState::Failed;
+      handleFail("Could not retrieve data for " + interest.getName().toUri() +
+                 ", reason: " + boost::lexical_cast<std::string>(nack.getReason()), pipeNo);
+      break;
+    }
+  }
+}
+
+void
+PipelineInterestsFixed::handleTimeout(const Interest& interest, size_t pipeNo)
+{
+  FetchSlot& slot = m_slots[pipeNo];
+  if (isStopping() || !slot.isRunning())
+    return;
+
+  traceSegment(SegmentEventType::Timeout, slot.segNo);
+  if (m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE)
+    ++slot.nTimeouts;
+
+  if (m_options.isVerbose)
+    std::cerr << "Timeout for Interest " << interest << std::endl;
+
+  if (slot.nTimeouts > m_options.maxRetriesOnTimeoutOrNack &&
+      m_options.maxRetriesOnTimeoutOrNack != DataFetcher::MAX_RETRIES_INFINITE) {
+    slot.state = FetchState::Failed;
+    return handleFail("Reached the maximum number of timeout retries (" +
+                      to_string(m_options.maxRetriesOnTimeoutOrNack) +
+                      ") while retrieving data for " + interest.getName().toUri(), pipeNo);
+  }
+
+  expressInterest(pipeNo, true);
+}
+
+void
+PipelineInterestsFixed::handleFail(const std::string& reason, std::size_t pipeNo)
 {
   if (isStopping())
     return;
 
+  const uint64_t failedSegNo = m_slots[pipeNo].segNo;
+
   // if the failed segment is definitely part of the content, raise a fatal error
-  if (m_hasFinalBlockId && m_segmentFetchers[pipeNo].second <= m_lastSegmentNo)
+  if (m_hasFinalBlockId && failedSegNo <= m_lastSegmentNo)
     return onFailure(reason);
 
   if (!m_hasFinalBlockId) {
     bool areAllFetchersStopped = true;
-    for (auto& fetcher : m_segmentFetchers) {
-      if (fetcher.first == nullptr)
+    for (auto& slot : m_slots) {
+      if (slot.state == FetchState::Idle)
         continue;
 
       // cancel fetching all segments that follow
-      if (fetcher.second > m_segmentFetchers[pipeNo].second) {
-        fetcher.first->cancel();
+      if (slot.segNo > failedSegNo) {
+        cancelSlot(slot);
       }
-      else if (fetcher.first->isRunning()) { // fetcher.second <= m_segmentFetchers[pipeNo].second
+      else if (slot.isRunning()) { // slot.segNo <= failedSegNo
         areAllFetchersStopped = false;
       }
     }
@@ -36,8 +36,6 @@
 namespace ndn {
 namespace chunks {
 
-class DataFetcher;
-
 /**
  * @brief Service for retrieving Data via an Interest pipeline
  *
@@ -47,6 +45,10 @@ class DataFetcher;
  *
  * No guarantees are made as to the order in which segments are fetched or callbacks are invoked,
  * i.e. out-of-order delivery is possible.
+ *
+ * Each pipeline element owns a preallocated fetch slot that is reused for every segment it
+ * retrieves, and all retransmission timers share a single scheduler, so no per-segment fetcher
+ * objects are created during the transfer.
  */
 class PipelineInterestsFixed final : public PipelineInterests
 {
@@ -55,6 +57,40 @@ public:
 
   ~PipelineInterestsFixed() final;
 
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  enum class FetchState {
+    Idle,    ///< the slot has not been used yet
+    Running, ///< an Interest for the slot's segment is pending or waiting to be retransmitted
+    Stopped, ///< the segment was received or fetching was cancelled
+    Failed,  ///< the maximum number of retries was reached
+  };
+
+  /**
+   * @brief state of the segment currently being fetched by one pipeline element
+   */
+  struct FetchSlot
+  {
+    bool
+    isRunning() const
+    {
+      return state == FetchState::Running;
+    }
+
+    bool
+    hasError() const
+    {
+      return state == FetchState::Failed;
+    }
+
+    ScopedPendingInterestHandle pendingInterest;
+    scheduler::ScopedEventId retryEvent;
+    uint64_t segNo = 0;
+    int nNacks = 0;
+    int nTimeouts = 0;
+    uint32_t nCongestionRetries = 0;
+    FetchState state = FetchState::Idle;
+  };
+
 private:
   /**
    * @brief fetch all the segments between 0 and m_lastSegmentNo
@@ -76,14 +112,30 @@ private:
   bool
   fetchNextSegment(size_t pipeNo);
 
+  /**
+   * @brief express an Interest for the segment assigned to pipeline element @p pipeNo
+   */
+  void
+  expressInterest(size_t pipeNo, bool isRetransmission);
+
+  void
+  cancelSlot(FetchSlot& slot);
+
   void
   handleData(const Interest& interest, const Data& data, size_t pipeNo);
 
+  void
+  handleNack(const Interest& interest, const lp::Nack& nack, size_t pipeNo);
+
+  void
+  handleTimeout(const Interest& interest, size_t pipeNo);
+
   void
   handleFail(const std::string& reason, size_t pipeNo);
 
-private:
-  std::vector<std::pair<shared_ptr<DataFetcher>, uint64_t>> m_segmentFetchers;
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  Scheduler m_scheduler;
+  std::vector<FetchSlot> m_slots; ///< one slot per pipeline element, allocated once
 
   /**
    * true if one or more segment fetchers encountered an error; if m_hasFinalBlockId
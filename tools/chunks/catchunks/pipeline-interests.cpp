@@ -30,6 +30,7 @@
 
 #include "pipeline-interests.hpp"
 #include "data-fetcher.hpp"
+#include "tools/chunks/common/segment-codec.hpp"
 
 #include <boost/asio/io_service.hpp>
 
@@ -43,6 +44,7 @@ PipelineInterests::PipelineInterests(Face& face, const Options& opts)
   , m_lastSegmentNo(0)
   , m_nReceived(0)
   , m_receivedSize(0)
+  , m_transferredSize(0)
   , m_nextSegmentNo(0)
   , m_isStopping(false)
 {
@@ -95,7 +97,8 @@ void
 PipelineInterests::onData(const Data& data)
 {
   m_nReceived++;
-  m_receivedSize += data.getContent().value_size();
+  m_receivedSize += getDecodedSize(data);
+  m_transferredSize += data.getContent().value_size();
 
   m_onData(data);
 }
@@ -133,8 +136,32 @@ PipelineInterests::printSummary() const
   std::cerr << "\n\nAll segments have been received.\n"
             << "Time elapsed: " << timeElapsed << "\n"
             << "Segments received: " << m_nReceived << "\n"
-            << "Transferred size: " << m_receivedSize / 1e3 << " kB" << "\n"
-            << "Goodput: " << formatThroughput(throughput) << "\n";
+            << "Transferred size: " << m_transferredSize / 1e3 << " kB" << "\n";
+  if (m_transferredSize != m_receivedSize) {
+    std::cerr << "Decompressed size: " << m_receivedSize / 1e3 << " kB" << "\n";
+  }
+  std::cerr << "Goodput: " << formatThroughput(throughput) << "\n";
+}
+
+void
+PipelineInterests::printProgress(std::ostream& os) const
+{
+  using namespace ndn::time;
+  duration<double, seconds::period> timeElapsed{0};
+  if (m_startTime != steady_clock::TimePoint()) {
+    timeElapsed = steady_clock::now() - m_startTime;
+  }
+  double throughput = timeElapsed.count() > 0 ? 8 * m_receivedSize / timeElapsed.count() : 0;
+
+  os << "ndncatchunks_elapsed_seconds " << timeElapsed.count() << "\n"
+     << "ndncatchunks_segments_received " << m_nReceived << "\n"
+     << "ndncatchunks_bytes_received " << m_receivedSize << "\n"
+     << "ndncatchunks_bytes_transferred " << m_transferredSize << "\n"
+     << "ndncatchunks_goodput_bits_per_second " << throughput << "\n"
+     << "ndncatchunks_finished " << isFinished() << "\n";
+  if (m_hasFinalBlockId) {
+    os << "ndncatchunks_last_segment " << m_lastSegmentNo << "\n";
+  }
 }
 
 std::string
@@ -160,5 +187,28 @@ PipelineInterests::formatThroughput(double throughput)
   return "";
 }
 
+std::ostream&
+operator<<(std::ostream& os, SegmentEventType type)
+{
+  switch (type) {
+  case SegmentEventType::Sent:
+    os << "Sent";
+    break;
+  case SegmentEventType::Received:
+    os << "Received";
+    break;
+  case SegmentEventType::Timeout:
+    os << "Timeout";
+    break;
+  case SegmentEventType::Retransmitted:
+    os << "Retransmitted";
+    break;
+  case SegmentEventType::Nack:
+    os << "Nack";
+    break;
+  }
+  return os;
+}
+
 } // namespace chunks
 } // namespace ndn
@@ -33,9 +33,32 @@
 
 #include "options.hpp"
 
+#include <ndn-cxx/util/signal.hpp>
+
 namespace ndn {
 namespace chunks {
 
+/**
+ * @brief kinds of per-segment events reported by a pipeline
+ */
+enum class SegmentEventType : uint8_t {
+  Sent          = 0, ///< first Interest for the segment was sent
+  Received      = 1, ///< Data for the segment was received
+  Timeout       = 2, ///< an Interest for the segment timed out
+  Retransmitted = 3, ///< an Interest for the segment was retransmitted
+  Nack          = 4, ///< a Nack was received for the segment
+};
+
+std::ostream&
+operator<<(std::ostream& os, SegmentEventType type);
+
+struct SegmentEvent
+{
+  time::nanoseconds age; ///< time elapsed since the pipeline started
+  uint64_t segNo;
+  SegmentEventType type;
+};
+
 /**
  * @brief Service for retrieving Data via an Interest pipeline
  *
@@ -79,6 +102,29 @@ public:
   void
   cancel();
 
+  /**
+   * @brief Signals every Interest sent, Data or Nack received, and timeout for a segment.
+   */
+  util::Signal<PipelineInterests, SegmentEvent> afterSegmentEvent;
+
+  /**
+   * @brief check if the pipeline has stopped or all segments have been received
+   */
+  bool
+  isFinished() const
+  {
+    return m_isStopping || allSegmentsReceived();
+  }
+
+  /**
+   * @brief print the current state of this fetching session, one metric per line
+   *
+   * The output uses the Prometheus text exposition format. Subclasses can override this
+   * method to print additional metrics.
+   */
+  virtual void
+  printProgress(std::ostream& os) const;
+
 protected:
   time::steady_clock::TimePoint
   getStartTime() const
@@ -118,6 +164,20 @@ protected:
   void
   onFailure(const std::string& reason);
 
+  /**
+   * @brief subclasses call this method to report a per-segment event
+   *
+   * Does nothing, not even reading the clock, if no handler is connected to afterSegmentEvent.
+   */
+  void
+  traceSegment(SegmentEventType type, uint64_t segNo)
+  {
+    if (afterSegmentEvent.isEmpty()) {
+      return;
+    }
+    afterSegmentEvent({time::steady_clock::now() - m_startTime, segNo, type});
+  }
+
   void
   printOptions() const;
 
@@ -160,7 +220,8 @@ PUBLIC_WITH_TESTS_ELSE_PROTECTED:
   bool m_hasFinalBlockId;   ///< true if the last segment number is known
   uint64_t m_lastSegmentNo; ///< valid only if m_hasFinalBlockId == true
   int64_t m_nReceived;      ///< number of segments received
-  size_t m_receivedSize;    ///< size of received data in bytes
+  size_t m_receivedSize;    ///< size of received data in bytes, after decompression
+  size_t m_transferredSize; ///< size of received data in bytes, as sent on the wire
 
 private:
   DataCallback m_onData;
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "progress-reporter.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace ndn {
+namespace chunks {
+
+ProgressReporter::ProgressReporter(Face& face, Consumer& consumer, const std::string& path,
+                                   time::milliseconds interval)
+  : m_consumer(consumer)
+  , m_path(path)
+  , m_interval(interval)
+  , m_scheduler(face.getIoService())
+{
+  if (!report()) {
+    NDN_THROW(std::runtime_error("failed to write " + m_path));
+  }
+  scheduleNextReport();
+
+  m_finishedConn = consumer.afterFinished.connect([this] { finish(); });
+}
+
+void
+ProgressReporter::finish()
+{
+  m_reportEvent.cancel();
+  m_finishedConn.disconnect();
+  reportOrWarn();
+}
+
+bool
+ProgressReporter::report()
+{
+  std::string tmpPath = m_path + ".tmp";
+  {
+    std::ofstream os(tmpPath, std::ios::trunc);
+    m_consumer.printProgress(os);
+    if (!os) {
+      return false;
+    }
+  }
+  return std::rename(tmpPath.data(), m_path.data()) == 0;
+}
+
+void
+ProgressReporter::scheduleNextReport()
+{
+  m_reportEvent = m_scheduler.schedule(m_interval, [this] {
+    reportOrWarn();
+
+    if (!m_consumer.isFinished()) {
+      scheduleNextReport();
+    }
+  });
+}
+
+void
+ProgressReporter::reportOrWarn()
+{
+  if (!report() && !m_hasWarned) {
+    std::cerr << "WARNING: failed to write " << m_path << std::endl;
+    m_hasWarned = true;
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_CATCHUNKS_PROGRESS_REPORTER_HPP
+#define NDN_TOOLS_CHUNKS_CATCHUNKS_PROGRESS_REPORTER_HPP
+
+#include "consumer.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Periodically writes the progress of a transfer to a file
+ *
+ * Every @c interval, the current metrics of the consumer and its pipeline are written to a
+ * temporary file, which then atomically replaces the stats file, so readers never observe a
+ * partially written file. The metrics are collected on the event loop, hence the pipeline
+ * does no additional work per segment. When the consumer finishes, the final snapshot is
+ * written immediately and reporting stops, so that no pending timer keeps the face running.
+ */
+class ProgressReporter : noncopyable
+{
+public:
+  /**
+   * @brief Write the initial snapshot and start periodic reporting
+   * @throw std::runtime_error the stats file cannot be written
+   */
+  ProgressReporter(Face& face, Consumer& consumer, const std::string& path,
+                   time::milliseconds interval);
+
+  /**
+   * @brief Write the final snapshot and stop periodic reporting
+   */
+  void
+  finish();
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief write a snapshot to the stats file
+   * @return false if the file could not be written
+   */
+  bool
+  report();
+
+private:
+  void
+  scheduleNextReport();
+
+  void
+  reportOrWarn();
+
+private:
+  const Consumer& m_consumer;
+  const std::string m_path;
+  const time::milliseconds m_interval;
+  Scheduler m_scheduler;
+  scheduler::ScopedEventId m_reportEvent;
+  util::signal::ScopedConnection m_finishedConn;
+  bool m_hasWarned = false;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_CATCHUNKS_PROGRESS_REPORTER_HPP
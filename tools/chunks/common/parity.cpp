@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "parity.hpp"
+
+namespace ndn {
+namespace chunks {
+
+const name::Component PARITY_COMPONENT = name::Component::fromEscapedString("32=parity");
+
+Name
+makeParityName(const Name& versionedName, uint64_t blockNo)
+{
+  return Name(versionedName).append(PARITY_COMPONENT).appendSegment(blockNo);
+}
+
+void
+xorInto(std::vector<uint8_t>& acc, const uint8_t* buf, size_t size)
+{
+  if (acc.size() < size) {
+    acc.resize(size, 0);
+  }
+  for (size_t i = 0; i < size; ++i) {
+    acc[i] ^= buf[i];
+  }
+}
+
+std::vector<uint8_t>
+computeParity(const std::vector<Block>& segments)
+{
+  std::vector<uint8_t> parity;
+  for (const auto& segment : segments) {
+    xorInto(parity, segment.wire(), segment.size());
+  }
+  return parity;
+}
+
+shared_ptr<Data>
+recoverSegment(const Block& parity, const std::vector<Block>& others)
+{
+  std::vector<uint8_t> acc(parity.value_begin(), parity.value_end());
+  for (const auto& segment : others) {
+    xorInto(acc, segment.wire(), segment.size());
+  }
+
+  // the rebuilt segment is followed by zero padding if it is not the longest of the block
+  bool isOk = false;
+  Block wire;
+  std::tie(isOk, wire) = Block::fromBuffer(acc.data(), acc.size());
+  if (!isOk || wire.type() != tlv::Data) {
+    return nullptr;
+  }
+
+  try {
+    return make_shared<Data>(wire);
+  }
+  catch (const tlv::Error&) {
+    return nullptr;
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_COMMON_PARITY_HPP
+#define NDN_TOOLS_CHUNKS_COMMON_PARITY_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Keyword component that separates the versioned name from the block number in the
+ *        name of a parity segment
+ *
+ * Segments are grouped in blocks of K consecutive segments, where K is chosen by the
+ * publisher. Block b, made of segments b*K to (b+1)*K - 1, is protected by the parity segment
+ * /prefix/<version>/32=parity/<segment=b>, whose payload is the XOR of the wire encodings of
+ * all segments of the block, each padded with zeros to the length of the longest one.
+ * Any single segment of the block can be rebuilt, bit for bit, from the parity and the
+ * other segments of the block.
+ */
+extern const name::Component PARITY_COMPONENT;
+
+Name
+makeParityName(const Name& versionedName, uint64_t blockNo);
+
+/**
+ * @brief XOR @p size bytes at @p buf into @p acc, growing @p acc if needed
+ */
+void
+xorInto(std::vector<uint8_t>& acc, const uint8_t* buf, size_t size);
+
+/**
+ * @brief compute the parity payload of a block from the wire encodings of its segments
+ */
+std::vector<uint8_t>
+computeParity(const std::vector<Block>& segments);
+
+/**
+ * @brief rebuild the only missing segment of a block
+ * @param parity payload of the parity segment of the block
+ * @param others wire encodings of all the other segments of the block
+ * @return the rebuilt segment, or nullptr if the result is not a valid Data packet
+ */
+shared_ptr<Data>
+recoverSegment(const Block& parity, const std::vector<Block>& others);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_COMMON_PARITY_HPP
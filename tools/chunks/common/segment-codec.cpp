@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "segment-codec.hpp"
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif // HAVE_ZSTD
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif // HAVE_LZ4
+
+namespace ndn {
+namespace chunks {
+
+static const size_t HEADER_SIZE = 4;
+#ifdef HAVE_ZSTD
+static const int ZSTD_LEVEL = 3; // zstd's default level, fast enough to keep up with the network
+#endif // HAVE_ZSTD
+
+std::ostream&
+operator<<(std::ostream& os, Codec codec)
+{
+  switch (codec) {
+    case Codec::None:
+      return os << "none";
+    case Codec::Zstd:
+      return os << "zstd";
+    case Codec::Lz4:
+      return os << "lz4";
+  }
+  return os << static_cast<int>(codec);
+}
+
+Codec
+parseCodec(const std::string& str)
+{
+  if (str == "none")
+    return Codec::None;
+  if (str == "zstd")
+    return Codec::Zstd;
+  if (str == "lz4")
+    return Codec::Lz4;
+  NDN_THROW(std::invalid_argument("Unknown compression codec '" + str + "'"));
+}
+
+bool
+isCodecAvailable(Codec codec)
+{
+  switch (codec) {
+    case Codec::None:
+      return true;
+    case Codec::Zstd:
+#ifdef HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif // HAVE_ZSTD
+    case Codec::Lz4:
+#ifdef HAVE_LZ4
+      return true;
+#else
+      return false;
+#endif // HAVE_LZ4
+  }
+  return false;
+}
+
+bool
+isCompressed(uint32_t contentType)
+{
+  return contentType == ContentType_Zstd || contentType == ContentType_Lz4;
+}
+
+static uint32_t
+readHeader(const uint8_t* buf)
+{
+  return (uint32_t(buf[0]) << 24) | (uint32_t(buf[1]) << 16) | (uint32_t(buf[2]) << 8) | buf[3];
+}
+
+std::vector<uint8_t>
+encodePayload(Codec codec, const uint8_t* buf, size_t size, uint32_t& contentType)
+{
+  std::vector<uint8_t> out;
+  size_t compressedSize = 0;
+
+  switch (codec) {
+    case Codec::None:
+      break;
+    case Codec::Zstd: {
+#ifdef HAVE_ZSTD
+      out.resize(HEADER_SIZE + ZSTD_compressBound(size));
+      auto ret = ZSTD_compress(out.data() + HEADER_SIZE, out.size() - HEADER_SIZE, buf, size,
+                               ZSTD_LEVEL);
+      if (!ZSTD_isError(ret)) {
+        compressedSize = ret;
+        contentType = ContentType_Zstd;
+      }
+#endif // HAVE_ZSTD
+      break;
+    }
+    case Codec::Lz4: {
+#ifdef HAVE_LZ4
+      out.resize(HEADER_SIZE + LZ4_compressBound(static_cast<int>(size)));
+      int ret = LZ4_compress_default(reinterpret_cast<const char*>(buf),
+                                     reinterpret_cast<char*>(out.data() + HEADER_SIZE),
+                                     static_cast<int>(size), static_cast<int>(out.size() - HEADER_SIZE));
+      if (ret > 0) {
+        compressedSize = static_cast<size_t>(ret);
+        contentType = ContentType_Lz4;
+      }
+#endif // HAVE_LZ4
+      break;
+    }
+  }
+
+  if (compressedSize == 0 || HEADER_SIZE + compressedSize >= size) {
+    contentType = tlv::ContentType_Blob;
+    return std::vector<uint8_t>(buf, buf + size);
+  }
+
+  out[0] = static_cast<uint8_t>(size >> 24);
+  out[1] = static_cast<uint8_t>(size >> 16);
+  out[2] = static_cast<uint8_t>(size >> 8);
+  out[3] = static_cast<uint8_t>(size);
+  out.resize(HEADER_SIZE + compressedSize);
+  return out;
+}
+
+void
+decodePayload(uint32_t contentType, const uint8_t* buf, size_t size, std::vector<uint8_t>& out)
+{
+  if (!isCompressed(contentType)) {
+    out.assign(buf, buf + size);
+    return;
+  }
+
+  if (size < HEADER_SIZE) {
+    NDN_THROW(CodecError("Compressed payload is truncated"));
+  }
+  // a segment can never be larger than an NDN packet, which bounds the allocation below
+  const uint32_t decodedSize = readHeader(buf);
+  if (decodedSize > MAX_NDN_PACKET_SIZE) {
+    NDN_THROW(CodecError("Compressed payload is too large (" + to_string(decodedSize) + " bytes)"));
+  }
+  out.resize(decodedSize);
+
+  if (contentType == ContentType_Zstd) {
+#ifdef HAVE_ZSTD
+    auto ret = ZSTD_decompress(out.data(), out.size(), buf + HEADER_SIZE, size - HEADER_SIZE);
+    if (ZSTD_isError(ret) || ret != decodedSize) {
+      NDN_THROW(CodecError("Malformed zstd payload"));
+    }
+    return;
+#else
+    NDN_THROW(CodecError("Segment is compressed with zstd, which is not available"));
+#endif // HAVE_ZSTD
+  }
+  else {
+#ifdef HAVE_LZ4
+    int ret = LZ4_decompress_safe(reinterpret_cast<const char*>(buf + HEADER_SIZE),
+                                  reinterpret_cast<char*>(out.data()),
+                                  static_cast<int>(size - HEADER_SIZE), static_cast<int>(out.size()));
+    if (ret < 0 || static_cast<uint32_t>(ret) != decodedSize) {
+      NDN_THROW(CodecError("Malformed lz4 payload"));
+    }
+    return;
+#else
+    NDN_THROW(CodecError("Segment is compressed with lz4, which is not available"));
+#endif // HAVE_LZ4
+  }
+}
+
+size_t
+getDecodedSize(const Data& data)
+{
+  if (!isCompressed(data.getContentType())) {
+    return data.getContent().value_size();
+  }
+
+  try {
+    Block content = data.getContent();
+    content.parse();
+    auto payload = content.find(tlv::Content);
+    if (payload != content.elements_end() && payload->value_size() >= HEADER_SIZE) {
+      return readHeader(payload->value());
+    }
+  }
+  catch (const tlv::Error&) {
+    // malformed segments are reported when they are written out
+  }
+  return data.getContent().value_size();
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_COMMON_SEGMENT_CODEC_HPP
+#define NDN_TOOLS_CHUNKS_COMMON_SEGMENT_CODEC_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Compression applied to the payload of each segment
+ *
+ * Every segment is compressed independently, so that it can be decoded as soon as it is
+ * received. The codec is signaled in the ContentType of the segment: a compressed payload
+ * starts with the uncompressed size (uint32, big-endian), followed by the compressed bytes.
+ * Segments that would not shrink are published uncompressed, with ContentType Blob.
+ */
+enum class Codec {
+  None,
+  Zstd,
+  Lz4,
+};
+
+std::ostream&
+operator<<(std::ostream& os, Codec codec);
+
+/**
+ * @throw std::invalid_argument @p str is not "none", "zstd", or "lz4"
+ */
+Codec
+parseCodec(const std::string& str);
+
+/**
+ * @brief whether @p codec was found when ndn-tools was configured
+ */
+bool
+isCodecAvailable(Codec codec);
+
+/// ContentType of segments compressed with zstd
+const uint32_t ContentType_Zstd = 0x8001;
+/// ContentType of segments compressed with lz4
+const uint32_t ContentType_Lz4 = 0x8002;
+
+class CodecError : public std::runtime_error
+{
+public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief compress @p size bytes at @p buf with @p codec
+ * @param[out] contentType ContentType to set on the segment
+ * @return the payload of the segment, which is a copy of the input if @p codec is
+ *         unavailable or if compression does not make it smaller
+ */
+std::vector<uint8_t>
+encodePayload(Codec codec, const uint8_t* buf, size_t size, uint32_t& contentType);
+
+/**
+ * @brief decode the payload of a segment with ContentType @p contentType into @p out
+ *
+ * The decoded bytes replace the contents of @p out.
+ * @throw CodecError the payload is malformed or its codec is not available
+ */
+void
+decodePayload(uint32_t contentType, const uint8_t* buf, size_t size, std::vector<uint8_t>& out);
+
+/**
+ * @return whether @p contentType denotes a compressed payload
+ */
+bool
+isCompressed(uint32_t contentType);
+
+/**
+ * @return the number of payload bytes carried by @p data once decoded
+ */
+size_t
+getDecodedSize(const Data& data);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_COMMON_SEGMENT_CODEC_HPP
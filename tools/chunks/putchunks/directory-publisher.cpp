@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "directory-publisher.hpp"
+#include "segmenter.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace ndn {
+namespace chunks {
+
+namespace fs = boost::filesystem;
+
+const name::Component DirectoryPublisher::MANIFEST_COMPONENT =
+  name::Component::fromEscapedString("32=manifest");
+
+namespace {
+
+struct Job
+{
+  fs::path inputPath;
+  std::string storePath;
+  Name versionedName;
+  uint64_t size = 0;
+  std::vector<shared_ptr<Data>> segments; ///< set by a worker thread
+  std::exception_ptr error; ///< set by a worker thread
+  bool isDone = false; ///< protected by the mutex
+};
+
+/**
+ * @brief Remove the segment files left in @p objectsDir by a previous run
+ *
+ * The directory is left untouched if it contains anything other than segment files, since
+ * it was then not written by DirectoryPublisher.
+ */
+void
+removeStaleSegmentFiles(const fs::path& objectsDir)
+{
+  if (!fs::exists(objectsDir)) {
+    return;
+  }
+
+  std::vector<fs::path> storeFiles;
+  for (fs::recursive_directory_iterator it(objectsDir), end; it != end; ++it) {
+    if (fs::is_directory(it->status())) {
+      continue;
+    }
+    if (!fs::is_regular_file(it->status()) || it->path().extension() != ".store") {
+      NDN_THROW(std::runtime_error(objectsDir.string() + " contains " + it->path().string() +
+                                   ", which is not a segment file"));
+    }
+    storeFiles.push_back(it->path());
+  }
+
+  for (const auto& path : storeFiles) {
+    fs::remove(path);
+  }
+}
+
+} // namespace
+
+DirectoryPublisher::DirectoryPublisher(const Name& prefix, KeyChain& keyChain,
+                                       const Producer::Options& opts, size_t nThreads)
+  : m_prefix(prefix)
+  , m_keyChain(keyChain)
+  , m_options(opts)
+  , m_nThreads(nThreads > 0 ? nThreads : std::max(std::thread::hardware_concurrency(), 1U))
+{
+}
+
+std::vector<DirectoryPublisher::Object>
+DirectoryPublisher::publish(const std::string& inputDir, const std::string& storeDir)
+{
+  const fs::path root(inputDir);
+  if (!fs::is_directory(root)) {
+    NDN_THROW(std::runtime_error(inputDir + " is not a directory"));
+  }
+
+  // segment files of files that no longer exist must not be served along with the new ones
+  const fs::path objectsDir = fs::path(storeDir) / "objects";
+  removeStaleSegmentFiles(objectsDir);
+  fs::create_directories(objectsDir);
+  const fs::path canonicalStoreDir = fs::canonical(storeDir);
+
+  std::vector<fs::path> relPaths;
+  for (fs::recursive_directory_iterator it(root), end; it != end; ++it) {
+    if (fs::is_directory(it->status()) && fs::canonical(it->path()) == canonicalStoreDir) {
+      it.no_push();
+    }
+    else if (fs::is_regular_file(it->status())) {
+      relPaths.push_back(it->path().lexically_relative(root));
+    }
+  }
+  std::sort(relPaths.begin(), relPaths.end());
+
+  const auto version = Name().appendVersion().at(0);
+  std::vector<Job> jobs(relPaths.size());
+  for (size_t i = 0; i < relPaths.size(); ++i) {
+    Job& job = jobs[i];
+    job.inputPath = root / relPaths[i];
+    job.storePath = (objectsDir / relPaths[i]).string() + ".store";
+    job.versionedName = m_prefix;
+    for (const auto& component : relPaths[i]) {
+      job.versionedName.append(component.string().data());
+    }
+    job.versionedName.append(version);
+    job.size = fs::file_size(job.inputPath);
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t nextJob = 0;
+  size_t nWritten = 0;
+  bool shouldStop = false;
+  // bound the number of segmented files waiting to be signed and written
+  const size_t window = 2 * m_nThreads;
+
+  auto worker = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&] { return shouldStop || nextJob >= jobs.size() || nextJob < nWritten + window; });
+      if (shouldStop || nextJob >= jobs.size()) {
+        return;
+      }
+      Job& job = jobs[nextJob++];
+      lock.unlock();
+
+      try {
+        fs::ifstream is(job.inputPath, std::ios::binary);
+        if (!is) {
+          NDN_THROW(std::runtime_error("Cannot open " + job.inputPath.string()));
+        }
+        job.segments = makeChainedSegments(job.versionedName, is, m_options);
+        if (is.bad()) {
+          NDN_THROW(std::runtime_error("Cannot read " + job.inputPath.string()));
+        }
+      }
+      catch (...) {
+        job.error = std::current_exception();
+      }
+
+      lock.lock();
+      job.isDone = true;
+      cv.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  auto stopWorkers = [&] {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      shouldStop = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  std::vector<Object> objects;
+  try {
+    for (size_t i = 0; i < std::min(m_nThreads, jobs.size()); ++i) {
+      threads.emplace_back(worker);
+    }
+
+    for (auto& job : jobs) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return job.isDone; });
+      }
+      if (job.error) {
+        std::rethrow_exception(job.error);
+      }
+
+      m_keyChain.sign(*job.segments.front(), m_options.signingInfo);
+      fs::create_directories(fs::path(job.storePath).parent_path());
+      SegmentFile::write(job.storePath, job.versionedName, job.segments);
+      objects.push_back({job.versionedName, job.size});
+
+      if (m_options.isVerbose)
+        std::cerr << "Created " << job.segments.size() << " chunks for " << job.versionedName << std::endl;
+
+      job.segments = {};
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++nWritten;
+      }
+      cv.notify_all();
+    }
+  }
+  catch (...) {
+    stopWorkers();
+    throw;
+  }
+  stopWorkers();
+
+  std::ostringstream manifest;
+  for (const auto& object : objects) {
+    manifest << object.versionedName << ' ' << object.size << '\n';
+  }
+  std::istringstream is(manifest.str());
+  auto manifestName = getManifestName().append(version);
+  auto segments = makeChainedSegments(manifestName, is, m_options);
+  m_keyChain.sign(*segments.front(), m_options.signingInfo);
+  SegmentFile::write((fs::path(storeDir) / "manifest.store").string(), manifestName, segments);
+
+  if (!m_options.isQuiet)
+    std::cerr << "Published " << objects.size() << " files with manifest " << manifestName << std::endl;
+
+  return objects;
+}
+
+} // namespace chunks
+} // namespace ndn
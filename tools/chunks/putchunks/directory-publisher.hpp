@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_DIRECTORY_PUBLISHER_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_DIRECTORY_PUBLISHER_HPP
+
+#include "producer.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Packetizes every file of a directory tree into segment files
+ *
+ * The file at relative path a/b/c under the input directory is published as
+ * /prefix/a/b/c/<version>/<segment number>, where all files share the same version.
+ * Files are read, segmented, and hash-chained by a pool of worker threads, while the
+ * calling thread signs the first segment of each file (KeyChain is not thread-safe) and
+ * writes the segment files in a fixed order.
+ *
+ * A manifest object, /prefix/32=manifest/<version>, lists the versioned name and the size
+ * in bytes of every published file, one per line. The resulting store directory can be
+ * served with MultiObjectProducer.
+ */
+class DirectoryPublisher : noncopyable
+{
+public:
+  struct Object
+  {
+    Name versionedName;
+    uint64_t size;
+  };
+
+  /// keyword component that identifies the manifest object
+  static const name::Component MANIFEST_COMPONENT;
+
+  /**
+   * @param nThreads number of worker threads; 0 means one per hardware thread
+   */
+  DirectoryPublisher(const Name& prefix, KeyChain& keyChain, const Producer::Options& opts,
+                     size_t nThreads = 0);
+
+  /**
+   * @brief Packetize every regular file under @p inputDir and write the segment files,
+   *        including the manifest, under @p storeDir
+   *
+   * The segment files of a previous run are removed from the "objects" subdirectory of
+   * @p storeDir; any other file found there aborts the publication.
+   *
+   * @return the published objects, in manifest order (sorted by relative path)
+   * @throw SegmentFile::Error a segment file cannot be written
+   * @throw std::runtime_error an input file cannot be read, or the "objects" subdirectory
+   *                           contains files that are not segment files
+   */
+  std::vector<Object>
+  publish(const std::string& inputDir, const std::string& storeDir);
+
+  /**
+   * @brief Name of the manifest object, without version
+   */
+  Name
+  getManifestName() const
+  {
+    return Name(m_prefix).append(MANIFEST_COMPONENT);
+  }
+
+private:
+  Name m_prefix;
+  KeyChain& m_keyChain;
+  const Producer::Options m_options;
+  size_t m_nThreads;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_DIRECTORY_PUBLISHER_HPP
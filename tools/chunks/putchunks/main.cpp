@@ -28,8 +28,11 @@
  */
 
 #include "core/version.hpp"
+#include "directory-publisher.hpp"
+#include "multi-object-producer.hpp"
 #include "producer.hpp"
 
+#include <boost/asio/signal_set.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/variables_map.hpp>
@@ -50,12 +53,41 @@ usage(std::ostream& os, const std::string& programName, const po::options_descri
      << desc;
 }
 
+/**
+ * @brief Serve until the face is shut down or SIGINT/SIGTERM is received, then print the
+ *        Interest aggregation statistics and, if @p isServingFiles, the segment cache statistics
+ */
+template<typename ProducerT>
+static void
+serve(Face& face, ProducerT& producer, const Producer::Options& opts, bool isServingFiles)
+{
+  boost::asio::signal_set signalSet(face.getIoService(), SIGINT, SIGTERM);
+  signalSet.async_wait([&face] (const auto& ec, auto) {
+    if (ec != boost::asio::error::operation_aborted) {
+      face.shutdown();
+    }
+  });
+
+  producer.run();
+
+  if (!opts.isQuiet) {
+    if (isServingFiles)
+      std::cerr << "Segment cache: " << producer.getCache() << std::endl;
+    if (opts.aggregationWindow > 0_ms)
+      std::cerr << "Interest aggregation: " << producer.getPendingResponses() << std::endl;
+  }
+}
+
 static int
 main(int argc, char* argv[])
 {
   std::string programName = argv[0];
   std::string prefix;
   std::string signingStr;
+  std::string codecStr = "none";
+  std::string objectsDir;
+  std::string inputDir;
+  size_t nJobs = 0;
   Producer::Options opts;
 
   po::options_description visibleDesc("Options");
@@ -67,7 +99,30 @@ main(int argc, char* argv[])
                              "print Data version to the standard output")
     ("size,s",          po::value<size_t>(&opts.maxSegmentSize)->default_value(opts.maxSegmentSize),
                         "maximum chunk size, in bytes")
+    ("compress,z",      po::value<std::string>(&codecStr)->default_value(codecStr),
+                        "compress the payload of each segment with 'zstd' or 'lz4', if available")
+    ("fec",             po::value<size_t>(&opts.fecBlockSize)->default_value(opts.fecBlockSize),
+                        "serve one XOR parity segment for every block of this many segments (0 = disabled)")
     ("signing-info,S",  po::value<std::string>(&signingStr), "see 'man ndnputchunks' for usage")
+    ("store-dir,d",     po::value<std::string>(&opts.storeDir),
+                        "directory where the signed segments are saved and, on later runs, loaded from")
+    ("objects-dir,m",   po::value<std::string>(&objectsDir),
+                        "publish every segment file found under this directory, "
+                        "instead of the standard input")
+    ("input-dir,i",     po::value<std::string>(&inputDir),
+                        "publish every file under this directory as <name>/<relative path>, "
+                        "instead of the standard input; requires --store-dir")
+    ("jobs,j",          po::value<size_t>(&nJobs)->default_value(nJobs),
+                        "number of threads packetizing files with --input-dir (0 = one per CPU)")
+    ("cache-size",      po::value<size_t>(&opts.cacheSize)->default_value(opts.cacheSize),
+                        "number of segments read from segment files that are kept in memory")
+    ("cache-bytes",     po::value<size_t>(&opts.cacheBytes)->default_value(opts.cacheBytes),
+                        "maximum total size of the cached segments, in bytes (0 = unlimited)")
+    ("prefetch",        po::value<size_t>(&opts.prefetchCount)->default_value(opts.prefetchCount),
+                        "number of segments read ahead into the cache on a sequential miss")
+    ("aggregate",       po::value<time::milliseconds::rep>()->default_value(opts.aggregationWindow.count()),
+                        "answer Interests for a segment sent less than this many milliseconds ago "
+                        "with the Data already sent (0 = disabled)")
     ("quiet,q",         po::bool_switch(&opts.isQuiet), "turn off all non-error output")
     ("verbose,v",       po::bool_switch(&opts.isVerbose), "turn on verbose output (per Interest information)")
     ("version,V",       "print program version and exit")
@@ -118,11 +173,24 @@ main(int argc, char* argv[])
     return 2;
   }
 
+  opts.aggregationWindow = time::milliseconds(vm["aggregate"].as<time::milliseconds::rep>());
+  if (opts.aggregationWindow < 0_ms) {
+    std::cerr << "ERROR: Aggregation window cannot be negative" << std::endl;
+    return 2;
+  }
+
   if (opts.maxSegmentSize < 1 || opts.maxSegmentSize > MAX_NDN_PACKET_SIZE) {
     std::cerr << "ERROR: Maximum chunk size must be between 1 and " << MAX_NDN_PACKET_SIZE << std::endl;
     return 2;
   }
 
+  if (opts.fecBlockSize > 0 && opts.maxSegmentSize > MAX_NDN_PACKET_SIZE / 2) {
+    // a parity segment is slightly larger than the largest segment of its block
+    std::cerr << "ERROR: --fec requires a maximum chunk size of at most " << MAX_NDN_PACKET_SIZE / 2
+              << std::endl;
+    return 2;
+  }
+
   try {
     opts.signingInfo = security::SigningInfo(signingStr);
   }
@@ -131,6 +199,39 @@ main(int argc, char* argv[])
     return 2;
   }
 
+  try {
+    opts.codec = parseCodec(codecStr);
+  }
+  catch (const std::invalid_argument& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 2;
+  }
+  if (!isCodecAvailable(opts.codec)) {
+    std::cerr << "WARNING: " << opts.codec << " is not available, publishing uncompressed segments"
+              << std::endl;
+    opts.codec = Codec::None;
+  }
+
+  if (!objectsDir.empty() && !opts.storeDir.empty()) {
+    std::cerr << "ERROR: --objects-dir and --store-dir cannot be used together" << std::endl;
+    return 2;
+  }
+
+  if (!objectsDir.empty() && !inputDir.empty()) {
+    std::cerr << "ERROR: --objects-dir and --input-dir cannot be used together" << std::endl;
+    return 2;
+  }
+
+  if (opts.fecBlockSize > 0 && (!objectsDir.empty() || !inputDir.empty())) {
+    std::cerr << "ERROR: --fec cannot be used with --objects-dir or --input-dir" << std::endl;
+    return 2;
+  }
+
+  if (!inputDir.empty() && opts.storeDir.empty()) {
+    std::cerr << "ERROR: --input-dir requires --store-dir" << std::endl;
+    return 2;
+  }
+
   if (opts.isQuiet && opts.isVerbose) {
     std::cerr << "ERROR: Cannot be quiet and verbose at the same time" << std::endl;
     return 2;
@@ -139,8 +240,20 @@ main(int argc, char* argv[])
   try {
     Face face;
     KeyChain keyChain;
-    Producer producer(prefix, face, keyChain, std::cin, opts);
-    producer.run();
+    if (!inputDir.empty()) {
+      DirectoryPublisher publisher(prefix, keyChain, opts, nJobs);
+      publisher.publish(inputDir, opts.storeDir);
+      MultiObjectProducer producer(prefix, face, keyChain, opts.storeDir, opts);
+      serve(face, producer, opts, true);
+    }
+    else if (!objectsDir.empty()) {
+      MultiObjectProducer producer(prefix, face, keyChain, objectsDir, opts);
+      serve(face, producer, opts, true);
+    }
+    else {
+      Producer producer(prefix, face, keyChain, std::cin, opts);
+      serve(face, producer, opts, producer.isServingSegmentFile());
+    }
   }
   catch (const std::exception& e) {
     std::cerr << "ERROR: " << e.what() << std::endl;
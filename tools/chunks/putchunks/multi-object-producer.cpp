@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "multi-object-producer.hpp"
+
+#include <ndn-cxx/metadata-object.hpp>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace ndn {
+namespace chunks {
+
+MultiObjectProducer::MultiObjectProducer(const Name& prefix, Face& face, KeyChain& keyChain,
+                                         const std::string& dir, const Producer::Options& opts)
+  : m_cache(opts.cacheSize, opts.cacheBytes, opts.prefetchCount)
+  , m_pendingResponses(opts.aggregationWindow)
+  , m_prefix(prefix)
+  , m_face(face)
+  , m_keyChain(keyChain)
+  , m_options(opts)
+{
+  indexObjects(dir);
+
+  m_face.setInterestFilter(m_prefix, bind(&MultiObjectProducer::processInterest, this, _2),
+                           bind(&MultiObjectProducer::onRegisterFailed, this, _1, _2));
+
+  if (!m_options.isQuiet)
+    std::cerr << "Publishing " << m_objects.size() << " objects under " << m_prefix << std::endl;
+}
+
+void
+MultiObjectProducer::run()
+{
+  m_face.processEvents();
+}
+
+void
+MultiObjectProducer::indexObjects(const std::string& dir)
+{
+  namespace fs = boost::filesystem;
+
+  for (fs::recursive_directory_iterator it(dir), end; it != end; ++it) {
+    if (!fs::is_regular_file(it->status()) || it->path().extension() != ".store") {
+      continue;
+    }
+
+    std::string path = it->path().string();
+    Name versionedName;
+    try {
+      versionedName = SegmentFile::readVersionedName(path);
+    }
+    catch (const SegmentFile::Error& e) {
+      std::cerr << "WARNING: skipping " << path << ": " << e.what() << std::endl;
+      continue;
+    }
+
+    if (versionedName.empty() || !versionedName[-1].isVersion() ||
+        !m_prefix.isPrefixOf(versionedName.getPrefix(-1))) {
+      std::cerr << "WARNING: skipping " << path << ": " << versionedName
+                << " is not a versioned name under " << m_prefix << std::endl;
+      continue;
+    }
+
+    Name objectName = versionedName.getPrefix(-1);
+    auto ret = m_objects.emplace(objectName, Object{path, versionedName, nullptr});
+    if (!ret.second) {
+      std::cerr << "WARNING: skipping " << path << ": " << objectName
+                << " is already published from " << ret.first->second.path << std::endl;
+      continue;
+    }
+
+    if (m_options.isVerbose)
+      std::cerr << "Indexed " << versionedName << " from " << path << std::endl;
+  }
+}
+
+void
+MultiObjectProducer::processInterest(const Interest& interest)
+{
+  if (m_options.isVerbose)
+    std::cerr << "Interest: " << interest << std::endl;
+
+  auto data = m_pendingResponses.find(interest);
+  if (data != nullptr) {
+    if (m_options.isVerbose)
+      std::cerr << "Duplicate Interest within the aggregation window, resending Data" << std::endl;
+    m_face.put(*data);
+    return;
+  }
+
+  const Name& name = interest.getName();
+  if (!name.empty() && name[-1] == MetadataObject::getKeywordComponent()) {
+    // discovery Interest: /<object>/32=metadata
+    auto it = m_objects.find(name.getPrefix(-1));
+    if (it != m_objects.end()) {
+      return processDiscoveryInterest(interest, it->second);
+    }
+  }
+  else if (name.size() >= 2 && name[-1].isSegment() && name[-2].isVersion()) {
+    // specific segment retrieval: /<object>/<version>/<segment>
+    auto it = m_objects.find(name.getPrefix(-2));
+    if (it != m_objects.end() && it->second.versionedName == name.getPrefix(-1)) {
+      data = getSegment(it->second, name[-1].toSegment());
+    }
+  }
+  else if (interest.getCanBePrefix()) {
+    // unspecified version or segment number, return first segment
+    auto it = m_objects.find(!name.empty() && name[-1].isVersion() ? name.getPrefix(-1) : name);
+    if (it != m_objects.end()) {
+      data = getSegment(it->second, 0);
+      if (data != nullptr && !interest.matchesData(*data)) {
+        data = nullptr;
+      }
+    }
+  }
+
+  if (data != nullptr) {
+    if (m_options.isVerbose)
+      std::cerr << "Data: " << *data << std::endl;
+
+    m_face.put(*data);
+    m_pendingResponses.insert(interest, std::move(data));
+  }
+  else {
+    if (m_options.isVerbose)
+      std::cerr << "Interest cannot be satisfied, sending Nack" << std::endl;
+    m_face.put(lp::Nack(interest));
+  }
+}
+
+void
+MultiObjectProducer::processDiscoveryInterest(const Interest& interest, const Object& object)
+{
+  if (!interest.getCanBePrefix()) {
+    if (m_options.isVerbose)
+      std::cerr << "Discovery Interest lacks CanBePrefix, sending Nack" << std::endl;
+    m_face.put(lp::Nack(interest));
+    return;
+  }
+
+  MetadataObject mobject;
+  mobject.setVersionedName(object.versionedName);
+  Data mdata(mobject.makeData(interest.getName(), m_keyChain, m_options.signingInfo));
+
+  if (m_options.isVerbose)
+    std::cerr << "Sending metadata: " << mdata << std::endl;
+
+  m_face.put(mdata);
+}
+
+shared_ptr<const Data>
+MultiObjectProducer::getSegment(Object& object, uint64_t segNo)
+{
+  return m_cache.get(object.versionedName, segNo, [&object] (uint64_t i) -> shared_ptr<const Data> {
+    if (object.file == nullptr) {
+      try {
+        object.file = make_unique<SegmentFile>(object.path);
+      }
+      catch (const SegmentFile::Error& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return nullptr;
+      }
+    }
+
+    if (i >= object.file->size()) {
+      return nullptr;
+    }
+
+    try {
+      return make_shared<Data>(object.file->getSegment(static_cast<size_t>(i)));
+    }
+    catch (const tlv::Error& e) {
+      std::cerr << "ERROR: segment " << i << " of " << object.path << " is invalid: "
+                << e.what() << std::endl;
+      return nullptr;
+    }
+  });
+}
+
+void
+MultiObjectProducer::onRegisterFailed(const Name& prefix, const std::string& reason)
+{
+  std::cerr << "ERROR: Failed to register prefix '"
+            << prefix << "' (" << reason << ")" << std::endl;
+  m_face.shutdown();
+  // also return from run() while other handlers, e.g. signal waits, are still pending
+  m_face.getIoService().stop();
+}
+
+} // namespace chunks
+} // namespace ndn
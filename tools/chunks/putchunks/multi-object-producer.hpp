@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_MULTI_OBJECT_PRODUCER_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_MULTI_OBJECT_PRODUCER_HPP
+
+#include "producer.hpp"
+
+#include <unordered_map>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Publisher of many segmented objects under a single registered prefix
+ *
+ * Every segment file (created with Producer::Options::storeDir) found under a directory is
+ * published under the versioned name stored in its header, which must start with the
+ * registered prefix. Only the headers are read at startup; the segments of an object are
+ * mapped into memory when the object is first requested, and recently served segments are
+ * kept in an LRU cache bounded by Producer::Options::cacheSize and Producer::Options::cacheBytes.
+ * On a sequential cache miss, the next Producer::Options::prefetchCount segments of the same
+ * object are read into the cache as well.
+ */
+class MultiObjectProducer : noncopyable
+{
+public:
+  /**
+   * @brief Index the segment files under @p dir and register @p prefix
+   *
+   * Segment files that cannot be read, or whose name is not under @p prefix, are skipped
+   * with a warning.
+   */
+  MultiObjectProducer(const Name& prefix, Face& face, KeyChain& keyChain, const std::string& dir,
+                      const Producer::Options& opts);
+
+  void
+  run();
+
+  size_t
+  getObjectCount() const
+  {
+    return m_objects.size();
+  }
+
+  const SegmentCache&
+  getCache() const
+  {
+    return m_cache;
+  }
+
+  const PendingResponseTable&
+  getPendingResponses() const
+  {
+    return m_pendingResponses;
+  }
+
+private:
+  struct Object
+  {
+    std::string path;
+    Name versionedName;
+    unique_ptr<SegmentFile> file; ///< mapped on first access
+  };
+
+  void
+  indexObjects(const std::string& dir);
+
+  void
+  processInterest(const Interest& interest);
+
+  void
+  processDiscoveryInterest(const Interest& interest, const Object& object);
+
+  /**
+   * @return the requested segment, or nullptr if it does not exist
+   */
+  shared_ptr<const Data>
+  getSegment(Object& object, uint64_t segNo);
+
+  void
+  onRegisterFailed(const Name& prefix, const std::string& reason);
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  std::unordered_map<Name, Object> m_objects; ///< indexed by object name, without version
+  SegmentCache m_cache;
+  PendingResponseTable m_pendingResponses;
+
+private:
+  Name m_prefix;
+  Face& m_face;
+  KeyChain& m_keyChain;
+  const Producer::Options m_options;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_MULTI_OBJECT_PRODUCER_HPP
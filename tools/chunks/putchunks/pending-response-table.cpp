@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "pending-response-table.hpp"
+
+namespace ndn {
+namespace chunks {
+
+PendingResponseTable::PendingResponseTable(time::milliseconds window)
+  : m_window(window)
+{
+}
+
+shared_ptr<const Data>
+PendingResponseTable::find(const Interest& interest)
+{
+  if (m_window <= 0_ms) {
+    return nullptr;
+  }
+
+  expire(time::steady_clock::now());
+
+  auto it = m_entries.find(interest.getName());
+  if (it == m_entries.end() || !interest.matchesData(*it->second.data)) {
+    return nullptr;
+  }
+
+  ++m_nAggregated;
+  return it->second.data;
+}
+
+void
+PendingResponseTable::insert(const Interest& interest, shared_ptr<const Data> data)
+{
+  BOOST_ASSERT(data != nullptr);
+  ++m_nResponses;
+
+  if (m_window <= 0_ms) {
+    return;
+  }
+
+  auto now = time::steady_clock::now();
+  auto it = m_entries.find(interest.getName());
+  if (it != m_entries.end()) {
+    // the previous response did not satisfy this Interest; keep the entry's expiry time
+    it->second.data = std::move(data);
+    return;
+  }
+
+  m_entries.emplace(interest.getName(), Entry{now, std::move(data)});
+  m_expiryQueue.emplace_back(now, interest.getName());
+}
+
+void
+PendingResponseTable::expire(time::steady_clock::TimePoint now)
+{
+  while (!m_expiryQueue.empty() && now - m_expiryQueue.front().first >= m_window) {
+    m_entries.erase(m_expiryQueue.front().second);
+    m_expiryQueue.pop_front();
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const PendingResponseTable& table)
+{
+  return os << table.getNResponses() << " segments sent, "
+            << table.getNAggregated() << " duplicates answered from the aggregation window";
+}
+
+} // namespace chunks
+} // namespace ndn
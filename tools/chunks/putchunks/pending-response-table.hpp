@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_PENDING_RESPONSE_TABLE_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_PENDING_RESPONSE_TABLE_HPP
+
+#include "core/common.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Short-lived record of the segments recently sent by a producer
+ *
+ * Used to coalesce bursts of identical Interests that the forwarder did not aggregate, e.g.
+ * from several consumers behind a multicast strategy: after a segment is sent, further
+ * Interests for it within the aggregation window are answered with the same, already encoded
+ * Data, without looking up, decoding, or encoding the segment again.
+ */
+class PendingResponseTable : noncopyable
+{
+public:
+  /**
+   * @param window aggregation window; zero disables aggregation
+   */
+  explicit
+  PendingResponseTable(time::milliseconds window);
+
+  /**
+   * @brief find the Data sent within the aggregation window in response to an Interest with
+   *        the same name as @p interest
+   * @return the Data, if it also satisfies @p interest; otherwise nullptr
+   */
+  shared_ptr<const Data>
+  find(const Interest& interest);
+
+  /**
+   * @brief record that @p data was sent in response to @p interest
+   */
+  void
+  insert(const Interest& interest, shared_ptr<const Data> data);
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @brief number of Interests answered with a newly looked up segment
+   */
+  uint64_t
+  getNResponses() const
+  {
+    return m_nResponses;
+  }
+
+  /**
+   * @brief number of duplicate Interests answered with the Data found in the table
+   */
+  uint64_t
+  getNAggregated() const
+  {
+    return m_nAggregated;
+  }
+
+private:
+  void
+  expire(time::steady_clock::TimePoint now);
+
+private:
+  time::milliseconds m_window;
+  struct Entry
+  {
+    time::steady_clock::TimePoint sent;
+    shared_ptr<const Data> data;
+  };
+
+  std::unordered_map<Name, Entry> m_entries; ///< Interest name => response
+  std::deque<std::pair<time::steady_clock::TimePoint, Name>> m_expiryQueue; ///< oldest first
+
+  uint64_t m_nResponses = 0;
+  uint64_t m_nAggregated = 0;
+};
+
+/**
+ * @brief print a one-line summary of the table counters
+ */
+std::ostream&
+operator<<(std::ostream& os, const PendingResponseTable& table);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_PENDING_RESPONSE_TABLE_HPP
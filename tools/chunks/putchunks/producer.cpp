@@ -29,16 +29,25 @@
  */
 
 #include "producer.hpp"
+#include "segmenter.hpp"
+#include "tools/chunks/common/parity.hpp"
 
 #include <ndn-cxx/metadata-object.hpp>
 #include <ndn-cxx/security/signing-helpers.hpp>
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
 namespace ndn {
 namespace chunks {
 
+const char Producer::STORE_FILE_NAME[] = "segments.store";
+
 Producer::Producer(const Name& prefix, Face& face, KeyChain& keyChain, std::istream& is,
                    const Options& opts)
-  : m_face(face)
+  : m_cache(opts.cacheSize, opts.cacheBytes, opts.prefetchCount)
+  , m_pendingResponses(opts.aggregationWindow)
+  , m_face(face)
   , m_keyChain(keyChain)
   , m_options(opts)
 {
@@ -51,7 +60,29 @@ Producer::Producer(const Name& prefix, Face& face, KeyChain& keyChain, std::istr
     m_versionedPrefix = Name(m_prefix).appendVersion();
   }
 
-  populateStore(is);
+  if (m_options.storeDir.empty()) {
+    populateStore(is);
+  }
+  else {
+    auto path = (boost::filesystem::path(m_options.storeDir) / STORE_FILE_NAME).string();
+    if (boost::filesystem::exists(path)) {
+      m_segmentFile = make_unique<SegmentFile>(path);
+      const Name& storedName = m_segmentFile->getVersionedName();
+      if (storedName.getPrefix(-1) != m_prefix ||
+          (!prefix.empty() && prefix[-1].isVersion() && storedName != prefix)) {
+        NDN_THROW(SegmentFile::Error(path + " contains " + storedName.toUri() +
+                                     ", which does not match " + prefix.toUri()));
+      }
+      m_versionedPrefix = storedName;
+      if (!m_options.isQuiet)
+        std::cerr << "Loaded " << m_segmentFile->size() << " chunks from " << path << std::endl;
+    }
+    else {
+      populateStore(is);
+      boost::filesystem::create_directories(m_options.storeDir);
+      SegmentFile::write(path, m_versionedPrefix, m_store);
+    }
+  }
 
   if (m_options.wantShowVersion)
     std::cout << m_versionedPrefix[-1] << std::endl;
@@ -108,24 +139,37 @@ Producer::processDiscoveryInterest(const Interest& interest)
 void
 Producer::processSegmentInterest(const Interest& interest)
 {
-  BOOST_ASSERT(m_store.size() > 0);
+  BOOST_ASSERT(getSegmentCount() > 0);
 
   if (m_options.isVerbose)
     std::cerr << "Interest: " << interest << std::endl;
 
-  const Name& name = interest.getName();
-  shared_ptr<Data> data;
+  auto data = m_pendingResponses.find(interest);
+  if (data != nullptr) {
+    if (m_options.isVerbose)
+      std::cerr << "Duplicate Interest within the aggregation window, resending Data" << std::endl;
+    m_face.put(*data);
+    return;
+  }
 
-  if (name.size() == m_versionedPrefix.size() + 1 && name[-1].isSegment()) {
+  const Name& name = interest.getName();
+  if (m_options.fecBlockSize > 0 && name.size() == m_versionedPrefix.size() + 2 &&
+      name[-2] == PARITY_COMPONENT && name[-1].isSegment()) {
+    data = getParitySegment(name[-1].toSegment());
+  }
+  else if (name.size() == m_versionedPrefix.size() + 1 && name[-1].isSegment()) {
     const auto segmentNo = static_cast<size_t>(interest.getName()[-1].toSegment());
     // specific segment retrieval
-    if (segmentNo < m_store.size()) {
-      data = m_store[segmentNo];
+    if (segmentNo < getSegmentCount()) {
+      data = getSegment(segmentNo);
     }
   }
-  else if (interest.matchesData(*m_store[0])) {
-    // unspecified version or segment number, return first segment
-    data = m_store[0];
+  else {
+    auto first = getSegment(0);
+    if (first != nullptr && interest.matchesData(*first)) {
+      // unspecified version or segment number, return first segment
+      data = std::move(first);
+    }
   }
 
   if (data != nullptr) {
@@ -133,6 +177,7 @@ Producer::processSegmentInterest(const Interest& interest)
       std::cerr << "Data: " << *data << std::endl;
 
     m_face.put(*data);
+    m_pendingResponses.insert(interest, std::move(data));
   }
   else {
     if (m_options.isVerbose)
@@ -149,60 +194,84 @@ Producer::populateStore(std::istream& is)
   if (!m_options.isQuiet)
     std::cerr << "Loading input ..." << std::endl;
 
-  std::vector<uint8_t> buffer(m_options.maxSegmentSize - 32);
-  while (is.good()) {
-    is.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-    const auto nCharsRead = is.gcount();
-
-    if (nCharsRead > 0) {
-      auto data = make_shared<Data>(Name(m_versionedPrefix).appendSegment(m_store.size()));
-      data->setFreshnessPeriod(m_options.freshnessPeriod);
-      Block content(tlv::Content);
-      Block realContent = makeBinaryBlock(tlv::Content, buffer.data(), nCharsRead);
-      content.push_back(realContent);
-      data->setContent(content);
-
-      // data->setContent(buffer.data(), static_cast<size_t>(nCharsRead));
-      m_store.push_back(data);
-    }
-  }
-
+  m_startTime = time::steady_clock::now();
 
-  if (m_store.empty()) {
-    auto data = make_shared<Data>(Name(m_versionedPrefix).appendSegment(0));
-    data->setFreshnessPeriod(m_options.freshnessPeriod);
-    m_store.push_back(data);
-  }
+  m_store = makeChainedSegments(m_versionedPrefix, is, m_options);
+  m_keyChain.sign(*m_store.front(), m_options.signingInfo);
 
-  m_startTime = time::steady_clock::now();
+  boost::chrono::duration<double, boost::chrono::seconds::period> timeElapsed = time::steady_clock::now() - m_startTime;
+  
+  std::cout << "Time elapsed: " << timeElapsed << std::endl;
 
-  auto finalBlockId = name::Component::fromSegment(m_store.size() - 1);
+  if (!m_options.isQuiet)
+    std::cerr << "Created " << m_store.size() << " chunks for prefix " << m_prefix << std::endl;
+}
 
-  Block nextHash(tlv::SignatureValue);
-  for (auto it = m_store.rbegin(); it != m_store.rend(); it++) {
-    Data& data = **it;
-    data.setFinalBlock(finalBlockId); 
+size_t
+Producer::getSegmentCount() const
+{
+  return m_segmentFile != nullptr ? m_segmentFile->size() : m_store.size();
+}
 
-    auto content = data.getContent();
-    content.push_back(nextHash);
+shared_ptr<const Data>
+Producer::getSegment(size_t segNo)
+{
+  if (m_segmentFile == nullptr) {
+    return m_store[segNo];
+  }
 
-    data.setContent(content);
+  return m_cache.get(m_versionedPrefix, segNo, [this] (uint64_t i) -> shared_ptr<const Data> {
+    if (i >= m_segmentFile->size()) {
+      return nullptr;
+    }
 
-    if (it == m_store.rend() - 1) {
-      m_keyChain.sign(data);
-    } else {
-      m_keyChain.sign(data, ndn::signingWithSha256());
+    try {
+      return make_shared<Data>(m_segmentFile->getSegment(static_cast<size_t>(i)));
+    }
+    catch (const tlv::Error& e) {
+      std::cerr << "ERROR: segment " << i << " of "
+                << (boost::filesystem::path(m_options.storeDir) / STORE_FILE_NAME).string()
+                << " is invalid: " << e.what() << std::endl;
+      return nullptr;
     }
+  });
+}
 
-    nextHash = data.getSignatureValue(); //32byte
+shared_ptr<const Data>
+Producer::getParitySegment(uint64_t blockNo)
+{
+  BOOST_ASSERT(m_options.fecBlockSize > 0);
+  const uint64_t blockSize = m_options.fecBlockSize;
+  const uint64_t nSegments = getSegmentCount();
+  const uint64_t nBlocks = (nSegments + blockSize - 1) / blockSize;
+  if (blockNo >= nBlocks) {
+    return nullptr;
   }
-  
-  boost::chrono::duration<double, boost::chrono::seconds::period> timeElapsed = time::steady_clock::now() - m_startTime;
-  
-  std::cout << "Time elapsed: " << timeElapsed << std::endl;
 
-  if (!m_options.isQuiet)
-    std::cerr << "Created " << m_store.size() << " chunks for prefix " << m_prefix << std::endl;
+  Name name = makeParityName(m_versionedPrefix, blockNo);
+  auto data = m_cache.find(name);
+  if (data != nullptr) {
+    return data;
+  }
+
+  std::vector<Block> segments;
+  for (uint64_t segNo = blockNo * blockSize; segNo < std::min((blockNo + 1) * blockSize, nSegments); ++segNo) {
+    auto segment = getSegment(segNo);
+    if (segment == nullptr) {
+      return nullptr;
+    }
+    segments.push_back(segment->wireEncode());
+  }
+  auto parity = computeParity(segments);
+
+  auto parityData = make_shared<Data>(name);
+  parityData->setFreshnessPeriod(m_options.freshnessPeriod);
+  parityData->setFinalBlock(name::Component::fromSegment(nBlocks - 1));
+  parityData->setContent(parity.data(), parity.size());
+  m_keyChain.sign(*parityData, signingWithSha256());
+
+  m_cache.insert(parityData);
+  return parityData;
 }
 
 void
@@ -211,6 +280,8 @@ Producer::onRegisterFailed(const Name& prefix, const std::string& reason)
   std::cerr << "ERROR: Failed to register prefix '"
             << prefix << "' (" << reason << ")" << std::endl;
   m_face.shutdown();
+  // also return from run() while other handlers, e.g. signal waits, are still pending
+  m_face.getIoService().stop();
 }
 
 } // namespace chunks
@@ -30,7 +30,10 @@
 #ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_PRODUCER_HPP
 #define NDN_TOOLS_CHUNKS_PUTCHUNKS_PRODUCER_HPP
 
-#include "core/common.hpp"
+#include "pending-response-table.hpp"
+#include "segment-cache.hpp"
+#include "segment-file.hpp"
+#include "tools/chunks/common/segment-codec.hpp"
 
 namespace ndn {
 namespace chunks {
@@ -41,6 +44,8 @@ namespace chunks {
  * Packetizes and publishes data from an input stream under /prefix/<version>/<segment number>.
  * The current time is used as the version number. The store has always at least one element (also
  * with empty input stream).
+ *
+ * If Options::fecBlockSize is set, parity segments are computed when first requested.
  */
 class Producer : noncopyable
 {
@@ -53,14 +58,34 @@ public:
     bool isQuiet = false;
     bool isVerbose = false;
     bool wantShowVersion = false;
+    std::string storeDir; ///< if not empty, persist the signed segments in this directory
+    size_t cacheSize = 1024; ///< number of segments read from a segment file kept in memory
+    size_t cacheBytes = 0; ///< if not zero, maximum total size of the cached segments, in bytes
+    size_t prefetchCount = 0; ///< number of segments read ahead of a sequential cache miss
+    Codec codec = Codec::None; ///< compression applied to the payload of each segment
+    size_t fecBlockSize = 0; ///< if not zero, serve a parity segment for every block of this
+                             ///< many segments (see PARITY_COMPONENT)
+    time::milliseconds aggregationWindow{0}; ///< if not zero, Interests for a segment sent
+                                             ///< less than this long ago are answered with
+                                             ///< the Data already sent
   };
 
+  /// name of the segment file in Options::storeDir
+  static const char STORE_FILE_NAME[];
+
 public:
   /**
    * @brief Create the Producer
    *
    * @param prefix prefix used to publish data; if the last component is not a valid
    *               version number, the current system time is used as version number.
+   *
+   * If @p opts.storeDir contains a segment file, the segments and the version are loaded from
+   * that file and @p is is not read. Otherwise, the segments created from @p is are written
+   * to a new segment file in @p opts.storeDir, so that the next run can skip signing.
+   *
+   * @throw SegmentFile::Error the segment file is invalid, cannot be written, or was created
+   *                           for a different prefix
    */
   Producer(const Name& prefix, Face& face, KeyChain& keyChain, std::istream& is,
            const Options& opts);
@@ -71,6 +96,28 @@ public:
   void
   run();
 
+  /**
+   * @brief whether the segments are served from a segment file in Options::storeDir, through
+   *        the segment cache
+   */
+  bool
+  isServingSegmentFile() const
+  {
+    return m_segmentFile != nullptr;
+  }
+
+  const SegmentCache&
+  getCache() const
+  {
+    return m_cache;
+  }
+
+  const PendingResponseTable&
+  getPendingResponses() const
+  {
+    return m_pendingResponses;
+  }
+
 private:
   /**
    * @brief Split the input stream in data packets and save them to the store
@@ -100,8 +147,29 @@ private:
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
 
+  size_t
+  getSegmentCount() const;
+
+  /**
+   * @pre segNo < getSegmentCount()
+   * @return the segment, or nullptr if it cannot be decoded from the segment file
+   */
+  shared_ptr<const Data>
+  getSegment(size_t segNo);
+
+  /**
+   * @return the parity segment of block @p blockNo, or nullptr if there is no such block or
+   *         one of its segments cannot be decoded
+   */
+  shared_ptr<const Data>
+  getParitySegment(uint64_t blockNo);
+
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   std::vector<shared_ptr<Data>> m_store;
+  unique_ptr<SegmentFile> m_segmentFile; ///< if set, segments are served from this file
+                                         ///< instead of m_store
+  SegmentCache m_cache; ///< recently served segments of m_segmentFile, and parity segments
+  PendingResponseTable m_pendingResponses;
 
 private:
   Name m_prefix;
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "segment-cache.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace chunks {
+
+SegmentCache::SegmentCache(size_t capacity, size_t maxBytes, size_t prefetchCount)
+  : m_capacity(capacity)
+  , m_maxBytes(maxBytes)
+  // the prefetched segments and the one requested must all fit in the cache
+  , m_prefetchCount(capacity > 0 ? std::min(prefetchCount, capacity - 1) : 0)
+{
+}
+
+shared_ptr<const Data>
+SegmentCache::find(const Name& name)
+{
+  auto it = m_index.find(name);
+  if (it == m_index.end()) {
+    ++m_nMisses;
+    return nullptr;
+  }
+
+  ++m_nHits;
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  return *it->second;
+}
+
+shared_ptr<const Data>
+SegmentCache::get(const Name& versionedName, uint64_t segNo, const Loader& load)
+{
+  auto data = find(Name(versionedName).appendSegment(segNo));
+  if (data != nullptr) {
+    return data;
+  }
+
+  data = load(segNo);
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  bool isSequential = segNo == 0 || m_index.count(Name(versionedName).appendSegment(segNo - 1)) > 0;
+  insert(data);
+
+  if (isSequential) {
+    // stop before a prefetched segment would evict the requested one or an earlier prefetched one
+    size_t nBytes = data->wireEncode().size();
+    for (uint64_t next = segNo + 1; next <= segNo + m_prefetchCount; ++next) {
+      if (m_index.count(Name(versionedName).appendSegment(next)) > 0) {
+        continue;
+      }
+      auto nextData = load(next);
+      if (nextData == nullptr) {
+        break;
+      }
+      nBytes += nextData->wireEncode().size();
+      if (m_maxBytes > 0 && nBytes > m_maxBytes) {
+        break;
+      }
+      insert(std::move(nextData));
+      ++m_nPrefetched;
+    }
+  }
+
+  return data;
+}
+
+void
+SegmentCache::insert(shared_ptr<const Data> data)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+
+  const size_t nBytes = data->wireEncode().size();
+  auto it = m_index.find(data->getName());
+  if (it != m_index.end()) {
+    m_nBytes -= (*it->second)->wireEncode().size();
+    *it->second = std::move(data);
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+  }
+  else {
+    m_entries.push_front(std::move(data));
+    m_index.emplace(m_entries.front()->getName(), m_entries.begin());
+  }
+  m_nBytes += nBytes;
+
+  evict();
+}
+
+void
+SegmentCache::evict()
+{
+  while (!m_entries.empty() &&
+         (m_entries.size() > m_capacity || (m_maxBytes > 0 && m_nBytes > m_maxBytes))) {
+    m_nBytes -= m_entries.back()->wireEncode().size();
+    m_index.erase(m_entries.back()->getName());
+    m_entries.pop_back();
+    ++m_nEvictions;
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const SegmentCache& cache)
+{
+  uint64_t nLookups = cache.getNHits() + cache.getNMisses();
+  return os << cache.getNHits() << " hits, " << cache.getNMisses() << " misses ("
+            << (nLookups == 0 ? 0 : cache.getNHits() * 100.0 / nLookups) << "% hit ratio), "
+            << cache.getNPrefetched() << " prefetched, " << cache.getNEvictions() << " evicted, "
+            << cache.size() << " segments (" << cache.getBytes() << " bytes) cached";
+}
+
+} // namespace chunks
+} // namespace ndn
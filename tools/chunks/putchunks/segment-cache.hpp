@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_CACHE_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_CACHE_HPP
+
+#include "core/common.hpp"
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Least-recently-used cache of decoded segments, indexed by Data name
+ *
+ * The cache is bounded both by the number of segments and, optionally, by their total encoded
+ * size. When get() misses on a segment that continues a sequential read (segment 0, or a
+ * segment whose predecessor is cached), the following segments are loaded too, so that a
+ * consumer reading the object in order hits the cache.
+ */
+class SegmentCache : noncopyable
+{
+public:
+  using Loader = std::function<shared_ptr<const Data>(uint64_t segNo)>;
+
+  /**
+   * @param capacity maximum number of segments kept in the cache
+   * @param maxBytes if not zero, maximum total size of the wire encoding of the cached segments
+   * @param prefetchCount number of segments loaded ahead of a sequential miss, at most
+   *                      @p capacity - 1; fewer are loaded if they would exceed @p maxBytes
+   */
+  explicit
+  SegmentCache(size_t capacity, size_t maxBytes = 0, size_t prefetchCount = 0);
+
+  /**
+   * @brief return the segment named @p name and mark it as most recently used
+   * @return the segment, or nullptr if it is not in the cache
+   */
+  shared_ptr<const Data>
+  find(const Name& name);
+
+  /**
+   * @brief return segment @p segNo of @p versionedName, calling @p load on a miss
+   *
+   * @p load must return nullptr if the segment does not exist.
+   * @return the segment, or nullptr if it does not exist
+   */
+  shared_ptr<const Data>
+  get(const Name& versionedName, uint64_t segNo, const Loader& load);
+
+  /**
+   * @brief insert @p data, evicting the least recently used segments if the cache is full
+   */
+  void
+  insert(shared_ptr<const Data> data);
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @brief total size of the wire encoding of the cached segments, in bytes
+   */
+  size_t
+  getBytes() const
+  {
+    return m_nBytes;
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+  uint64_t
+  getNPrefetched() const
+  {
+    return m_nPrefetched;
+  }
+
+  uint64_t
+  getNEvictions() const
+  {
+    return m_nEvictions;
+  }
+
+private:
+  void
+  evict();
+
+private:
+  using EntryList = std::list<shared_ptr<const Data>>;
+
+  size_t m_capacity;
+  size_t m_maxBytes;
+  size_t m_prefetchCount;
+  EntryList m_entries; ///< most recently used first
+  std::unordered_map<Name, EntryList::iterator> m_index;
+  size_t m_nBytes = 0;
+
+  uint64_t m_nHits = 0;
+  uint64_t m_nMisses = 0;
+  uint64_t m_nPrefetched = 0;
+  uint64_t m_nEvictions = 0;
+};
+
+/**
+ * @brief print a one-line summary of the cache counters
+ */
+std::ostream&
+operator<<(std::ostream& os, const SegmentCache& cache);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_CACHE_HPP
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "segment-file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <boost/endian/conversion.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace chunks {
+
+constexpr uint32_t SegmentFile::FORMAT_VERSION;
+
+static const char SEGMENT_FILE_MAGIC[] = {'N', 'D', 'N', 'S', 'E', 'G', 'M', 'T'};
+static constexpr size_t FIXED_HEADER_SIZE = sizeof(SEGMENT_FILE_MAGIC) + 4 + 4 + 8;
+
+template<typename T>
+static T
+readLittle(const uint8_t* p)
+{
+  T value;
+  std::memcpy(&value, p, sizeof(value));
+  return boost::endian::little_to_native(value);
+}
+
+template<typename T>
+static void
+writeLittle(std::ostream& os, T value)
+{
+  boost::endian::native_to_little_inplace(value);
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+SegmentFile::SegmentFile(const std::string& path)
+{
+  int fd = ::open(path.data(), O_RDONLY);
+  if (fd < 0) {
+    NDN_THROW_ERRNO(Error("Cannot open " + path));
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    NDN_THROW_ERRNO(Error("Cannot stat " + path));
+  }
+  m_size = static_cast<size_t>(st.st_size);
+
+  if (m_size < FIXED_HEADER_SIZE) {
+    ::close(fd);
+    NDN_THROW(Error(path + " is not a segment file (too short)"));
+  }
+
+  void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    NDN_THROW_ERRNO(Error("Cannot map " + path));
+  }
+  m_begin = static_cast<const uint8_t*>(addr);
+
+  try {
+    if (std::memcmp(m_begin, SEGMENT_FILE_MAGIC, sizeof(SEGMENT_FILE_MAGIC)) != 0) {
+      NDN_THROW(Error(path + " is not a segment file (bad magic)"));
+    }
+    const uint8_t* p = m_begin + sizeof(SEGMENT_FILE_MAGIC);
+    auto version = readLittle<uint32_t>(p);
+    if (version != FORMAT_VERSION) {
+      NDN_THROW(Error(path + " has unsupported format version " + std::to_string(version)));
+    }
+    auto nameLength = readLittle<uint32_t>(p + 4);
+    m_nSegments = readLittle<uint64_t>(p + 8);
+
+    // check sizes before any arithmetic that could overflow
+    size_t remaining = m_size - FIXED_HEADER_SIZE;
+    if (nameLength > remaining || m_nSegments >= (remaining - nameLength) / 8) {
+      NDN_THROW(Error(path + " is truncated"));
+    }
+    if (m_nSegments == 0) {
+      NDN_THROW(Error(path + " contains no segments"));
+    }
+
+    const uint8_t* nameBegin = m_begin + FIXED_HEADER_SIZE;
+    try {
+      m_versionedName.wireDecode(Block(nameBegin, nameLength));
+    }
+    catch (const tlv::Error&) {
+      NDN_THROW_NESTED(Error(path + " contains an invalid name"));
+    }
+
+    m_offsets = nameBegin + nameLength;
+    uint64_t dataBegin = static_cast<uint64_t>(m_offsets - m_begin) + (m_nSegments + 1) * 8;
+    uint64_t prev = dataBegin;
+    for (size_t i = 0; i <= m_nSegments; ++i) {
+      uint64_t offset = getOffset(i);
+      if (offset < prev || offset > m_size || (i == 0 && offset != dataBegin)) {
+        NDN_THROW(Error(path + " has an invalid offset table"));
+      }
+      prev = offset;
+    }
+  }
+  catch (const Error&) {
+    ::munmap(const_cast<uint8_t*>(m_begin), m_size);
+    throw;
+  }
+}
+
+SegmentFile::~SegmentFile()
+{
+  ::munmap(const_cast<uint8_t*>(m_begin), m_size);
+}
+
+Block
+SegmentFile::getSegment(size_t segNo) const
+{
+  BOOST_ASSERT(segNo < m_nSegments);
+  uint64_t begin = getOffset(segNo);
+  return Block(m_begin + begin, static_cast<size_t>(getOffset(segNo + 1) - begin));
+}
+
+uint64_t
+SegmentFile::getOffset(size_t i) const
+{
+  return readLittle<uint64_t>(m_offsets + i * 8);
+}
+
+Name
+SegmentFile::readVersionedName(const std::string& path)
+{
+  std::ifstream is(path, std::ios::binary);
+  if (!is) {
+    NDN_THROW(Error("Cannot open " + path));
+  }
+
+  uint8_t header[FIXED_HEADER_SIZE];
+  if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+      std::memcmp(header, SEGMENT_FILE_MAGIC, sizeof(SEGMENT_FILE_MAGIC)) != 0) {
+    NDN_THROW(Error(path + " is not a segment file"));
+  }
+  auto version = readLittle<uint32_t>(header + sizeof(SEGMENT_FILE_MAGIC));
+  if (version != FORMAT_VERSION) {
+    NDN_THROW(Error(path + " has unsupported format version " + std::to_string(version)));
+  }
+
+  auto nameLength = readLittle<uint32_t>(header + sizeof(SEGMENT_FILE_MAGIC) + 4);
+  if (nameLength > MAX_NDN_PACKET_SIZE) {
+    NDN_THROW(Error(path + " contains an invalid name"));
+  }
+  std::vector<uint8_t> nameWire(nameLength);
+  if (!is.read(reinterpret_cast<char*>(nameWire.data()), nameWire.size())) {
+    NDN_THROW(Error(path + " is truncated"));
+  }
+
+  try {
+    return Name(Block(nameWire.data(), nameWire.size()));
+  }
+  catch (const tlv::Error&) {
+    NDN_THROW_NESTED(Error(path + " contains an invalid name"));
+  }
+}
+
+void
+SegmentFile::write(const std::string& path, const Name& versionedName,
+                   const std::vector<shared_ptr<Data>>& segments)
+{
+  if (segments.empty()) {
+    NDN_THROW(Error("Cannot write " + path + " without segments"));
+  }
+
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+    const Block& name = versionedName.wireEncode();
+    os.write(SEGMENT_FILE_MAGIC, sizeof(SEGMENT_FILE_MAGIC));
+    writeLittle<uint32_t>(os, FORMAT_VERSION);
+    writeLittle<uint32_t>(os, static_cast<uint32_t>(name.size()));
+    writeLittle<uint64_t>(os, segments.size());
+    os.write(reinterpret_cast<const char*>(name.wire()), name.size());
+
+    uint64_t offset = FIXED_HEADER_SIZE + name.size() + (segments.size() + 1) * 8;
+    writeLittle<uint64_t>(os, offset);
+    for (const auto& data : segments) {
+      offset += data->wireEncode().size();
+      writeLittle<uint64_t>(os, offset);
+    }
+    for (const auto& data : segments) {
+      const Block& wire = data->wireEncode();
+      os.write(reinterpret_cast<const char*>(wire.wire()), wire.size());
+    }
+
+    os.flush();
+    if (!os) {
+      std::remove(tmpPath.data());
+      NDN_THROW(Error("Cannot write " + tmpPath));
+    }
+  }
+
+  if (std::rename(tmpPath.data(), path.data()) != 0) {
+    std::remove(tmpPath.data());
+    NDN_THROW_ERRNO(Error("Cannot rename " + tmpPath + " to " + path));
+  }
+}
+
+} // namespace chunks
+} // namespace ndn
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_FILE_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_FILE_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Read-only, memory-mapped file of encoded and signed segments
+ *
+ * The file starts with a header containing the magic string "NDNSEGMT", the format version
+ * (uint32), the length of the versioned name (uint32), the number of segments N (uint64),
+ * and the TLV encoding of the versioned name. It is followed by a table of N + 1 offsets
+ * (uint64) from the beginning of the file, where segment i occupies the bytes between
+ * offsets i and i + 1, and finally by the wire encoding of all segments.
+ * All integers are little-endian.
+ */
+class SegmentFile : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  /**
+   * @brief map the file at @p path and check its header and offset table
+   * @throw Error the file cannot be read or is not a valid segment file
+   */
+  explicit
+  SegmentFile(const std::string& path);
+
+  ~SegmentFile();
+
+  const Name&
+  getVersionedName() const
+  {
+    return m_versionedName;
+  }
+
+  size_t
+  size() const
+  {
+    return m_nSegments;
+  }
+
+  /**
+   * @brief return the wire encoding of segment @p segNo
+   * @pre segNo < size()
+   * @throw tlv::Error the segment is not a valid TLV element
+   */
+  Block
+  getSegment(size_t segNo) const;
+
+  /**
+   * @brief read only the versioned name from the header of the segment file at @p path
+   *
+   * This is much cheaper than mapping the whole file and is meant for indexing many files.
+   * @throw Error the file cannot be read or does not start with a valid header
+   */
+  static Name
+  readVersionedName(const std::string& path);
+
+  /**
+   * @brief write @p segments, published under @p versionedName, to a segment file at @p path
+   *
+   * The file is first written under a temporary name and then renamed, so that an interrupted
+   * write never leaves a truncated segment file behind.
+   * @throw Error @p segments is empty, or the file cannot be written
+   */
+  static void
+  write(const std::string& path, const Name& versionedName,
+        const std::vector<shared_ptr<Data>>& segments);
+
+private:
+  uint64_t
+  getOffset(size_t i) const;
+
+private:
+  const uint8_t* m_begin = nullptr;
+  size_t m_size = 0;
+  Name m_versionedName;
+  uint64_t m_nSegments = 0;
+  const uint8_t* m_offsets = nullptr;
+};
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENT_FILE_HPP
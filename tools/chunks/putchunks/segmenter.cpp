@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#include "segmenter.hpp"
+
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+namespace ndn {
+namespace chunks {
+
+static void
+signWithDigest(Data& data)
+{
+  data.setSignatureInfo(SignatureInfo(tlv::DigestSha256));
+
+  EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  auto digest = util::Sha256::computeDigest(encoder.buf(), encoder.size());
+  data.wireEncode(encoder, makeBinaryBlock(tlv::SignatureValue, digest->data(), digest->size()));
+}
+
+std::vector<shared_ptr<Data>>
+makeChainedSegments(const Name& versionedPrefix, std::istream& is,
+                    const Producer::Options& opts)
+{
+  std::vector<shared_ptr<Data>> segments;
+
+  std::vector<uint8_t> buffer(opts.maxSegmentSize - 32);
+  while (is.good()) {
+    is.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    const auto nCharsRead = is.gcount();
+
+    if (nCharsRead > 0) {
+      auto data = make_shared<Data>(Name(versionedPrefix).appendSegment(segments.size()));
+      data->setFreshnessPeriod(opts.freshnessPeriod);
+      uint32_t contentType = tlv::ContentType_Blob;
+      auto payload = encodePayload(opts.codec, buffer.data(), static_cast<size_t>(nCharsRead),
+                                   contentType);
+      data->setContentType(contentType);
+      Block content(tlv::Content);
+      content.push_back(makeBinaryBlock(tlv::Content, payload.data(), payload.size()));
+      data->setContent(content);
+      segments.push_back(data);
+    }
+  }
+
+  if (segments.empty()) {
+    auto data = make_shared<Data>(Name(versionedPrefix).appendSegment(0));
+    data->setFreshnessPeriod(opts.freshnessPeriod);
+    segments.push_back(data);
+  }
+
+  auto finalBlockId = name::Component::fromSegment(segments.size() - 1);
+
+  Block nextHash(tlv::SignatureValue);
+  for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+    Data& data = **it;
+    data.setFinalBlock(finalBlockId);
+
+    auto content = data.getContent();
+    content.push_back(nextHash);
+    data.setContent(content);
+
+    if (it != segments.rend() - 1) {
+      signWithDigest(data);
+      nextHash = data.getSignatureValue();
+    }
+  }
+
+  return segments;
+}
+
+} // namespace chunks
+} // namespace ndn
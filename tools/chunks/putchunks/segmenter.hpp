@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California,
+ *                     Colorado State University,
+ *                     University Pierre & Marie Curie, Sorbonne University.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * See AUTHORS.md for complete list of ndn-cxx authors and contributors.
+ */
+
+#ifndef NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENTER_HPP
+#define NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENTER_HPP
+
+#include "producer.hpp"
+
+namespace ndn {
+namespace chunks {
+
+/**
+ * @brief Split the input stream in data packets linked by a hash chain
+ *
+ * Each segment carries up to @p opts.maxSegmentSize - 32 bytes read from @p is, followed by
+ * the signature value of the next segment (empty for the last one). If @p opts.codec is set,
+ * each payload is compressed on its own and the codec is signaled in the ContentType of the
+ * segment; payloads that do not shrink are left uncompressed. An empty segment is
+ * created if the input stream is empty. Every segment except the first is signed with a
+ * SHA-256 digest; the first segment is left unsigned, and must be signed by the caller with
+ * @p opts.signingInfo.
+ *
+ * This function does not use a KeyChain, so it can run concurrently on several threads.
+ */
+std::vector<shared_ptr<Data>>
+makeChainedSegments(const Name& versionedPrefix, std::istream& is,
+                    const Producer::Options& opts);
+
+} // namespace chunks
+} // namespace ndn
+
+#endif // NDN_TOOLS_CHUNKS_PUTCHUNKS_SEGMENTER_HPP
@@ -0,0 +1,357 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "capture-file.hpp"
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ndn {
+namespace dump {
+
+namespace endian = boost::endian;
+
+// pcap file header and record header
+const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+const uint32_t PCAP_MAGIC_NSEC = 0xa1b23c4d;
+const size_t PCAP_FILE_HEADER_SIZE = 24;
+const size_t PCAP_RECORD_HEADER_SIZE = 16;
+
+// pcapng block types, block framing, and options
+const uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+const uint32_t PCAPNG_INTERFACE_DESCRIPTION = 1;
+const uint32_t PCAPNG_SIMPLE_PACKET = 3;
+const uint32_t PCAPNG_ENHANCED_PACKET = 6;
+const size_t PCAPNG_BLOCK_OVERHEAD = 12; ///< type, and total length before and after the body
+const uint16_t PCAPNG_OPT_END = 0;
+const uint16_t PCAPNG_OPT_IF_TSRESOL = 9;
+const uint16_t PCAPNG_OPT_IF_TSOFFSET = 14;
+
+static uint32_t
+readNative32(const uint8_t* pos)
+{
+  uint32_t value = 0;
+  std::memcpy(&value, pos, sizeof(value));
+  return value;
+}
+
+CaptureFile::CaptureFile(const std::string& filename, size_t chunkSize)
+{
+  int fd = ::open(filename.data(), O_RDONLY);
+  if (fd < 0) {
+    NDN_THROW(Error("Cannot open file '" + filename + "': " + std::strerror(errno)));
+  }
+
+  struct stat st{};
+  if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size < 4) {
+    ::close(fd);
+    NDN_THROW(Error("'" + filename + "' is not a capture file"));
+  }
+  m_size = static_cast<size_t>(st.st_size);
+
+  void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int mmapErrno = errno;
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    NDN_THROW(Error("Cannot map file '" + filename + "': " + std::strerror(mmapErrno)));
+  }
+  m_data = static_cast<const uint8_t*>(data);
+  // each chunk is read sequentially
+  ::madvise(data, m_size, MADV_SEQUENTIAL);
+
+  try {
+    uint32_t magic = readNative32(m_data);
+    if (magic == PCAPNG_SECTION_HEADER) {
+      m_isPcapng = true;
+      indexPcapng(chunkSize);
+    }
+    else {
+      indexPcap(chunkSize);
+    }
+  }
+  catch (const Error&) {
+    ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    throw;
+  }
+}
+
+CaptureFile::~CaptureFile()
+{
+  ::munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+uint32_t
+CaptureFile::read32(const Section& section, const uint8_t* pos) const
+{
+  uint32_t value = readNative32(pos);
+  return section.isSwapped ? endian::endian_reverse(value) : value;
+}
+
+uint16_t
+CaptureFile::read16(const Section& section, const uint8_t* pos) const
+{
+  uint16_t value = 0;
+  std::memcpy(&value, pos, sizeof(value));
+  return section.isSwapped ? endian::endian_reverse(value) : value;
+}
+
+void
+CaptureFile::indexPcap(size_t chunkSize)
+{
+  if (m_size < PCAP_FILE_HEADER_SIZE) {
+    NDN_THROW(Error("Truncated pcap file header"));
+  }
+
+  Section section;
+  uint32_t magic = readNative32(m_data);
+  if (magic == PCAP_MAGIC || magic == PCAP_MAGIC_NSEC) {
+    section.isSwapped = false;
+  }
+  else if (endian::endian_reverse(magic) == PCAP_MAGIC ||
+           endian::endian_reverse(magic) == PCAP_MAGIC_NSEC) {
+    section.isSwapped = true;
+  }
+  else {
+    NDN_THROW(Error("Unknown capture file format"));
+  }
+  section.isNanosecond = read32(section, m_data) == PCAP_MAGIC_NSEC;
+  // the upper bits of the link type field carry other information
+  m_linkType = static_cast<int>(read32(section, m_data + 20) & 0xFFFF);
+  m_sections.push_back(section);
+
+  size_t chunkBegin = PCAP_FILE_HEADER_SIZE;
+  size_t pos = chunkBegin;
+  while (m_size - pos >= PCAP_RECORD_HEADER_SIZE) {
+    uint32_t capLen = read32(section, m_data + pos + 8);
+    if (capLen > m_size - pos - PCAP_RECORD_HEADER_SIZE) {
+      break;
+    }
+    pos += PCAP_RECORD_HEADER_SIZE + capLen;
+
+    if (pos - chunkBegin >= chunkSize) {
+      m_chunks.push_back({chunkBegin, pos, 0});
+      chunkBegin = pos;
+    }
+  }
+  if (pos > chunkBegin) {
+    m_chunks.push_back({chunkBegin, pos, 0});
+  }
+  m_isTruncated = pos != m_size;
+}
+
+void
+CaptureFile::indexPcapng(size_t chunkSize)
+{
+  size_t chunkBegin = 0;
+  size_t pos = 0;
+  while (m_size - pos >= PCAPNG_BLOCK_OVERHEAD) {
+    uint32_t type = readNative32(m_data + pos);
+    if (type == PCAPNG_SECTION_HEADER) {
+      // the byte order of a section is given by its header
+      Section section;
+      uint32_t magic = readNative32(m_data + pos + 8);
+      if (magic == PCAPNG_BYTE_ORDER_MAGIC) {
+        section.isSwapped = false;
+      }
+      else if (endian::endian_reverse(magic) == PCAPNG_BYTE_ORDER_MAGIC) {
+        section.isSwapped = true;
+      }
+      else {
+        NDN_THROW(Error("Invalid pcapng section header"));
+      }
+      section.isNanosecond = false;
+
+      // a chunk does not span several sections
+      if (pos > chunkBegin) {
+        m_chunks.push_back({chunkBegin, pos, m_sections.size() - 1});
+        chunkBegin = pos;
+      }
+      m_sections.push_back(std::move(section));
+    }
+    else if (m_sections.empty()) {
+      NDN_THROW(Error("pcapng file does not begin with a section header"));
+    }
+
+    Section& section = m_sections.back();
+    if (section.isSwapped) {
+      type = endian::endian_reverse(type);
+    }
+    uint32_t length = read32(section, m_data + pos + 4);
+    if (length < PCAPNG_BLOCK_OVERHEAD || length % 4 != 0 || length > m_size - pos) {
+      break;
+    }
+
+    if (type == PCAPNG_SECTION_HEADER) {
+      pos += length;
+      chunkBegin = pos;
+      continue;
+    }
+    if (type == PCAPNG_INTERFACE_DESCRIPTION) {
+      readInterface(section, m_data + pos + 8, length - PCAPNG_BLOCK_OVERHEAD);
+    }
+    pos += length;
+
+    if (pos - chunkBegin >= chunkSize) {
+      m_chunks.push_back({chunkBegin, pos, m_sections.size() - 1});
+      chunkBegin = pos;
+    }
+  }
+  if (pos > chunkBegin) {
+    m_chunks.push_back({chunkBegin, pos, m_sections.size() - 1});
+  }
+  m_isTruncated = pos != m_size;
+}
+
+void
+CaptureFile::readInterface(Section& section, const uint8_t* body, size_t size)
+{
+  if (size < 8) {
+    NDN_THROW(Error("Truncated pcapng interface description"));
+  }
+
+  Interface interface;
+  interface.linkType = read16(section, body);
+  interface.snapLen = read32(section, body + 4);
+  if (m_linkType < 0) {
+    m_linkType = interface.linkType;
+  }
+  else if (interface.linkType != m_linkType) {
+    NDN_THROW(Error("pcapng files with several link-layer types are not supported"));
+  }
+
+  const uint8_t* pos = body + 8;
+  const uint8_t* end = body + size;
+  while (end - pos >= 4) {
+    uint16_t code = read16(section, pos);
+    uint16_t length = read16(section, pos + 2);
+    pos += 4;
+    if (code == PCAPNG_OPT_END || length > end - pos) {
+      break;
+    }
+
+    if (code == PCAPNG_OPT_IF_TSRESOL && length == 1) {
+      // the most significant bit selects a power of 2 instead of a power of 10
+      uint8_t exponent = *pos & 0x7F;
+      if (*pos & 0x80) {
+        interface.unitsPerSecond = uint64_t(1) << std::min<uint8_t>(exponent, 63);
+      }
+      else {
+        interface.unitsPerSecond = 1;
+        for (uint8_t i = 0; i < std::min<uint8_t>(exponent, 19); ++i) {
+          interface.unitsPerSecond *= 10;
+        }
+      }
+    }
+    else if (code == PCAPNG_OPT_IF_TSOFFSET && length == 8) {
+      int64_t offset = 0;
+      std::memcpy(&offset, pos, sizeof(offset));
+      interface.offset = section.isSwapped ? endian::endian_reverse(offset) : offset;
+    }
+    pos += (length + 3) / 4 * 4;
+  }
+
+  section.interfaces.push_back(interface);
+}
+
+void
+CaptureFile::forEachRecord(const Chunk& chunk, const RecordCallback& onRecord) const
+{
+  if (m_isPcapng) {
+    forEachPcapngRecord(chunk, onRecord);
+  }
+  else {
+    forEachPcapRecord(chunk, onRecord);
+  }
+}
+
+void
+CaptureFile::forEachPcapRecord(const Chunk& chunk, const RecordCallback& onRecord) const
+{
+  const Section& section = m_sections.front();
+  pcap_pkthdr header{};
+  for (size_t pos = chunk.begin; pos < chunk.end; pos += PCAP_RECORD_HEADER_SIZE + header.caplen) {
+    const uint8_t* record = m_data + pos;
+    header.ts.tv_sec = read32(section, record);
+    uint32_t fraction = read32(section, record + 4);
+    header.ts.tv_usec = section.isNanosecond ? fraction / 1000 : fraction;
+    header.caplen = read32(section, record + 8);
+    header.len = read32(section, record + 12);
+    onRecord(header, record + PCAP_RECORD_HEADER_SIZE);
+  }
+}
+
+void
+CaptureFile::forEachPcapngRecord(const Chunk& chunk, const RecordCallback& onRecord) const
+{
+  const Section& section = m_sections.at(chunk.section);
+  uint32_t length = 0;
+  for (size_t pos = chunk.begin; pos < chunk.end; pos += length) {
+    uint32_t type = read32(section, m_data + pos);
+    length = read32(section, m_data + pos + 4);
+    const uint8_t* body = m_data + pos + 8;
+    size_t bodySize = length - PCAPNG_BLOCK_OVERHEAD;
+
+    pcap_pkthdr header{};
+    const uint8_t* payload = nullptr;
+    if (type == PCAPNG_ENHANCED_PACKET && bodySize >= 20) {
+      uint32_t interfaceId = read32(section, body);
+      if (interfaceId >= section.interfaces.size()) {
+        continue;
+      }
+      const Interface& interface = section.interfaces[interfaceId];
+
+      uint64_t timestamp = (uint64_t(read32(section, body + 4)) << 32) | read32(section, body + 8);
+      uint64_t units = timestamp % interface.unitsPerSecond;
+      header.ts.tv_sec = static_cast<time_t>(timestamp / interface.unitsPerSecond + interface.offset);
+      header.ts.tv_usec = interface.unitsPerSecond == 1000000 ? units :
+        static_cast<suseconds_t>(static_cast<long double>(units) * 1000000 / interface.unitsPerSecond);
+      header.caplen = read32(section, body + 12);
+      header.len = read32(section, body + 16);
+      if (header.caplen > bodySize - 20) {
+        continue;
+      }
+      payload = body + 20;
+    }
+    else if (type == PCAPNG_SIMPLE_PACKET && bodySize >= 4 && !section.interfaces.empty()) {
+      // no timestamp; the captured length is implied by the block length and the snaplen
+      header.len = read32(section, body);
+      header.caplen = std::min<uint32_t>(header.len, bodySize - 4);
+      if (section.interfaces.front().snapLen > 0) {
+        header.caplen = std::min(header.caplen, section.interfaces.front().snapLen);
+      }
+      payload = body + 4;
+    }
+    else {
+      continue;
+    }
+    onRecord(header, payload);
+  }
+}
+
+} // namespace dump
+} // namespace ndn
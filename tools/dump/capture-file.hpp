@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_CAPTURE_FILE_HPP
+#define NDN_TOOLS_DUMP_CAPTURE_FILE_HPP
+
+#include "core/common.hpp"
+
+#include <pcap.h>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Memory-mapped pcap or pcapng capture file, split into chunks of whole records
+ *
+ * The constructor walks the record headers once, to find the chunk boundaries and, in a
+ * pcapng file, the interfaces. Afterwards, the packets of different chunks can be read
+ * concurrently, without copying them.
+ *
+ * In a pcapng file, Enhanced and Simple Packet Blocks are read, and all interfaces must have
+ * the same link-layer type. Other blocks are skipped.
+ */
+class CaptureFile : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @brief Byte range of consecutive records in the file
+   */
+  struct Chunk
+  {
+    size_t begin;
+    size_t end;
+    size_t section; ///< index of the pcapng section, zero in a pcap file
+  };
+
+  /**
+   * @brief Called with each packet of a chunk; the payload points into the mapped file
+   */
+  using RecordCallback = std::function<void(const pcap_pkthdr&, const uint8_t*)>;
+
+  /**
+   * @brief Map @p filename and split it into chunks of about @p chunkSize bytes
+   * @throw Error the file cannot be mapped, or is not a supported capture file
+   */
+  CaptureFile(const std::string& filename, size_t chunkSize);
+
+  ~CaptureFile();
+
+  /**
+   * @brief LINKTYPE_ value of the packets
+   */
+  int
+  getLinkType() const
+  {
+    return m_linkType;
+  }
+
+  const std::vector<Chunk>&
+  getChunks() const
+  {
+    return m_chunks;
+  }
+
+  /**
+   * @brief whether the file ends with a cut short or malformed record, which is not part of any chunk
+   */
+  bool
+  isTruncated() const
+  {
+    return m_isTruncated;
+  }
+
+  /**
+   * @brief call @p onRecord for each packet in @p chunk, in file order
+   *
+   * Can be called concurrently from several threads.
+   */
+  void
+  forEachRecord(const Chunk& chunk, const RecordCallback& onRecord) const;
+
+private:
+  struct Interface
+  {
+    int linkType;
+    uint32_t snapLen;
+    uint64_t unitsPerSecond = 1000000; ///< timestamp resolution
+    int64_t offset = 0; ///< seconds added to the timestamps
+  };
+
+  struct Section
+  {
+    bool isSwapped; ///< whether the byte order differs from the host
+    bool isNanosecond; ///< whether pcap timestamps have nanosecond resolution
+    std::vector<Interface> interfaces; ///< pcapng only
+  };
+
+  void
+  indexPcap(size_t chunkSize);
+
+  void
+  indexPcapng(size_t chunkSize);
+
+  void
+  readInterface(Section& section, const uint8_t* body, size_t size);
+
+  uint32_t
+  read32(const Section& section, const uint8_t* pos) const;
+
+  uint16_t
+  read16(const Section& section, const uint8_t* pos) const;
+
+  void
+  forEachPcapRecord(const Chunk& chunk, const RecordCallback& onRecord) const;
+
+  void
+  forEachPcapngRecord(const Chunk& chunk, const RecordCallback& onRecord) const;
+
+private:
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_isPcapng = false;
+  int m_linkType = -1;
+  std::vector<Section> m_sections;
+  std::vector<Chunk> m_chunks;
+  bool m_isTruncated = false;
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_CAPTURE_FILE_HPP
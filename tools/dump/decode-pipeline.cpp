@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "decode-pipeline.hpp"
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Wait for the other side of a queue, spinning first and then sleeping
+ */
+static void
+backOff(unsigned& nAttempts)
+{
+  if (++nAttempts < 64) {
+    std::this_thread::yield();
+  }
+  else {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+DecodePipeline::DecodePipeline(size_t nDecoders, size_t queueCapacity, bool canDrop,
+                               FormatFunc format, std::ostream& os)
+  : m_canDrop(canDrop)
+  , m_format(std::move(format))
+  , m_os(os)
+{
+  BOOST_ASSERT(nDecoders > 0);
+
+  for (size_t i = 0; i < nDecoders; ++i) {
+    m_decoders.push_back(make_unique<Decoder>(queueCapacity));
+  }
+  for (auto& decoder : m_decoders) {
+    decoder->thread = std::thread([this, &decoder = *decoder] { runDecoder(decoder); });
+  }
+  m_sequencer = std::thread([this] { runSequencer(); });
+}
+
+DecodePipeline::~DecodePipeline()
+{
+  finish();
+}
+
+bool
+DecodePipeline::push(const pcap_pkthdr* pkthdr, const uint8_t* payload)
+{
+  BOOST_ASSERT(!m_isFinished);
+
+  // packets are assigned round-robin; a dropped packet does not consume a turn, so that the
+  // sequencer always knows which queue holds the next packet
+  uint64_t seqNo = m_nQueued.load(std::memory_order_relaxed);
+  Decoder& decoder = *m_decoders[seqNo % m_decoders.size()];
+  CapturedPacket* packet = nullptr;
+  unsigned nAttempts = 0;
+  while ((packet = decoder.input.prepareWrite()) == nullptr) {
+    if (m_canDrop) {
+      ++m_nDropped;
+      return false;
+    }
+    backOff(nAttempts);
+  }
+
+  packet->header = *pkthdr;
+  packet->payload.assign(payload, payload + pkthdr->caplen);
+  decoder.input.commitWrite();
+
+  m_nQueued.store(seqNo + 1, std::memory_order_release);
+  return true;
+}
+
+void
+DecodePipeline::finish()
+{
+  if (m_isFinished.exchange(true)) {
+    return;
+  }
+
+  for (auto& decoder : m_decoders) {
+    decoder->thread.join();
+  }
+  m_sequencer.join();
+}
+
+void
+DecodePipeline::runDecoder(Decoder& decoder)
+{
+  OutputBuffer buffer;
+  unsigned nAttempts = 0;
+
+  while (true) {
+    CapturedPacket* packet = decoder.input.front();
+    if (packet == nullptr) {
+      // check the queue again after seeing the flag, the last packets may have been pushed
+      // just before it was set
+      if (m_isFinished.load(std::memory_order_acquire) && decoder.input.front() == nullptr) {
+        return;
+      }
+      backOff(nAttempts);
+      continue;
+    }
+    nAttempts = 0;
+
+    m_format(buffer, packet->header, packet->payload.data());
+
+    FormattedPacket* formatted = nullptr;
+    while ((formatted = decoder.output.prepareWrite()) == nullptr) {
+      // wait for the sequencer
+      backOff(nAttempts);
+    }
+    nAttempts = 0;
+
+    formatted->text.assign(buffer.data(), buffer.size());
+    buffer.truncate(0);
+    decoder.output.commitWrite();
+    decoder.input.pop();
+  }
+}
+
+void
+DecodePipeline::runSequencer()
+{
+  OutputBuffer buffer;
+  uint64_t seqNo = 0;
+  unsigned nAttempts = 0;
+
+  while (true) {
+    Decoder& decoder = *m_decoders[seqNo % m_decoders.size()];
+    FormattedPacket* formatted = decoder.output.front();
+    if (formatted == nullptr) {
+      // nothing to print right now, write out what has been buffered
+      if (buffer.size() > 0) {
+        buffer.flushTo(m_os);
+      }
+      if (m_isFinished.load(std::memory_order_acquire) &&
+          seqNo == m_nQueued.load(std::memory_order_acquire)) {
+        break;
+      }
+      backOff(nAttempts);
+      continue;
+    }
+    nAttempts = 0;
+
+    buffer.sputn(formatted->text.data(), static_cast<std::streamsize>(formatted->text.size()));
+    decoder.output.pop();
+    ++seqNo;
+
+    if (buffer.size() >= OutputBuffer::FLUSH_THRESHOLD) {
+      buffer.flushTo(m_os);
+    }
+  }
+
+  buffer.flushTo(m_os);
+}
+
+} // namespace dump
+} // namespace ndn
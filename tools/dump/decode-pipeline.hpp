@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_DECODE_PIPELINE_HPP
+#define NDN_TOOLS_DUMP_DECODE_PIPELINE_HPP
+
+#include "output-buffer.hpp"
+#include "spsc-ring.hpp"
+
+#include <pcap.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Decodes captured packets on a pool of threads and prints them in capture order
+ *
+ * The capture thread copies each packet into the queue of one decoder thread, in round-robin
+ * order; if that queue is full, the packet is dropped, or the capture thread waits when
+ * reading from a file. Each decoder formats its packets into its
+ * own output queue, and a sequencer thread reads the output queues in the same round-robin
+ * order, so that packets are printed in the order in which they were captured.
+ */
+class DecodePipeline : noncopyable
+{
+public:
+  /**
+   * @brief Format one packet into the buffer, or write nothing if it should not be printed
+   *
+   * Called concurrently from all decoder threads.
+   */
+  using FormatFunc = std::function<void(OutputBuffer&, const pcap_pkthdr&, const uint8_t*)>;
+
+  /**
+   * @param nDecoders number of decoder threads
+   * @param queueCapacity number of packets each decoder queue can hold
+   * @param canDrop whether push() drops a packet when the queue is full, instead of waiting
+   * @param format formatting function
+   * @param os output stream, written only from the sequencer thread
+   */
+  DecodePipeline(size_t nDecoders, size_t queueCapacity, bool canDrop, FormatFunc format,
+                 std::ostream& os);
+
+  ~DecodePipeline();
+
+  /**
+   * @brief Copy a captured packet into the queue of the next decoder
+   * @return false if the queue was full and the packet was dropped
+   *
+   * Must always be called from the same thread.
+   */
+  bool
+  push(const pcap_pkthdr* pkthdr, const uint8_t* payload);
+
+  /**
+   * @brief Wait until every queued packet is printed, then stop the threads
+   *
+   * No packets can be pushed afterwards.
+   */
+  void
+  finish();
+
+  /**
+   * @brief number of packets queued for decoding
+   */
+  uint64_t
+  getNQueued() const
+  {
+    return m_nQueued;
+  }
+
+  /**
+   * @brief number of packets dropped because a decoder queue was full
+   */
+  uint64_t
+  getNDropped() const
+  {
+    return m_nDropped;
+  }
+
+private:
+  struct CapturedPacket
+  {
+    pcap_pkthdr header;
+    std::vector<uint8_t> payload;
+  };
+
+  struct FormattedPacket
+  {
+    std::string text;
+  };
+
+  struct Decoder
+  {
+    explicit
+    Decoder(size_t queueCapacity)
+      : input(queueCapacity)
+      , output(queueCapacity)
+    {
+    }
+
+    SpscRing<CapturedPacket> input;
+    SpscRing<FormattedPacket> output;
+    std::thread thread;
+  };
+
+  void
+  runDecoder(Decoder& decoder);
+
+  void
+  runSequencer();
+
+private:
+  const bool m_canDrop;
+  FormatFunc m_format;
+  std::ostream& m_os;
+  std::vector<unique_ptr<Decoder>> m_decoders;
+  std::thread m_sequencer;
+
+  std::atomic<uint64_t> m_nQueued{0}; ///< written by the capture thread only
+  uint64_t m_nDropped = 0; ///< written by the capture thread only
+  std::atomic<bool> m_isFinished{false};
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_DECODE_PIPELINE_HPP
@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exchange-tracker.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <iomanip>
+
+namespace ndn {
+namespace dump {
+
+constexpr size_t ExchangeTracker::N_HISTOGRAM_BUCKETS;
+
+static int64_t
+toMicroseconds(const timeval& ts)
+{
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_usec;
+}
+
+/**
+ * @return size of the first @p nComponents components of the encoded name [@p name, @p end)
+ */
+static size_t
+getPrefixSize(const uint8_t* name, const uint8_t* end, size_t nComponents)
+{
+  const uint8_t* pos = name;
+  for (size_t i = 0; i < nComponents && pos != end; ++i) {
+    uint32_t type = 0;
+    uint64_t length = 0;
+    if (!tlv::readType(pos, end, type) || !tlv::readVarNumber(pos, end, length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      break;
+    }
+    pos += length;
+  }
+  return static_cast<size_t>(pos - name);
+}
+
+size_t
+ExchangeTracker::KeyHash::operator()(const Key& key) const
+{
+  size_t seed = key.flow.hash();
+  boost::hash_combine(seed, key.name);
+  return seed;
+}
+
+ExchangeTracker::ExchangeTracker(const Options& options)
+  : m_options(options)
+{
+}
+
+void
+ExchangeTracker::addInterest(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize,
+                             bool canBePrefix, time::milliseconds lifetime)
+{
+  int64_t now = toMicroseconds(ts);
+  expire(now);
+
+  m_lookupKey.flow = flow.hasGroupDestination() ? flow.toGroup() : flow;
+  m_lookupKey.name.assign(reinterpret_cast<const char*>(name), nameSize);
+  auto it = m_table.find(m_lookupKey);
+  if (it != m_table.end()) {
+    // retransmission: measure the RTT from the last transmission
+    m_expiryQueue.erase(it->second.expiry);
+  }
+  else {
+    if (m_table.size() >= m_options.capacity) {
+      erase(m_table.find(*m_expiryQueue.begin()->second));
+      ++m_nEvicted;
+    }
+    size_t prefix = findOrInsertPrefix(name, nameSize);
+    it = m_table.emplace(m_lookupKey, Entry{0, false, prefix, {}}).first;
+    (prefix == OTHER_PREFIX ? m_otherPrefixes : m_prefixes[prefix].second).nInterests++;
+  }
+
+  int64_t expiry = now + time::duration_cast<time::microseconds>(lifetime).count();
+  it->second.sent = now;
+  it->second.canBePrefix = canBePrefix;
+  it->second.expiry = m_expiryQueue.emplace(expiry, &it->first);
+}
+
+optional<time::microseconds>
+ExchangeTracker::addData(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize)
+{
+  int64_t now = toMicroseconds(ts);
+  expire(now);
+
+  auto it = findAnswered(flow, name, nameSize, true);
+  if (it == m_table.end()) {
+    ++m_nUnsolicited;
+    return nullopt;
+  }
+  return finish(it, now, false);
+}
+
+optional<time::microseconds>
+ExchangeTracker::addNack(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize)
+{
+  int64_t now = toMicroseconds(ts);
+  expire(now);
+
+  // a Nack carries the Interest, so the names are equal
+  auto it = findAnswered(flow, name, nameSize, false);
+  if (it == m_table.end()) {
+    ++m_nUnsolicited;
+    return nullopt;
+  }
+  return finish(it, now, true);
+}
+
+ExchangeTracker::Table::iterator
+ExchangeTracker::findAnswered(const FlowKey& flow, const uint8_t* name, size_t nameSize, bool allowPrefix)
+{
+  // on a multicast face, or when the destination is not captured, the answer is sent to the
+  // same destination as the Interest, by another node
+  m_lookupKey.flow = flow.hasGroupDestination() ? flow.toGroup() : flow.reverse();
+  m_lookupKey.name.assign(reinterpret_cast<const char*>(name), nameSize);
+  auto it = m_table.find(m_lookupKey);
+  if (it != m_table.end() || !allowPrefix) {
+    return it;
+  }
+
+  // look for an Interest with CanBePrefix under each proper prefix; the longest one wins
+  auto found = m_table.end();
+  const uint8_t* end = name + nameSize;
+  size_t size = getPrefixSize(name, end, 1);
+  while (size > 0 && size < nameSize) {
+    m_lookupKey.name.assign(reinterpret_cast<const char*>(name), size);
+    it = m_table.find(m_lookupKey);
+    if (it != m_table.end() && it->second.canBePrefix) {
+      found = it;
+    }
+
+    size_t next = getPrefixSize(name + size, end, 1);
+    size = next > 0 ? size + next : 0;
+  }
+  return found;
+}
+
+size_t
+ExchangeTracker::findOrInsertPrefix(const uint8_t* name, size_t nameSize)
+{
+  std::string prefix(reinterpret_cast<const char*>(name),
+                     getPrefixSize(name, name + nameSize, m_options.depth));
+  auto it = m_prefixIndex.find(prefix);
+  if (it != m_prefixIndex.end()) {
+    return it->second;
+  }
+  if (m_prefixes.size() >= m_options.capacity) {
+    return OTHER_PREFIX;
+  }
+
+  m_prefixes.emplace_back(prefix, PrefixStatistics{});
+  m_prefixIndex.emplace(std::move(prefix), m_prefixes.size() - 1);
+  return m_prefixes.size() - 1;
+}
+
+time::microseconds
+ExchangeTracker::finish(Table::iterator entry, int64_t now, bool isNack)
+{
+  time::microseconds rtt(std::max<int64_t>(now - entry->second.sent, 0));
+  size_t prefix = entry->second.prefix;
+  auto& stats = prefix == OTHER_PREFIX ? m_otherPrefixes : m_prefixes[prefix].second;
+  erase(entry);
+
+  (isNack ? stats.nNacked : stats.nSatisfied)++;
+  stats.minRtt = std::min(stats.minRtt, rtt);
+  stats.maxRtt = std::max(stats.maxRtt, rtt);
+  stats.totalRtt += rtt;
+
+  size_t bucket = 0;
+  for (auto ms = rtt.count() / 1000; ms > 0 && bucket < N_HISTOGRAM_BUCKETS - 1; ms >>= 1) {
+    ++bucket;
+  }
+  stats.rttHistogram[bucket]++;
+  return rtt;
+}
+
+void
+ExchangeTracker::expire(int64_t now)
+{
+  while (!m_expiryQueue.empty() && m_expiryQueue.begin()->first <= now) {
+    auto entry = m_table.find(*m_expiryQueue.begin()->second);
+    size_t prefix = entry->second.prefix;
+    (prefix == OTHER_PREFIX ? m_otherPrefixes : m_prefixes[prefix].second).nTimedOut++;
+    erase(entry);
+  }
+}
+
+void
+ExchangeTracker::erase(Table::iterator entry)
+{
+  m_expiryQueue.erase(entry->second.expiry);
+  m_table.erase(entry);
+}
+
+const ExchangeTracker::PrefixStatistics*
+ExchangeTracker::getPrefixStatistics(const Name& name) const
+{
+  const Block& wire = name.getPrefix(std::min(name.size(), m_options.depth)).wireEncode();
+  auto it = m_prefixIndex.find(std::string(reinterpret_cast<const char*>(wire.value()), wire.value_size()));
+  return it == m_prefixIndex.end() ? nullptr : &m_prefixes[it->second].second;
+}
+
+static void
+printPrefixStatistics(std::ostream& os, const std::string& label,
+                      const ExchangeTracker::PrefixStatistics& stats)
+{
+  uint64_t nAnswered = stats.nSatisfied + stats.nNacked;
+  uint64_t nFinished = nAnswered + stats.nTimedOut;
+
+  os << "  " << label << ": " << stats.nInterests << " Interests, "
+     << stats.nSatisfied << " satisfied, " << stats.nNacked << " nacked, "
+     << stats.nTimedOut << " timed out";
+  if (nFinished > 0) {
+    os << ", satisfaction " << stats.nSatisfied * 100 / nFinished << "%";
+  }
+  if (nAnswered > 0) {
+    os << ", RTT min/avg/max " << AsMilliseconds{stats.minRtt} << '/'
+       << AsMilliseconds{stats.totalRtt / static_cast<int64_t>(nAnswered)} << '/'
+       << AsMilliseconds{stats.maxRtt} << " ms";
+  }
+  os << '\n';
+
+  if (nAnswered > 0) {
+    os << "   ";
+    for (size_t i = 0; i < stats.rttHistogram.size(); ++i) {
+      if (stats.rttHistogram[i] == 0) {
+        continue;
+      }
+      if (i == stats.rttHistogram.size() - 1) {
+        os << " >=" << (1 << (i - 1)) << "ms:";
+      }
+      else {
+        os << " <" << (1 << i) << "ms:";
+      }
+      os << stats.rttHistogram[i];
+    }
+    os << '\n';
+  }
+}
+
+void
+ExchangeTracker::printSummary(std::ostream& os) const
+{
+  os << "--- Interest-Data exchanges: " << m_table.size() << " pending, "
+     << m_nEvicted << " evicted, " << m_nUnsolicited << " unsolicited Data or Nacks\n";
+
+  for (const auto& prefix : m_prefixes) {
+    Name name;
+    name.wireDecode(makeBinaryBlock(tlv::Name, prefix.first.data(), prefix.first.size()));
+    printPrefixStatistics(os, name.toUri(), prefix.second);
+  }
+  if (m_otherPrefixes.nInterests > 0) {
+    printPrefixStatistics(os, "(other)", m_otherPrefixes);
+  }
+  os.flush();
+}
+
+std::ostream&
+operator<<(std::ostream& os, const AsMilliseconds& ms)
+{
+  auto us = ms.duration.count();
+  char fill = os.fill('0');
+  os << us / 1000 << '.' << std::setw(3) << us % 1000;
+  os.fill(fill);
+  return os;
+}
+
+} // namespace dump
+} // namespace ndn
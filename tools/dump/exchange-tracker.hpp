@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_EXCHANGE_TRACKER_HPP
+#define NDN_TOOLS_DUMP_EXCHANGE_TRACKER_HPP
+
+#include "flow-key.hpp"
+
+#include <array>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Matches captured Data and Nacks to the Interests they answer, and measures the RTT
+ *
+ * Interests are kept in a pending Interest table keyed by their Name and face. A Data or Nack
+ * matches an entry if it was captured on the same face in the opposite direction, and its
+ * name equals the Interest name or, if the Interest has CanBePrefix, starts with it.
+ *
+ * If the destination is a multicast or broadcast group, or is not captured (LINUX_SLL), the
+ * source is left out of the key (see FlowKey::toGroup): a Data or Nack sent to the same
+ * destination by any node matches, and Interests for the same name from different nodes are
+ * counted as retransmissions of one Interest.
+ *
+ * An entry is removed when it is matched, or when its InterestLifetime expires, measured in
+ * capture time. When the table is full, the entry closest to expiry is evicted. Outcomes and
+ * an RTT histogram are kept per prefix of Options::depth components, up to Options::capacity
+ * prefixes.
+ */
+class ExchangeTracker : noncopyable
+{
+public:
+  struct Options
+  {
+    size_t capacity = 65536; ///< maximum number of pending Interests, and of prefixes
+    size_t depth = 3; ///< number of name components kept in a prefix
+  };
+
+  /// number of RTT histogram buckets: [0,1) ms, [1,2) ms, [2,4) ms, ..., and 4096 ms or more
+  static constexpr size_t N_HISTOGRAM_BUCKETS = 14;
+
+  struct PrefixStatistics
+  {
+    uint64_t nInterests = 0;
+    uint64_t nSatisfied = 0;
+    uint64_t nNacked = 0;
+    uint64_t nTimedOut = 0;
+    time::microseconds minRtt = time::microseconds::max();
+    time::microseconds maxRtt = time::microseconds::zero();
+    time::microseconds totalRtt = time::microseconds::zero();
+    std::array<uint64_t, N_HISTOGRAM_BUCKETS> rttHistogram{}; ///< satisfied and Nacked exchanges
+  };
+
+  explicit
+  ExchangeTracker(const Options& options);
+
+  /**
+   * @param name TLV-VALUE of the Interest's Name
+   */
+  void
+  addInterest(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize,
+              bool canBePrefix, time::milliseconds lifetime);
+
+  /**
+   * @return the RTT, if the Data satisfies a pending Interest
+   */
+  optional<time::microseconds>
+  addData(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize);
+
+  /**
+   * @return the RTT, if the Nack answers a pending Interest
+   */
+  optional<time::microseconds>
+  addNack(const timeval& ts, const FlowKey& flow, const uint8_t* name, size_t nameSize);
+
+  /**
+   * @brief print the outcomes and RTT distribution of the exchanges, per prefix
+   */
+  void
+  printSummary(std::ostream& os) const;
+
+  /**
+   * @brief number of pending Interests
+   */
+  size_t
+  size() const
+  {
+    return m_table.size();
+  }
+
+  uint64_t
+  getNUnsolicited() const
+  {
+    return m_nUnsolicited;
+  }
+
+  uint64_t
+  getNEvicted() const
+  {
+    return m_nEvicted;
+  }
+
+  /**
+   * @return statistics of the prefix of @p name, or nullptr if no Interest was seen under it
+   */
+  const PrefixStatistics*
+  getPrefixStatistics(const Name& name) const;
+
+private:
+  struct Key
+  {
+    FlowKey flow;
+    std::string name; ///< TLV-VALUE of the Name
+
+    friend bool
+    operator==(const Key& a, const Key& b)
+    {
+      return a.flow == b.flow && a.name == b.name;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t
+    operator()(const Key& key) const;
+  };
+
+  /// Entry::prefix of the Interests counted in m_otherPrefixes, when m_prefixes is full
+  static constexpr size_t OTHER_PREFIX = std::numeric_limits<size_t>::max();
+
+  /// expiry time in microseconds => key of the entry, which is stable in an unordered_map
+  using ExpiryQueue = std::multimap<int64_t, const Key*>;
+
+  struct Entry
+  {
+    int64_t sent; ///< capture time of the (last) Interest, in microseconds
+    bool canBePrefix;
+    size_t prefix; ///< index in m_prefixes, or OTHER_PREFIX
+    ExpiryQueue::iterator expiry;
+  };
+
+  using Table = std::unordered_map<Key, Entry, KeyHash>;
+
+  /**
+   * @brief remove the entries that expired before @p now
+   */
+  void
+  expire(int64_t now);
+
+  /**
+   * @brief find the entry answered by a packet with this name, received on the reverse face
+   *        or sent to the same group
+   */
+  Table::iterator
+  findAnswered(const FlowKey& flow, const uint8_t* name, size_t nameSize, bool allowPrefix);
+
+  /**
+   * @return index in m_prefixes of the first Options::depth components of @p name
+   */
+  size_t
+  findOrInsertPrefix(const uint8_t* name, size_t nameSize);
+
+  time::microseconds
+  finish(Table::iterator entry, int64_t now, bool isNack);
+
+  void
+  erase(Table::iterator entry);
+
+private:
+  const Options m_options;
+
+  Table m_table;
+  ExpiryQueue m_expiryQueue;
+  Key m_lookupKey; ///< reused by lookups to avoid allocating
+
+  std::vector<std::pair<std::string, PrefixStatistics>> m_prefixes; ///< encoded prefix => statistics
+  std::unordered_map<std::string, size_t> m_prefixIndex;
+  PrefixStatistics m_otherPrefixes;
+
+  uint64_t m_nUnsolicited = 0;
+  uint64_t m_nEvicted = 0;
+};
+
+/**
+ * @brief Helper to print a duration in milliseconds with microsecond precision, e.g. "12.345"
+ */
+struct AsMilliseconds
+{
+  time::microseconds duration;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const AsMilliseconds& ms);
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_EXCHANGE_TRACKER_HPP
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file-decoder.hpp"
+
+#include <thread>
+
+namespace ndn {
+namespace dump {
+
+/// stop() cannot notify from a signal handler, so the waiting threads check it periodically
+static const std::chrono::milliseconds STOP_POLL_INTERVAL(100);
+
+FileDecoder::FileDecoder(const CaptureFile& file, size_t nDecoders, FormatFunc format,
+                         std::ostream& os)
+  : m_file(file)
+  , m_nDecoders(nDecoders)
+  , m_format(std::move(format))
+  , m_os(os)
+  // enough slots for every decoder to work on one chunk while another waits to be printed
+  , m_slots(2 * nDecoders)
+{
+  BOOST_ASSERT(nDecoders > 0);
+}
+
+void
+FileDecoder::run()
+{
+  std::vector<std::thread> decoders;
+  for (size_t i = 0; i < m_nDecoders; ++i) {
+    decoders.emplace_back([this] { runDecoder(); });
+  }
+
+  const auto& chunks = m_file.getChunks();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_nChunksDone < chunks.size() && !m_shouldStop) {
+    Slot& slot = m_slots[m_nChunksDone % m_slots.size()];
+    if (!slot.isReady) {
+      m_cv.wait_for(lock, STOP_POLL_INTERVAL);
+      continue;
+    }
+
+    // the slot belongs to this thread until it is marked free again
+    lock.unlock();
+    slot.output.flushTo(m_os);
+    m_nDecoded += slot.nPackets;
+    lock.lock();
+
+    slot.isReady = false;
+    ++m_nChunksDone;
+    m_cv.notify_all();
+  }
+  m_shouldStop = true;
+  m_cv.notify_all();
+  lock.unlock();
+
+  for (auto& decoder : decoders) {
+    decoder.join();
+  }
+}
+
+void
+FileDecoder::stop()
+{
+  m_shouldStop = true;
+}
+
+void
+FileDecoder::runDecoder()
+{
+  const auto& chunks = m_file.getChunks();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (m_nextChunk < chunks.size() && !m_shouldStop) {
+    // a chunk can be claimed only once the slot it maps to has been printed
+    if (m_nextChunk >= m_nChunksDone + m_slots.size()) {
+      m_cv.wait_for(lock, STOP_POLL_INTERVAL);
+      continue;
+    }
+    size_t index = m_nextChunk++;
+    Slot& slot = m_slots[index % m_slots.size()];
+
+    lock.unlock();
+    decodeChunk(chunks[index], slot);
+    lock.lock();
+
+    slot.isReady = true;
+    m_cv.notify_all();
+  }
+}
+
+void
+FileDecoder::decodeChunk(const CaptureFile::Chunk& chunk, Slot& slot)
+{
+  slot.nPackets = 0;
+  m_file.forEachRecord(chunk, [&] (const pcap_pkthdr& header, const uint8_t* payload) {
+    ++slot.nPackets;
+    m_format(slot.output, header, payload);
+  });
+}
+
+} // namespace dump
+} // namespace ndn
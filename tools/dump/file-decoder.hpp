@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_FILE_DECODER_HPP
+#define NDN_TOOLS_DUMP_FILE_DECODER_HPP
+
+#include "capture-file.hpp"
+#include "output-buffer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Decodes the chunks of a capture file on a pool of threads and prints them in order
+ *
+ * Each decoder thread takes the next chunk that has not been claimed, and formats all its
+ * packets into one of a fixed number of output slots. The calling thread writes the slots
+ * out in chunk order. A decoder waits before claiming a chunk that is too far ahead of the
+ * output, so that memory use does not depend on the size of the file.
+ */
+class FileDecoder : noncopyable
+{
+public:
+  /**
+   * @brief Format one packet into the buffer, or write nothing if it should not be printed
+   *
+   * Called concurrently from all decoder threads.
+   */
+  using FormatFunc = std::function<void(OutputBuffer&, const pcap_pkthdr&, const uint8_t*)>;
+
+  /**
+   * @param file capture file, must remain valid until run() returns
+   * @param nDecoders number of decoder threads
+   * @param format formatting function
+   * @param os output stream, written only from the thread calling run()
+   */
+  FileDecoder(const CaptureFile& file, size_t nDecoders, FormatFunc format, std::ostream& os);
+
+  /**
+   * @brief Decode and print the whole file, or until stop() is called
+   */
+  void
+  run();
+
+  /**
+   * @brief Make run() return after the chunk being printed
+   *
+   * Can be called from a signal handler.
+   */
+  void
+  stop();
+
+  /**
+   * @brief number of packets in the chunks printed so far
+   */
+  uint64_t
+  getNDecoded() const
+  {
+    return m_nDecoded;
+  }
+
+  /**
+   * @brief number of chunks printed so far
+   */
+  size_t
+  getNChunksDone() const
+  {
+    return m_nChunksDone;
+  }
+
+private:
+  struct Slot
+  {
+    OutputBuffer output;
+    uint64_t nPackets = 0;
+    bool isReady = false;
+  };
+
+  void
+  runDecoder();
+
+  void
+  decodeChunk(const CaptureFile::Chunk& chunk, Slot& slot);
+
+private:
+  const CaptureFile& m_file;
+  const size_t m_nDecoders;
+  FormatFunc m_format;
+  std::ostream& m_os;
+  std::vector<Slot> m_slots;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  size_t m_nextChunk = 0; ///< next chunk to be claimed by a decoder, guarded by m_mutex
+  size_t m_nChunksDone = 0; ///< guarded by m_mutex
+  uint64_t m_nDecoded = 0; ///< written by the output thread only
+  std::atomic<bool> m_shouldStop{false};
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_FILE_DECODER_HPP
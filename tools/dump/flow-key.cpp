@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "flow-key.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <ndn-cxx/net/ethernet.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace dump {
+
+FlowKey
+FlowKey::reverse() const
+{
+  FlowKey reversed(*this);
+  std::swap(reversed.srcPort, reversed.dstPort);
+  std::swap(reversed.srcAddr, reversed.dstAddr);
+  return reversed;
+}
+
+bool
+FlowKey::hasGroupDestination() const
+{
+  static const std::array<uint8_t, 16> unspecified{};
+  if (dstAddr == unspecified) {
+    return true;
+  }
+
+  switch (family) {
+  case Family::ETHERNET:
+    // group bit of the first octet, also set in the broadcast address
+    return (dstAddr[0] & 0x01) != 0;
+  case Family::IPV4:
+    // 224.0.0.0/4, or the limited broadcast address
+    return (dstAddr[0] & 0xf0) == 0xe0 ||
+           std::all_of(dstAddr.begin(), dstAddr.begin() + 4, [] (uint8_t b) { return b == 0xff; });
+  case Family::IPV6:
+    // ff00::/8
+    return dstAddr[0] == 0xff;
+  default:
+    return true;
+  }
+}
+
+FlowKey
+FlowKey::toGroup() const
+{
+  FlowKey group(*this);
+  group.srcPort = 0;
+  group.srcAddr.fill(0);
+  return group;
+}
+
+size_t
+FlowKey::hash() const
+{
+  size_t seed = 0;
+  boost::hash_combine(seed, static_cast<uint8_t>(family));
+  boost::hash_combine(seed, protocol);
+  boost::hash_combine(seed, srcPort);
+  boost::hash_combine(seed, dstPort);
+  boost::hash_range(seed, srcAddr.begin(), srcAddr.end());
+  boost::hash_range(seed, dstAddr.begin(), dstAddr.end());
+  return seed;
+}
+
+bool
+operator==(const FlowKey& a, const FlowKey& b)
+{
+  return a.family == b.family && a.protocol == b.protocol &&
+         a.srcPort == b.srcPort && a.dstPort == b.dstPort &&
+         a.srcAddr == b.srcAddr && a.dstAddr == b.dstAddr;
+}
+
+void
+printAddress(std::ostream& os, FlowKey::Family family, const std::array<uint8_t, 16>& addr)
+{
+  if (family == FlowKey::Family::ETHERNET) {
+    os << ethernet::Address(addr.data());
+    return;
+  }
+
+  int af = family == FlowKey::Family::IPV6 ? AF_INET6 : AF_INET;
+  char addrStr[1 + std::max(INET_ADDRSTRLEN, INET6_ADDRSTRLEN)] = {};
+  if (inet_ntop(af, addr.data(), addrStr, sizeof(addrStr)) == nullptr) {
+    os << "???";
+  }
+  else {
+    os << addrStr;
+  }
+}
+
+static void
+printEndpoint(std::ostream& os, const FlowKey& flow, const std::array<uint8_t, 16>& addr, uint16_t port)
+{
+  if (flow.family == FlowKey::Family::IPV6) {
+    os << '[';
+    printAddress(os, flow.family, addr);
+    os << ']';
+  }
+  else {
+    printAddress(os, flow.family, addr);
+  }
+
+  if (flow.family != FlowKey::Family::ETHERNET) {
+    os << ':' << port;
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const FlowKey& flow)
+{
+  switch (flow.family) {
+  case FlowKey::Family::IPV4:
+  case FlowKey::Family::IPV6:
+    os << (flow.protocol == IPPROTO_TCP ? "tcp " : "udp ");
+    break;
+  case FlowKey::Family::ETHERNET:
+    os << "ether ";
+    break;
+  default:
+    return os << "unknown";
+  }
+
+  printEndpoint(os, flow, flow.srcAddr, flow.srcPort);
+  os << " > ";
+  printEndpoint(os, flow, flow.dstAddr, flow.dstPort);
+  return os;
+}
+
+} // namespace dump
+} // namespace ndn
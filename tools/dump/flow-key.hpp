@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_FLOW_KEY_HPP
+#define NDN_TOOLS_DUMP_FLOW_KEY_HPP
+
+#include "core/common.hpp"
+
+#include <array>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Endpoints of a captured packet, i.e. the face it was sent on
+ *
+ * For IP packets, this is the usual 5-tuple. For NDN directly over Ethernet, the addresses are
+ * the MAC addresses and the ports are zero. Fields that are not known, e.g. the destination MAC
+ * address of a LINUX_SLL frame, are left zero.
+ */
+struct FlowKey
+{
+  enum class Family : uint8_t {
+    UNKNOWN,
+    ETHERNET,
+    IPV4,
+    IPV6,
+  };
+
+  Family family = Family::UNKNOWN;
+  uint8_t protocol = 0; ///< IPPROTO_TCP or IPPROTO_UDP, zero for Ethernet
+  uint16_t srcPort = 0;
+  uint16_t dstPort = 0;
+  std::array<uint8_t, 16> srcAddr{}; ///< a MAC address occupies the first 6 octets
+  std::array<uint8_t, 16> dstAddr{};
+
+  /**
+   * @brief key of the packets sent in the opposite direction on the same face
+   */
+  FlowKey
+  reverse() const;
+
+  /**
+   * @brief whether the destination is a multicast or broadcast group, or is not known
+   */
+  bool
+  hasGroupDestination() const;
+
+  /**
+   * @brief key of all the packets sent to the same destination on the same face, i.e. with
+   *        the source cleared
+   */
+  FlowKey
+  toGroup() const;
+
+  size_t
+  hash() const;
+};
+
+bool
+operator==(const FlowKey& a, const FlowKey& b);
+
+inline bool
+operator!=(const FlowKey& a, const FlowKey& b)
+{
+  return !(a == b);
+}
+
+/**
+ * @brief print an IP address, or a MAC address if @p family is ETHERNET, without the port
+ */
+void
+printAddress(std::ostream& os, FlowKey::Family family, const std::array<uint8_t, 16>& addr);
+
+/**
+ * @brief print e.g. "tcp 192.0.2.1:6363 > 192.0.2.2:55000" or "ether 02:00:00:00:00:01 > ..."
+ */
+std::ostream&
+operator<<(std::ostream& os, const FlowKey& flow);
+
+} // namespace dump
+} // namespace ndn
+
+namespace std {
+
+template<>
+struct hash<ndn::dump::FlowKey>
+{
+  size_t
+  operator()(const ndn::dump::FlowKey& flow) const
+  {
+    return flow.hash();
+  }
+};
+
+} // namespace std
+
+#endif // NDN_TOOLS_DUMP_FLOW_KEY_HPP
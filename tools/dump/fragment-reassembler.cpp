@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fragment-reassembler.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+#include <ndn-cxx/lp/tlv.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace ndn {
+namespace dump {
+
+static int64_t
+toMicroseconds(const timeval& ts)
+{
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_usec;
+}
+
+static bool
+readTlv(const uint8_t*& pos, const uint8_t* end, uint32_t& type, uint64_t& length)
+{
+  return tlv::readType(pos, end, type) && tlv::readVarNumber(pos, end, length) &&
+         length <= static_cast<uint64_t>(end - pos);
+}
+
+static bool
+readNumber(const uint8_t* value, uint64_t length, uint64_t& number)
+{
+  try {
+    number = tlv::readNonNegativeInteger(static_cast<size_t>(length), value, value + length);
+    return true;
+  }
+  catch (const tlv::Error&) {
+    return false;
+  }
+}
+
+static void
+appendVarNumber(Buffer& buf, uint64_t number)
+{
+  if (number < 253) {
+    buf.push_back(static_cast<uint8_t>(number));
+    return;
+  }
+
+  size_t size = number <= 0xFFFF ? 2 : number <= 0xFFFFFFFF ? 4 : 8;
+  buf.push_back(size == 2 ? 253 : size == 4 ? 254 : 255);
+  for (size_t i = size; i > 0; --i) {
+    buf.push_back(static_cast<uint8_t>(number >> (8 * (i - 1))));
+  }
+}
+
+size_t
+FragmentReassembler::KeyHash::operator()(const Key& key) const
+{
+  size_t seed = key.flow.hash();
+  boost::hash_combine(seed, key.firstSequence);
+  return seed;
+}
+
+FragmentReassembler::FragmentReassembler(const Options& options)
+  : m_options(options)
+{
+}
+
+const Buffer*
+FragmentReassembler::add(const timeval& ts, const FlowKey& flow, const uint8_t* lpPacket, size_t size)
+{
+  int64_t now = toMicroseconds(ts);
+  expire(now);
+
+  const uint8_t* pos = lpPacket;
+  const uint8_t* end = lpPacket + size;
+  uint32_t type = 0;
+  uint64_t length = 0;
+  if (!readTlv(pos, end, type, length) || type != lp::tlv::LpPacket) {
+    ++m_nInvalid;
+    return nullptr;
+  }
+  end = pos + length;
+
+  optional<uint64_t> sequence;
+  uint64_t fragIndex = 0;
+  uint64_t fragCount = 1;
+  const uint8_t* fragment = nullptr;
+  size_t fragmentSize = 0;
+  const uint8_t* headerBegin = pos;
+  std::string header;
+  while (pos != end) {
+    const uint8_t* fieldBegin = pos;
+    if (!readTlv(pos, end, type, length)) {
+      ++m_nInvalid;
+      return nullptr;
+    }
+    const uint8_t* value = pos;
+    pos += length;
+
+    uint64_t number = 0;
+    switch (type) {
+    case lp::tlv::Sequence:
+    case lp::tlv::FragIndex:
+    case lp::tlv::FragCount:
+      if (!readNumber(value, length, number)) {
+        ++m_nInvalid;
+        return nullptr;
+      }
+      if (type == lp::tlv::Sequence) {
+        sequence = number;
+      }
+      else if (type == lp::tlv::FragIndex) {
+        fragIndex = number;
+      }
+      else {
+        fragCount = number;
+      }
+      // these fields describe the fragment, not the reassembled packet
+      header.append(reinterpret_cast<const char*>(headerBegin), fieldBegin - headerBegin);
+      headerBegin = pos;
+      break;
+    case lp::tlv::Fragment:
+      fragment = value;
+      fragmentSize = static_cast<size_t>(length);
+      header.append(reinterpret_cast<const char*>(headerBegin), fieldBegin - headerBegin);
+      headerBegin = pos;
+      break;
+    default:
+      break;
+    }
+  }
+  header.append(reinterpret_cast<const char*>(headerBegin), end - headerBegin);
+
+  if (!sequence || fragment == nullptr || fragIndex >= fragCount ||
+      fragCount > m_options.maxFragCount || fragmentSize > m_options.maxBytes) {
+    ++m_nInvalid;
+    return nullptr;
+  }
+
+  Key key{flow, *sequence - fragIndex};
+  auto it = m_table.find(key);
+  if (it == m_table.end()) {
+    Entry entry;
+    entry.fragCount = fragCount;
+    entry.fragments.resize(fragCount);
+    entry.hasFragment.resize(fragCount);
+    it = m_table.emplace(key, std::move(entry)).first;
+    int64_t expiry = now + time::duration_cast<time::microseconds>(m_options.timeout).count();
+    it->second.expiry = m_expiryQueue.emplace(expiry, &it->first);
+  }
+  Entry& entry = it->second;
+
+  if (entry.fragCount != fragCount) {
+    ++m_nInvalid;
+    return nullptr;
+  }
+  if (entry.hasFragment[fragIndex]) {
+    // a retransmission on the link, the packet is reassembled from the first copy
+    return nullptr;
+  }
+
+  entry.fragments[fragIndex].assign(reinterpret_cast<const char*>(fragment), fragmentSize);
+  entry.hasFragment[fragIndex] = true;
+  if (fragIndex == 0) {
+    entry.header = std::move(header);
+  }
+  ++entry.nReceived;
+  entry.nBytes += fragmentSize;
+  m_nBytes += fragmentSize;
+
+  if (entry.nReceived < entry.fragCount) {
+    evict();
+    return nullptr;
+  }
+
+  reassemble(entry);
+  erase(it);
+  ++m_nReassembled;
+  return &m_packet;
+}
+
+void
+FragmentReassembler::reassemble(const Entry& entry)
+{
+  m_packet.clear();
+  if (!entry.header.empty()) {
+    appendVarNumber(m_packet, lp::tlv::LpPacket);
+    size_t valueSize = entry.header.size() + tlv::sizeOfVarNumber(lp::tlv::Fragment) +
+                       tlv::sizeOfVarNumber(entry.nBytes) + entry.nBytes;
+    appendVarNumber(m_packet, valueSize);
+    m_packet.insert(m_packet.end(), entry.header.begin(), entry.header.end());
+    appendVarNumber(m_packet, lp::tlv::Fragment);
+    appendVarNumber(m_packet, entry.nBytes);
+  }
+  for (const auto& fragment : entry.fragments) {
+    m_packet.insert(m_packet.end(), fragment.begin(), fragment.end());
+  }
+}
+
+void
+FragmentReassembler::expire(int64_t now)
+{
+  while (!m_expiryQueue.empty() && m_expiryQueue.begin()->first <= now) {
+    erase(m_table.find(*m_expiryQueue.begin()->second));
+    ++m_nTimedOut;
+  }
+}
+
+void
+FragmentReassembler::evict()
+{
+  // the entry that expires first is also the oldest one
+  while (!m_expiryQueue.empty() &&
+         (m_table.size() > m_options.capacity || m_nBytes > m_options.maxBytes)) {
+    erase(m_table.find(*m_expiryQueue.begin()->second));
+    ++m_nEvicted;
+  }
+}
+
+void
+FragmentReassembler::erase(Table::iterator entry)
+{
+  m_nBytes -= entry->second.nBytes;
+  m_expiryQueue.erase(entry->second.expiry);
+  m_table.erase(entry);
+}
+
+} // namespace dump
+} // namespace ndn
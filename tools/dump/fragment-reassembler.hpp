@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_FRAGMENT_REASSEMBLER_HPP
+#define NDN_TOOLS_DUMP_FRAGMENT_REASSEMBLER_HPP
+
+#include "flow-key.hpp"
+
+#include <map>
+#include <unordered_map>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Reassembles network packets from captured NDNLPv2 fragments
+ *
+ * As in NFD, the fragments of a packet have consecutive Sequence numbers, so a partial packet
+ * is identified by its face and by the Sequence of its first fragment, i.e. Sequence minus
+ * FragIndex. The header fields of the first fragment, e.g. a Nack, are kept in the reassembled
+ * LpPacket.
+ *
+ * A partial packet is dropped if it is not complete within Options::timeout of its first
+ * fragment, measured in capture time. When more than Options::capacity partial packets, or
+ * Options::maxBytes of fragments, are buffered, the oldest partial packets are dropped.
+ */
+class FragmentReassembler : noncopyable
+{
+public:
+  struct Options
+  {
+    size_t capacity = 1024; ///< maximum number of partial packets
+    size_t maxBytes = 64 << 20; ///< maximum size of the buffered fragments
+    uint64_t maxFragCount = 400; ///< fragments with a larger FragCount are rejected
+    time::milliseconds timeout = 500_ms; ///< time to receive all fragments of a packet
+  };
+
+  explicit
+  FragmentReassembler(const Options& options);
+
+  /**
+   * @brief add a fragment
+   * @param lpPacket the whole LpPacket element, with FragCount greater than one
+   * @return the reassembled packet, which is valid until the next call, or nullptr if the
+   *         packet is incomplete or the fragment is invalid
+   *
+   * The reassembled packet is an LpPacket if the first fragment had other header fields than
+   * Sequence, FragIndex, and FragCount, otherwise it is the bare network packet.
+   */
+  const Buffer*
+  add(const timeval& ts, const FlowKey& flow, const uint8_t* lpPacket, size_t size);
+
+  /**
+   * @brief number of partial packets
+   */
+  size_t
+  size() const
+  {
+    return m_table.size();
+  }
+
+  /**
+   * @brief size of the buffered fragments
+   */
+  size_t
+  getNBytes() const
+  {
+    return m_nBytes;
+  }
+
+  uint64_t
+  getNReassembled() const
+  {
+    return m_nReassembled;
+  }
+
+  /**
+   * @brief number of partial packets dropped because not all their fragments arrived in time
+   */
+  uint64_t
+  getNTimedOut() const
+  {
+    return m_nTimedOut;
+  }
+
+  /**
+   * @brief number of partial packets dropped to stay within the capacity
+   */
+  uint64_t
+  getNEvicted() const
+  {
+    return m_nEvicted;
+  }
+
+  /**
+   * @brief number of fragments that are malformed or inconsistent with the other fragments
+   */
+  uint64_t
+  getNInvalid() const
+  {
+    return m_nInvalid;
+  }
+
+private:
+  struct Key
+  {
+    FlowKey flow;
+    uint64_t firstSequence;
+
+    friend bool
+    operator==(const Key& a, const Key& b)
+    {
+      return a.flow == b.flow && a.firstSequence == b.firstSequence;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t
+    operator()(const Key& key) const;
+  };
+
+  /// expiry time in microseconds => key of the entry, which is stable in an unordered_map
+  using ExpiryQueue = std::multimap<int64_t, const Key*>;
+
+  struct Entry
+  {
+    uint64_t fragCount;
+    size_t nReceived = 0;
+    size_t nBytes = 0;
+    std::vector<std::string> fragments; ///< TLV-VALUE of the Fragment field, by FragIndex
+    std::vector<bool> hasFragment;
+    std::string header; ///< other fields of the first fragment
+    ExpiryQueue::iterator expiry;
+  };
+
+  using Table = std::unordered_map<Key, Entry, KeyHash>;
+
+  /**
+   * @brief drop the partial packets that expired before @p now
+   */
+  void
+  expire(int64_t now);
+
+  /**
+   * @brief drop the oldest partial packets until the limits are respected
+   */
+  void
+  evict();
+
+  void
+  erase(Table::iterator entry);
+
+  void
+  reassemble(const Entry& entry);
+
+private:
+  const Options m_options;
+
+  Table m_table;
+  ExpiryQueue m_expiryQueue;
+  size_t m_nBytes = 0;
+  Buffer m_packet; ///< last reassembled packet, reused to avoid allocating
+
+  uint64_t m_nReassembled = 0;
+  uint64_t m_nTimedOut = 0;
+  uint64_t m_nEvicted = 0;
+  uint64_t m_nInvalid = 0;
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_FRAGMENT_REASSEMBLER_HPP
@@ -26,6 +26,7 @@
 #include <boost/program_options/parsers.hpp>
 #include <boost/program_options/variables_map.hpp>
 
+#include <csignal>
 #include <sstream>
 
 namespace ndn {
@@ -33,6 +34,16 @@ namespace dump {
 
 namespace po = boost::program_options;
 
+static NdnDump* g_instance = nullptr;
+
+static void
+stopOnSignal(int)
+{
+  if (g_instance != nullptr) {
+    g_instance->stop();
+  }
+}
+
 static void
 usage(std::ostream& os, const std::string& appName, const po::options_description& options)
 {
@@ -49,7 +60,9 @@ main(int argc, char* argv[])
 {
   NdnDump instance;
   std::string nameFilter;
+  std::string nameRegex;
   std::vector<std::string> pcapFilter;
+  std::string outputFormat;
 
   po::options_description visibleOptions("Options");
   visibleOptions.add_options()
@@ -61,11 +74,56 @@ main(int argc, char* argv[])
     ("read,r",      po::value<std::string>(&instance.inputFile),
                     "read packets from the specified file; use \"-\" to read from standard input")
     ("filter,f",    po::value<std::string>(&nameFilter),
-                    "print packet only if name matches this regular expression")
+                    "print packet only if name starts with this prefix, where a \"*\" component "
+                    "matches any component; a regular expression is still accepted, see '--regex'")
+    ("regex",       po::value<std::string>(&nameRegex),
+                    "print packet only if name URI matches this regular expression (slow)")
     ("no-promiscuous-mode,p", po::bool_switch(), "do not put the interface into promiscuous mode")
     ("no-timestamp,t",        po::bool_switch(), "do not print a timestamp for each packet")
     ("verbose,v",   po::bool_switch(&instance.wantVerbose),
                     "print more detailed information about each packet")
+    ("format",      po::value<std::string>(&outputFormat)->default_value("text"),
+                    "print each NDN packet as a line of 'text', a 'json' object per line, "
+                    "or a length-prefixed 'binary' record")
+    ("decoders",    po::value<size_t>(&instance.nDecoders)->default_value(instance.nDecoders),
+                    "decode packets on this many threads, while the main thread only captures them "
+                    "(0 = decode on the main thread); a file given to '--read' is instead mapped "
+                    "into memory and split into chunks that are decoded in parallel")
+    ("queue-size",  po::value<size_t>(&instance.queueCapacity)->default_value(instance.queueCapacity),
+                    "number of packets that can wait for each decoder thread")
+    ("mmap",        po::bool_switch(&instance.wantPacketMmap),
+                    "capture through a TPACKET_V3 memory-mapped ring instead of libpcap (Linux only)")
+    ("ring-size",   po::value<size_t>()->default_value(instance.ringSize >> 20),
+                    "size of the TPACKET_V3 ring, in MiB")
+    ("fanout",      po::value<uint16_t>(),
+                    "join this PACKET_FANOUT group, so that several ndndump processes "
+                    "capturing with '--mmap' on the same interface share its traffic")
+    ("stats",       po::bool_switch(&instance.wantStatistics),
+                    "print the busiest name prefixes and faces periodically, instead of each packet")
+    ("stats-depth", po::value<size_t>(&instance.statisticsOptions.depth)
+                      ->default_value(instance.statisticsOptions.depth),
+                    "number of name components in the prefixes counted by '--stats'")
+    ("stats-top",   po::value<size_t>(&instance.statisticsOptions.topN)
+                      ->default_value(instance.statisticsOptions.topN),
+                    "number of prefixes and faces printed by '--stats'")
+    ("stats-interval", po::value<time::seconds::rep>()
+                      ->default_value(instance.statisticsOptions.interval.count()),
+                    "seconds of capture time between two '--stats' snapshots "
+                    "(0 = only when the capture ends)")
+    ("rtt",         po::bool_switch(&instance.wantRtt),
+                    "match Data and Nacks to Interests, print the RTT of each exchange, "
+                    "and summarize the exchanges per prefix when the capture ends")
+    ("rtt-depth",   po::value<size_t>(&instance.exchangeOptions.depth)
+                      ->default_value(instance.exchangeOptions.depth),
+                    "number of name components in the prefixes summarized by '--rtt'")
+    ("rtt-capacity", po::value<size_t>(&instance.exchangeOptions.capacity)
+                      ->default_value(instance.exchangeOptions.capacity),
+                    "maximum number of pending Interests, and of prefixes, kept by '--rtt'")
+    ("reassemble",  po::bool_switch(&instance.wantReassembly),
+                    "reassemble NDNLPv2 fragments and TCP streams, and print the reassembled packets")
+    ("reassembly-timeout", po::value<time::milliseconds::rep>()
+                      ->default_value(instance.reassemblyOptions.timeout.count()),
+                    "milliseconds of capture time to receive all fragments of a packet")
     ("version,V",   "print program version and exit")
     ;
 
@@ -113,9 +171,44 @@ main(int argc, char* argv[])
     return 2;
   }
 
-  if (vm.count("filter") > 0) {
+  if (instance.wantPacketMmap && vm.count("read") > 0) {
+    std::cerr << "ERROR: '--mmap' cannot be used with '--read'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (vm.count("fanout") > 0 && !instance.wantPacketMmap) {
+    std::cerr << "ERROR: '--fanout' requires '--mmap'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  // '--filter' used to take a regular expression, keep accepting one
+  bool isFilterRegex = vm.count("filter") > 0 && NameFilter::isRegex(nameFilter);
+  if (isFilterRegex) {
+    if (vm.count("regex") > 0) {
+      std::cerr << "ERROR: '--filter' looks like a regular expression and cannot be combined "
+                   "with '--regex'" << std::endl;
+      return 2;
+    }
+    std::cerr << "WARNING: matching '--filter' as a regular expression; "
+                 "use '--regex' instead" << std::endl;
+    nameRegex = nameFilter;
+  }
+
+  if (vm.count("filter") > 0 && !isFilterRegex) {
     try {
-      instance.nameFilter = std::regex(nameFilter);
+      instance.nameFilter.emplace(nameFilter);
+    }
+    catch (const NameFilter::Error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+      return 2;
+    }
+  }
+
+  if (vm.count("regex") > 0 || isFilterRegex) {
+    try {
+      instance.nameRegex = std::regex(nameRegex);
     }
     catch (const std::regex_error& e) {
       std::cerr << "ERROR: invalid filter regex: " << e.what() << std::endl;
@@ -129,9 +222,92 @@ main(int argc, char* argv[])
     instance.pcapFilter = os.str();
   }
 
+  if (outputFormat == "text") {
+    instance.outputFormat = OutputFormat::TEXT;
+  }
+  else if (outputFormat == "json") {
+    instance.outputFormat = OutputFormat::JSON;
+  }
+  else if (outputFormat == "binary") {
+    instance.outputFormat = OutputFormat::BINARY;
+  }
+  else {
+    std::cerr << "ERROR: '--format' must be 'text', 'json', or 'binary'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
   instance.wantPromisc = !vm["no-promiscuous-mode"].as<bool>();
   instance.wantTimestamp = !vm["no-timestamp"].as<bool>();
 
+  if (instance.queueCapacity == 0) {
+    std::cerr << "ERROR: '--queue-size' must be positive\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  instance.ringSize = vm["ring-size"].as<size_t>() << 20;
+  if (instance.ringSize == 0) {
+    std::cerr << "ERROR: '--ring-size' must be positive\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (vm.count("fanout") > 0) {
+    instance.fanoutGroup = vm["fanout"].as<uint16_t>();
+  }
+
+  if (instance.wantStatistics && instance.nDecoders > 0) {
+    std::cerr << "ERROR: '--stats' cannot be used with '--decoders'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (instance.wantStatistics && instance.outputFormat != OutputFormat::TEXT) {
+    std::cerr << "ERROR: '--stats' cannot be used with '--format " << outputFormat << "'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (instance.wantRtt && instance.nDecoders > 0) {
+    std::cerr << "ERROR: '--rtt' cannot be used with '--decoders'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (instance.exchangeOptions.capacity == 0) {
+    std::cerr << "ERROR: '--rtt-capacity' must be positive\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  if (instance.wantReassembly && instance.nDecoders > 0) {
+    std::cerr << "ERROR: '--reassemble' cannot be used with '--decoders'\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+
+  auto reassemblyTimeout = vm["reassembly-timeout"].as<time::milliseconds::rep>();
+  if (reassemblyTimeout <= 0) {
+    std::cerr << "ERROR: '--reassembly-timeout' must be positive\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+  instance.reassemblyOptions.timeout = time::milliseconds(reassemblyTimeout);
+
+  auto statsInterval = vm["stats-interval"].as<time::seconds::rep>();
+  if (statsInterval < 0) {
+    std::cerr << "ERROR: '--stats-interval' cannot be negative\n\n";
+    usage(std::cerr, argv[0], visibleOptions);
+    return 2;
+  }
+  instance.statisticsOptions.interval = time::seconds(statsInterval);
+
+  // print the remaining packets and the drop counters when interrupted
+  g_instance = &instance;
+  std::signal(SIGINT, &stopOnSignal);
+  std::signal(SIGTERM, &stopOnSignal);
+
   try {
     instance.run();
   }
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "name-filter.hpp"
+
+#include <cstring>
+
+namespace ndn {
+namespace dump {
+
+NameFilter::NameFilter(const std::string& pattern)
+{
+  std::string uri = pattern;
+  if (uri.compare(0, 4, "ndn:") == 0) {
+    uri.erase(0, 4);
+  }
+  if (uri.empty() || uri.front() != '/') {
+    NDN_THROW(Error("name filter '" + pattern + "' does not start with '/'"));
+  }
+
+  size_t begin = 1;
+  while (begin < uri.size()) {
+    size_t end = std::min(uri.find('/', begin), uri.size());
+    std::string token = uri.substr(begin, end - begin);
+    if (token.empty()) {
+      // like ndn::Name, ignore empty components
+    }
+    else if (token == "*") {
+      m_components.push_back(nullopt);
+    }
+    else {
+      try {
+        m_components.push_back(name::Component::fromEscapedString(token));
+      }
+      catch (const name::Component::Error& e) {
+        NDN_THROW(Error("invalid component '" + token + "' in name filter '" + pattern + "': " +
+                        e.what()));
+      }
+    }
+    begin = end + 1;
+  }
+}
+
+bool
+NameFilter::match(const uint8_t* value, size_t size) const
+{
+  const uint8_t* pos = value;
+  const uint8_t* end = value + size;
+
+  for (const auto& component : m_components) {
+    uint32_t type = 0;
+    uint64_t length = 0;
+    if (!tlv::readType(pos, end, type) || !tlv::readVarNumber(pos, end, length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      return false;
+    }
+
+    if (component && (component->type() != type || component->value_size() != length ||
+                      std::memcmp(component->value(), pos, length) != 0)) {
+      return false;
+    }
+    pos += length;
+  }
+  return true;
+}
+
+bool
+NameFilter::match(const Name& name) const
+{
+  if (name.size() < m_components.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < m_components.size(); ++i) {
+    if (m_components[i] && *m_components[i] != name[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+NameFilter::isRegex(const std::string& pattern)
+{
+  if (pattern.find_first_of("^$|?+()[]{}\\") != std::string::npos) {
+    return true;
+  }
+
+  for (size_t pos = pattern.find('*'); pos != std::string::npos; pos = pattern.find('*', pos + 1)) {
+    bool isComponent = pos > 0 && pattern[pos - 1] == '/' &&
+                       (pos + 1 == pattern.size() || pattern[pos + 1] == '/');
+    if (!isComponent) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace dump
+} // namespace ndn
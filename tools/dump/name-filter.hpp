@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_NAME_FILTER_HPP
+#define NDN_TOOLS_DUMP_NAME_FILTER_HPP
+
+#include "core/common.hpp"
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Name prefix pattern, matched on the encoded Name without decoding it
+ *
+ * A pattern is written like a Name URI, e.g. "/ndn/edu/*". Each component of the pattern
+ * must equal the component at the same position in the name, except "*", which matches any
+ * single component ("%2A" is a literal asterisk). A name matches if it starts with components
+ * matching the whole pattern; the pattern "/" matches every name.
+ *
+ * Components are compared by TLV-TYPE and TLV-VALUE, as ndn::Name does, so typed components
+ * can be written in their URI form, e.g. "/ndn/v=3/seg=0".
+ */
+class NameFilter
+{
+public:
+  class Error : public std::invalid_argument
+  {
+  public:
+    using std::invalid_argument::invalid_argument;
+  };
+
+  /**
+   * @throw Error @p pattern is not a valid pattern
+   */
+  explicit
+  NameFilter(const std::string& pattern);
+
+  /**
+   * @brief match the name whose TLV-VALUE is [@p value, @p value + @p size)
+   * @return whether the name matches; false if the encoding is invalid
+   */
+  bool
+  match(const uint8_t* value, size_t size) const;
+
+  bool
+  match(const Name& name) const;
+
+  /**
+   * @brief whether @p pattern is meant as a regular expression rather than a NameFilter
+   *
+   * Earlier versions of ndndump matched the '--filter' argument as a regular expression on
+   * the Name URI. A pattern is taken to be such an expression if it contains any of the
+   * characters <tt>^$|?+()[]{}\\</tt> or a '*' that is not a whole component. '.' is not
+   * considered, because it often appears in name components and matches itself in a regular
+   * expression.
+   */
+  static bool
+  isRegex(const std::string& pattern);
+
+  /**
+   * @brief number of components of the pattern, i.e. the minimum length of a matching name
+   */
+  size_t
+  size() const
+  {
+    return m_components.size();
+  }
+
+private:
+  std::vector<optional<name::Component>> m_components; ///< nullopt is a "*" wildcard
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_NAME_FILTER_HPP
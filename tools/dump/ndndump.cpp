@@ -18,6 +18,10 @@
  */
 
 #include "ndndump.hpp"
+#include "capture-file.hpp"
+#include "decode-pipeline.hpp"
+#include "file-decoder.hpp"
+#include "packet-mmap-capture.hpp"
 
 #include <arpa/inet.h>
 #include <net/ethernet.h>
@@ -27,9 +31,10 @@
 #include <netinet/udp.h>
 
 #include <pcap/sll.h>
+#include <sys/stat.h>
 
+#include <cstring>
 #include <iomanip>
-#include <sstream>
 
 #include <ndn-cxx/lp/nack.hpp>
 #include <ndn-cxx/lp/packet.hpp>
@@ -46,12 +51,28 @@ namespace endian = boost::endian;
 class OutputFormatter : noncopyable
 {
 public:
-  OutputFormatter(std::ostream& os, std::string d)
-    : m_os(os)
+  /**
+   * @param lineStart position in @p buffer where the line of the packet begins
+   * @param isSilent if true, the text is discarded, and only getStream() writes to @p buffer
+   */
+  OutputFormatter(OutputBuffer& buffer, size_t lineStart, std::string d, bool isSilent = false)
+    : m_buffer(buffer)
+    , m_os(buffer.getStream())
+    , m_lineStart(lineStart)
     , m_delim(std::move(d))
+    , m_isSilent(isSilent)
   {
   }
 
+  /**
+   * @brief stream of the output buffer, for output that is not part of the line of text
+   */
+  std::ostream&
+  getStream()
+  {
+    return m_os;
+  }
+
   OutputFormatter&
   addDelimiter()
   {
@@ -61,11 +82,63 @@ public:
     return *this;
   }
 
+  /**
+   * @brief position of the end of the output, to be passed to truncate() or getLine()
+   */
+  size_t
+  getMark() const
+  {
+    return m_buffer.size();
+  }
+
+  /**
+   * @brief discard the output written after @p mark
+   */
+  void
+  truncate(size_t mark)
+  {
+    m_buffer.truncate(mark);
+    m_wantDelim = false;
+  }
+
+  /**
+   * @brief text of the current line up to @p mark
+   */
+  std::string
+  getLine(size_t mark) const
+  {
+    return std::string(m_buffer.data() + m_lineStart, mark - m_lineStart);
+  }
+
+  /**
+   * @brief end the current line, and start another one with @p text
+   */
+  void
+  startLine(const std::string& text)
+  {
+    if (m_isSilent) {
+      return;
+    }
+    m_os << '\n';
+    m_lineStart = m_buffer.size();
+    m_os << text;
+    m_isEmpty = false;
+    m_wantDelim = false;
+  }
+
+public:
+  timeval timestamp{}; ///< capture time of the packet being formatted
+  size_t frameSize = 0; ///< length of the packet being formatted, on the wire
+  FlowKey flow; ///< endpoints of the packet, filled in by the dissectors
+
 private:
+  OutputBuffer& m_buffer;
   std::ostream& m_os;
+  size_t m_lineStart;
   std::string m_delim;
   bool m_isEmpty = true;
   bool m_wantDelim = false;
+  bool m_isSilent;
 
   template<typename T>
   friend OutputFormatter& operator<<(OutputFormatter&, const T&);
@@ -75,6 +148,9 @@ template<typename T>
 OutputFormatter&
 operator<<(OutputFormatter& out, const T& val)
 {
+  if (out.m_isSilent) {
+    return out;
+  }
   if (out.m_wantDelim) {
     out.m_os << out.m_delim;
     out.m_wantDelim = false;
@@ -84,8 +160,27 @@ operator<<(OutputFormatter& out, const T& val)
   return out;
 }
 
+static void
+printRtt(OutputFormatter& out, const optional<time::microseconds>& rtt)
+{
+  if (rtt) {
+    out.addDelimiter() << "RTT " << AsMilliseconds{*rtt} << " ms";
+  }
+}
+
+static bool
+isRegularFile(const std::string& filename)
+{
+  struct stat st{};
+  return ::stat(filename.data(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+NdnDump::NdnDump() = default;
+
 NdnDump::~NdnDump()
 {
+  if (m_fileFilter.bf_insns != nullptr)
+    pcap_freecode(&m_fileFilter);
   if (m_pcap)
     pcap_close(m_pcap);
 }
@@ -106,13 +201,42 @@ NdnDump::run()
   }
 
   std::string action;
-  if (!interface.empty()) {
+  if (wantPacketMmap) {
+    if (interface.empty()) {
+      NDN_THROW(Error("TPACKET_V3 capture requires an interface"));
+    }
+
+    PacketMmapCapture::Options captureOpts;
+    captureOpts.interface = interface;
+    captureOpts.filter = pcapFilter;
+    captureOpts.ringSize = ringSize;
+    captureOpts.fanoutGroup = fanoutGroup;
+    captureOpts.wantPromisc = wantPromisc;
+    m_mmapCapture = make_unique<PacketMmapCapture>(captureOpts);
+    action = "listening on " + interface + " with a " + to_string(ringSize >> 20) + " MiB TPACKET_V3 ring";
+    if (fanoutGroup) {
+      action += " in fanout group " + to_string(*fanoutGroup);
+    }
+    m_dataLinkType = m_mmapCapture->getLinkType();
+  }
+  else if (!interface.empty()) {
     m_pcap = pcap_open_live(interface.data(), 65535, wantPromisc, 1000, errbuf);
     if (m_pcap == nullptr) {
       NDN_THROW(Error("Cannot open interface " + interface + ": " + errbuf));
     }
     action = "listening on " + interface;
   }
+  else if (nDecoders > 0 && isRegularFile(inputFile)) {
+    // the file is mapped and its chunks are decoded in parallel, libpcap only compiles the filter
+    m_captureFile = make_unique<CaptureFile>(inputFile, fileChunkSize);
+    // LINKTYPE_ and DLT_ values are the same for the supported link types
+    m_pcap = pcap_open_dead(m_captureFile->getLinkType(), 65535);
+    if (m_pcap == nullptr) {
+      NDN_THROW(Error("Cannot open file '" + inputFile + "' for reading"));
+    }
+    action = "reading from file " + inputFile + " in " +
+             to_string(m_captureFile->getChunks().size()) + " chunks";
+  }
   else {
     m_pcap = pcap_open_offline(inputFile.data(), errbuf);
     if (m_pcap == nullptr) {
@@ -121,7 +245,9 @@ NdnDump::run()
     action = "reading from file " + inputFile;
   }
 
-  m_dataLinkType = pcap_datalink(m_pcap);
+  if (m_pcap != nullptr) {
+    m_dataLinkType = pcap_datalink(m_pcap);
+  }
   const char* dltName = pcap_datalink_val_to_name(m_dataLinkType);
   const char* dltDesc = pcap_datalink_val_to_description(m_dataLinkType);
   std::string formattedDlt = dltName ? dltName : to_string(m_dataLinkType);
@@ -146,70 +272,268 @@ NdnDump::run()
       std::cerr << "ndndump: using pcap filter: " << pcapFilter << std::endl;
     }
 
-    bpf_program program;
-    int res = pcap_compile(m_pcap, &program, pcapFilter.data(), 1, PCAP_NETMASK_UNKNOWN);
-    if (res < 0) {
-      NDN_THROW(Error("Cannot compile pcap filter '" + pcapFilter + "': " + pcap_geterr(m_pcap)));
+    // the TPACKET_V3 socket has its filter attached already
+    if (m_pcap != nullptr) {
+      bpf_program program;
+      int res = pcap_compile(m_pcap, &program, pcapFilter.data(), 1, PCAP_NETMASK_UNKNOWN);
+      if (res < 0) {
+        NDN_THROW(Error("Cannot compile pcap filter '" + pcapFilter + "': " + pcap_geterr(m_pcap)));
+      }
+
+      if (m_captureFile != nullptr) {
+        // applied by the decoder threads to each record
+        m_fileFilter = program;
+      }
+      else {
+        res = pcap_setfilter(m_pcap, &program);
+        pcap_freecode(&program);
+        if (res < 0) {
+          NDN_THROW(Error("Cannot set pcap filter: "s + pcap_geterr(m_pcap)));
+        }
+      }
+    }
+  }
+
+  if (wantStatistics) {
+    if (nDecoders > 0) {
+      NDN_THROW(Error("Statistics mode requires decoding on the main thread"));
+    }
+    if (outputFormat != OutputFormat::TEXT) {
+      NDN_THROW(Error("Statistics mode only prints text"));
     }
+    m_statistics = make_unique<TrafficStatistics>(statisticsOptions, std::cout);
+  }
+
+  if (wantRtt) {
+    if (nDecoders > 0) {
+      NDN_THROW(Error("RTT measurement requires decoding on the main thread"));
+    }
+    m_exchanges = make_unique<ExchangeTracker>(exchangeOptions);
+  }
 
-    res = pcap_setfilter(m_pcap, &program);
-    pcap_freecode(&program);
-    if (res < 0) {
-      NDN_THROW(Error("Cannot set pcap filter: "s + pcap_geterr(m_pcap)));
+  if (wantReassembly) {
+    if (nDecoders > 0) {
+      NDN_THROW(Error("Fragment reassembly requires decoding on the main thread"));
     }
+    m_reassembler = make_unique<FragmentReassembler>(reassemblyOptions);
+    m_tcpReassembler = make_unique<TcpReassembler>(tcpReassemblyOptions);
+  }
+
+  if (outputFormat == OutputFormat::BINARY) {
+    // written before any decoder thread starts printing
+    std::cout.write(BINARY_HEADER, sizeof(BINARY_HEADER));
+    std::cout.flush();
   }
 
-  auto callback = [] (uint8_t* user, const pcap_pkthdr* pkthdr, const uint8_t* payload) {
-    reinterpret_cast<const NdnDump*>(user)->printPacket(pkthdr, payload);
-  };
+  if (m_captureFile != nullptr) {
+    m_fileDecoder = make_unique<FileDecoder>(*m_captureFile, nDecoders,
+      [this] (OutputBuffer& out, const pcap_pkthdr& pkthdr, const uint8_t* payload) {
+        if (m_fileFilter.bf_insns == nullptr ||
+            pcap_offline_filter(&m_fileFilter, &pkthdr, payload) != 0) {
+          formatPacket(out, &pkthdr, payload);
+        }
+      },
+      std::cout);
+  }
+  else if (nDecoders > 0) {
+    // packets are dropped only when capturing live traffic
+    m_pipeline = make_unique<DecodePipeline>(nDecoders, queueCapacity, !interface.empty(),
+      [this] (OutputBuffer& out, const pcap_pkthdr& pkthdr, const uint8_t* payload) {
+        formatPacket(out, &pkthdr, payload);
+      },
+      std::cout);
+  }
+
+  int res = 0;
+  m_isBatching = true;
+  if (m_fileDecoder != nullptr) {
+    m_fileDecoder->run();
+  }
+  else if (m_mmapCapture != nullptr) {
+    // output is flushed once per ring block
+    m_mmapCapture->run([this] (const pcap_pkthdr* pkthdr, const uint8_t* payload) { handlePacket(pkthdr, payload); },
+                       [this] { flushOutput(); });
+  }
+  else {
+    auto callback = [] (uint8_t* user, const pcap_pkthdr* pkthdr, const uint8_t* payload) {
+      reinterpret_cast<NdnDump*>(user)->handlePacket(pkthdr, payload);
+    };
+
+    // pcap_dispatch returns 0 at the end of a file, or when the read timeout expires on a live capture
+    do {
+      res = pcap_dispatch(m_pcap, -1, callback, reinterpret_cast<uint8_t*>(this));
+      flushOutput();
+    } while (!m_shouldStop && (res > 0 || (res == 0 && !interface.empty())));
+  }
+  m_isBatching = false;
+
+  if (m_pipeline != nullptr) {
+    m_pipeline->finish();
+  }
+  if (m_statistics != nullptr) {
+    m_statistics->printSnapshot();
+  }
+  if (m_exchanges != nullptr) {
+    // the summary is text, it does not belong in a structured output
+    m_exchanges->printSummary(outputFormat == OutputFormat::TEXT ? std::cout : std::cerr);
+  }
+  printStatistics();
+  m_pipeline.reset();
+
+  if (res == -1) {
+    NDN_THROW(Error("pcap_dispatch: "s + pcap_geterr(m_pcap)));
+  }
+  if (m_captureFile != nullptr && m_captureFile->isTruncated() && !m_shouldStop) {
+    NDN_THROW(Error("Truncated capture file '" + inputFile + "'"));
+  }
+}
 
-  if (pcap_loop(m_pcap, -1, callback, reinterpret_cast<uint8_t*>(this)) < 0) {
-    NDN_THROW(Error("pcap_loop: "s + pcap_geterr(m_pcap)));
+void
+NdnDump::handlePacket(const pcap_pkthdr* pkthdr, const uint8_t* payload)
+{
+  if (m_pipeline != nullptr) {
+    // the capture thread only copies the packet, a decoder thread will print it
+    m_pipeline->push(pkthdr, payload);
+  }
+  else {
+    printPacket(pkthdr, payload);
   }
 }
 
 void
-NdnDump::printPacket(const pcap_pkthdr* pkthdr, const uint8_t* payload) const
+NdnDump::stop()
 {
-  // sanity checks
+  m_shouldStop = true;
+  if (m_pcap != nullptr) {
+    pcap_breakloop(m_pcap);
+  }
+  if (m_mmapCapture != nullptr) {
+    m_mmapCapture->stop();
+  }
+  if (m_fileDecoder != nullptr) {
+    m_fileDecoder->stop();
+  }
+}
+
+void
+NdnDump::printPacket(const pcap_pkthdr* pkthdr, const uint8_t* payload)
+{
+  formatPacket(m_output, pkthdr, payload);
+
+  if (!m_isBatching || m_output.size() >= OutputBuffer::FLUSH_THRESHOLD) {
+    flushOutput();
+  }
+}
+
+void
+NdnDump::formatPacket(OutputBuffer& output, const pcap_pkthdr* pkthdr, const uint8_t* payload) const
+{
+  std::ostream& os = output.getStream();
+
+  bool isText = outputFormat == OutputFormat::TEXT;
+
+  // sanity checks; the structured formats only contain NDN packets, so they skip these silently
+  if (!isText && (pkthdr->caplen == 0 || pkthdr->len == 0 || pkthdr->len < pkthdr->caplen)) {
+    return;
+  }
   if (pkthdr->caplen == 0) {
-    std::cout << "[Invalid header: caplen=0]" << std::endl;
+    os << "[Invalid header: caplen=0]\n";
     return;
   }
   if (pkthdr->len == 0) {
-    std::cout << "[Invalid header: len=0]" << std::endl;
+    os << "[Invalid header: len=0]\n";
     return;
   }
   else if (pkthdr->len < pkthdr->caplen) {
-    std::cout << "[Invalid header: len(" << pkthdr->len
-              << ") < caplen(" << pkthdr->caplen << ")]" << std::endl;
+    os << "[Invalid header: len(" << pkthdr->len
+       << ") < caplen(" << pkthdr->caplen << ")]\n";
     return;
   }
 
-  std::ostringstream os;
-  OutputFormatter out(os, ", ");
+  // the packet is formatted directly into the output buffer, and discarded if not printed
+  size_t mark = output.size();
+  if (wantTimestamp && isText) {
+    printTimestamp(os, pkthdr->ts);
+  }
 
+  OutputFormatter out(output, mark, ", ", !isText);
+  out.timestamp = pkthdr->ts;
+  out.frameSize = pkthdr->len;
+  // only the captured bytes are available; the printers report a truncated capture as such
   bool shouldPrint = false;
   switch (m_dataLinkType) {
   case DLT_EN10MB:
-    shouldPrint = printEther(out, payload, pkthdr->len);
+    shouldPrint = printEther(out, payload, pkthdr->caplen);
     break;
   case DLT_LINUX_SLL:
-    shouldPrint = printLinuxSll(out, payload, pkthdr->len);
+    shouldPrint = printLinuxSll(out, payload, pkthdr->caplen);
     break;
   case DLT_PPP:
-    shouldPrint = printPpp(out, payload, pkthdr->len);
+    shouldPrint = printPpp(out, payload, pkthdr->caplen);
     break;
   default:
     BOOST_ASSERT(false);
-    return;
+    break;
   }
 
-  if (shouldPrint) {
-    if (wantTimestamp) {
-      printTimestamp(std::cout, pkthdr->ts);
+  // in statistics mode, packets are only counted; each structured record ends itself
+  if (shouldPrint && m_statistics == nullptr) {
+    if (isText) {
+      os << '\n';
     }
-    std::cout << os.str() << std::endl;
+  }
+  else {
+    output.truncate(mark);
+  }
+}
+
+void
+NdnDump::flushOutput()
+{
+  m_output.flushTo(std::cout);
+}
+
+void
+NdnDump::printStatistics() const
+{
+  pcap_stat ps{};
+  if (m_mmapCapture != nullptr) {
+    auto stats = m_mmapCapture->getStatistics();
+    std::cerr << "ndndump: " << stats.nReceived << " packets received by filter, "
+              << stats.nDropped << " dropped by kernel, "
+              << "ring full " << stats.nFreezes << " times" << std::endl;
+  }
+  else if (!interface.empty() && pcap_stats(m_pcap, &ps) == 0) {
+    std::cerr << "ndndump: " << ps.ps_recv << " packets received by filter, "
+              << ps.ps_drop << " dropped by kernel, "
+              << ps.ps_ifdrop << " dropped by interface" << std::endl;
+  }
+
+  if (m_pipeline != nullptr) {
+    std::cerr << "ndndump: " << m_pipeline->getNQueued() << " packets decoded, "
+              << m_pipeline->getNDropped() << " dropped because the decoder queues were full"
+              << std::endl;
+  }
+
+  if (m_fileDecoder != nullptr) {
+    std::cerr << "ndndump: " << m_fileDecoder->getNDecoded() << " packets decoded, "
+              << m_fileDecoder->getNChunksDone() << " of " << m_captureFile->getChunks().size()
+              << " chunks printed" << std::endl;
+  }
+
+  if (m_reassembler != nullptr) {
+    std::cerr << "ndndump: " << m_reassembler->getNReassembled() << " packets reassembled, "
+              << m_reassembler->getNTimedOut() << " timed out, "
+              << m_reassembler->getNEvicted() << " evicted, "
+              << m_reassembler->size() << " incomplete at the end of the capture, "
+              << m_reassembler->getNInvalid() << " invalid fragments" << std::endl;
+  }
+
+  if (m_tcpReassembler != nullptr) {
+    std::cerr << "ndndump: " << m_tcpReassembler->getNPackets() << " packets extracted from TCP streams, "
+              << m_tcpReassembler->getNResyncs() << " resynchronizations, "
+              << m_tcpReassembler->getNSkippedBytes() << " bytes skipped, "
+              << m_tcpReassembler->getNEvicted() << " streams evicted" << std::endl;
   }
 }
 
@@ -273,6 +597,9 @@ NdnDump::printEther(OutputFormatter& out, const uint8_t* pkt, size_t len) const
   }
 
   auto ether = reinterpret_cast<const ether_header*>(pkt);
+  out.flow.family = FlowKey::Family::ETHERNET;
+  std::copy_n(ether->ether_shost, ethernet::ADDR_LEN, out.flow.srcAddr.begin());
+  std::copy_n(ether->ether_dhost, ethernet::ADDR_LEN, out.flow.dstAddr.begin());
   pkt += ethernet::HDR_LEN;
   len -= ethernet::HDR_LEN;
 
@@ -291,6 +618,10 @@ NdnDump::printLinuxSll(OutputFormatter& out, const uint8_t* pkt, size_t len) con
   }
 
   auto sll = reinterpret_cast<const sll_header*>(pkt);
+  // only the sender's address is captured
+  out.flow.family = FlowKey::Family::ETHERNET;
+  std::copy_n(sll->sll_addr, std::min<size_t>(endian::big_to_native(sll->sll_halen), ethernet::ADDR_LEN),
+              out.flow.srcAddr.begin());
   pkt += SLL_HDR_LEN;
   len -= SLL_HDR_LEN;
 
@@ -397,11 +728,18 @@ NdnDump::printIp4(OutputFormatter& out, const uint8_t* pkt, size_t len) const
   }
   // if we reached this point, the following is true:
   //     sizeof(ip) <= ipHdrLen <= ipLen <= len
+  // the rest of the frame is link-layer padding
+  len = ipLen;
 
   printIpAddress(out, AF_INET, &ih->ip_src);
   out << " > ";
   printIpAddress(out, AF_INET, &ih->ip_dst);
 
+  out.flow = {};
+  out.flow.family = FlowKey::Family::IPV4;
+  std::memcpy(out.flow.srcAddr.data(), &ih->ip_src, sizeof(ih->ip_src));
+  std::memcpy(out.flow.dstAddr.data(), &ih->ip_dst, sizeof(ih->ip_dst));
+
   pkt += ipHdrLen;
   len -= ipHdrLen;
 
@@ -434,15 +772,37 @@ NdnDump::printIp6(OutputFormatter& out, const uint8_t* pkt, size_t len) const
     out << "truncated payload, " << payloadLen - len << " bytes missing";
     return true;
   }
+  if (payloadLen > 0) {
+    // the rest of the frame is link-layer padding; a zero length is used by jumbograms
+    len = payloadLen;
+  }
 
   printIpAddress(out, AF_INET6, &ip6->ip6_src);
   out << " > ";
   printIpAddress(out, AF_INET6, &ip6->ip6_dst);
 
+  out.flow = {};
+  out.flow.family = FlowKey::Family::IPV6;
+  std::memcpy(out.flow.srcAddr.data(), &ip6->ip6_src, sizeof(ip6->ip6_src));
+  std::memcpy(out.flow.dstAddr.data(), &ip6->ip6_dst, sizeof(ip6->ip6_dst));
+
   // we assume no extension headers are present
   return dispatchByIpProto(out, pkt, len, ip6->ip6_nxt);
 }
 
+/**
+ * @brief set the transport protocol and ports of @p flow
+ *
+ * Both TCP and UDP headers begin with the source and destination ports.
+ */
+static void
+setPorts(FlowKey& flow, uint8_t protocol, const uint8_t* header)
+{
+  flow.protocol = protocol;
+  flow.srcPort = static_cast<uint16_t>((header[0] << 8) | header[1]);
+  flow.dstPort = static_cast<uint16_t>((header[2] << 8) | header[3]);
+}
+
 bool
 NdnDump::printTcp(OutputFormatter& out, const uint8_t* pkt, size_t len) const
 {
@@ -464,12 +824,57 @@ NdnDump::printTcp(OutputFormatter& out, const uint8_t* pkt, size_t len) const
     return true;
   }
 
+  setPorts(out.flow, IPPROTO_TCP, pkt);
+  TcpReassembler::Segment segment;
+  segment.sequence = (static_cast<uint32_t>(pkt[4]) << 24) | (static_cast<uint32_t>(pkt[5]) << 16) |
+                     (static_cast<uint32_t>(pkt[6]) << 8) | pkt[7];
+  segment.isSyn = (pkt[13] & TH_SYN) != 0;
+  segment.isFin = (pkt[13] & (TH_FIN | TH_RST)) != 0;
   pkt += tcpHdrLen;
   len -= tcpHdrLen;
 
   out.addDelimiter() << "length " << len;
 
-  return printNdn(out, pkt, len);
+  if (m_tcpReassembler == nullptr) {
+    return printNdn(out, pkt, len);
+  }
+  segment.payload = pkt;
+  segment.size = len;
+  return printTcpStream(out, segment);
+}
+
+bool
+NdnDump::printTcpStream(OutputFormatter& out, const TcpReassembler::Segment& segment) const
+{
+  // each NDN packet completed by the segment is printed on its own line, after the same prefix
+  size_t prefixEnd = out.getMark();
+  std::string prefix;
+  size_t nPrinted = 0;
+  size_t nPackets = m_tcpReassembler->add(out.timestamp, out.flow, segment,
+    [&] (const uint8_t* packet, size_t size) {
+      size_t mark = out.getMark();
+      if (nPrinted > 0) {
+        if (prefix.empty()) {
+          prefix = out.getLine(prefixEnd);
+        }
+        out.startLine(prefix);
+      }
+      if (printNdn(out, packet, size)) {
+        ++nPrinted;
+      }
+      else {
+        out.truncate(mark);
+      }
+    });
+
+  if (nPackets > 0) {
+    return nPrinted > 0;
+  }
+  if (segment.size == 0) {
+    return false;
+  }
+  out.addDelimiter() << "NDN partial packet";
+  return true;
 }
 
 bool
@@ -496,6 +901,7 @@ NdnDump::printUdp(OutputFormatter& out, const uint8_t* pkt, size_t len) const
     len = udpLen;
   }
 
+  setPorts(out.flow, IPPROTO_UDP, pkt);
   pkt += sizeof(udphdr);
   len -= sizeof(udphdr);
 
@@ -512,6 +918,17 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
   }
   out.addDelimiter();
 
+  // fast path: the common packets are decoded in place, without allocating; the name regex
+  // matches a Name URI, so it still needs the ndn-cxx decoder
+  PacketView view;
+  if (!nameRegex && view.decode(pkt, len)) {
+    if (m_reassembler != nullptr && view.fragCount.value_or(1) > 1) {
+      out << "NDNLPv2";
+      return printFragment(out, pkt, len, view.fragIndex.value_or(0), *view.fragCount);
+    }
+    return printPacketView(out, view);
+  }
+
   bool isOk = false;
   Block block;
   std::tie(isOk, block) = Block::fromBuffer(pkt, len);
@@ -534,6 +951,12 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
       return true;
     }
 
+    if (m_reassembler != nullptr && lpPacket.has<lp::FragCountField>() &&
+        lpPacket.get<lp::FragCountField>() > 1) {
+      uint64_t fragIndex = lpPacket.has<lp::FragIndexField>() ? lpPacket.get<lp::FragIndexField>() : 0;
+      return printFragment(out, block.wire(), block.size(), fragIndex, lpPacket.get<lp::FragCountField>());
+    }
+
     Buffer::const_iterator begin, end;
     if (lpPacket.has<lp::FragmentField>()) {
       std::tie(begin, end) = lpPacket.get<lp::FragmentField>();
@@ -564,7 +987,30 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
           return false;
         }
 
-        if (lpPacket.has<lp::NackField>()) {
+        bool isNack = lpPacket.has<lp::NackField>();
+        const Block& name = interest.getName().wireEncode();
+        PacketSummary summary{isNack ? TrafficStatistics::PacketType::NACK :
+                                       TrafficStatistics::PacketType::INTEREST,
+                              name.value(), name.value_size(), netPacket.size(),
+                              interest.getCanBePrefix(), interest.getInterestLifetime(),
+                              isNack ? lpPacket.get<lp::NackField>().getReason() :
+                                       lp::NackReason::NONE};
+        // the Nonce octets are taken from the wire, in the same order as PacketView::nonce
+        netPacket.parse();
+        auto nonce = netPacket.find(tlv::Nonce);
+        if (nonce != netPacket.elements_end() && nonce->value_size() == 4) {
+          summary.nonce = nonce->value();
+        }
+        auto rtt = analyzePacket(out, summary);
+        if (m_statistics != nullptr) {
+          return false;
+        }
+        if (outputFormat != OutputFormat::TEXT) {
+          printRecord(out, summary, rtt);
+          return true;
+        }
+
+        if (isNack) {
           lp::Nack nack(interest);
           nack.setHeader(lpPacket.get<lp::NackField>());
           out << "NACK (" << nack.getReason() << "): " << interest;
@@ -572,6 +1018,7 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
         else {
           out << "INTEREST: " << interest;
         }
+        printRtt(out, rtt);
         break;
       }
       case tlv::Data: {
@@ -580,7 +1027,21 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
           return false;
         }
 
+        const Block& name = data.getName().wireEncode();
+        PacketSummary summary{TrafficStatistics::PacketType::DATA,
+                              name.value(), name.value_size(), netPacket.size(),
+                              false, DEFAULT_INTEREST_LIFETIME, lp::NackReason::NONE};
+        auto rtt = analyzePacket(out, summary);
+        if (m_statistics != nullptr) {
+          return false;
+        }
+        if (outputFormat != OutputFormat::TEXT) {
+          printRecord(out, summary, rtt);
+          return true;
+        }
+
         out << "DATA: " << data.getName();
+        printRtt(out, rtt);
         break;
       }
       default: {
@@ -597,13 +1058,131 @@ NdnDump::printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const
 }
 
 bool
-NdnDump::matchesFilter(const Name& name) const
+NdnDump::printPacketView(OutputFormatter& out, const PacketView& packet) const
+{
+  if (packet.isLp) {
+    out << "NDNLPv2";
+    if (packet.isIdle) {
+      out << " idle";
+      return true;
+    }
+    if (packet.isFragment) {
+      out << " fragment";
+      return true;
+    }
+  }
+  if (nameFilter && !nameFilter->match(packet.name.value, packet.name.size)) {
+    return false;
+  }
+
+  auto type = packet.type == tlv::Data ? TrafficStatistics::PacketType::DATA :
+              packet.nackReason ? TrafficStatistics::PacketType::NACK :
+              TrafficStatistics::PacketType::INTEREST;
+  PacketSummary summary{type, packet.name.value, packet.name.size, packet.wireSize,
+                        packet.canBePrefix,
+                        packet.lifetime ? time::milliseconds(*packet.lifetime) : DEFAULT_INTEREST_LIFETIME,
+                        packet.nackReason.value_or(lp::NackReason::NONE), packet.nonce};
+  auto rtt = analyzePacket(out, summary);
+  if (m_statistics != nullptr) {
+    // in statistics mode, packets are only counted
+    return false;
+  }
+  if (outputFormat != OutputFormat::TEXT) {
+    printRecord(out, summary, rtt);
+    return true;
+  }
+  out.addDelimiter();
+
+  if (packet.type == tlv::Interest) {
+    if (packet.nackReason) {
+      out << "NACK (" << *packet.nackReason << "): " << AsInterest{packet};
+    }
+    else {
+      out << "INTEREST: " << AsInterest{packet};
+    }
+  }
+  else {
+    out << "DATA: " << packet.name;
+  }
+  printRtt(out, rtt);
+  return true;
+}
+
+bool
+NdnDump::printFragment(OutputFormatter& out, const uint8_t* pkt, size_t len,
+                       uint64_t fragIndex, uint64_t fragCount) const
 {
-  if (!nameFilter)
+  out << " fragment " << fragIndex + 1 << '/' << fragCount;
+  const Buffer* packet = m_reassembler->add(out.timestamp, out.flow, pkt, len);
+  if (packet == nullptr) {
     return true;
+  }
+
+  // the reassembled packet has no FragCount, so it is not reassembled again
+  out.addDelimiter() << "reassembled";
+  return printNdn(out, packet->data(), packet->size());
+}
+
+optional<time::microseconds>
+NdnDump::analyzePacket(const OutputFormatter& out, const PacketSummary& packet) const
+{
+  if (m_statistics != nullptr) {
+    m_statistics->add(out.timestamp, out.flow, packet.type, packet.name, packet.nameSize,
+                      packet.size, packet.nackReason);
+  }
+
+  if (m_exchanges == nullptr) {
+    return nullopt;
+  }
+
+  switch (packet.type) {
+  case TrafficStatistics::PacketType::INTEREST:
+    m_exchanges->addInterest(out.timestamp, out.flow, packet.name, packet.nameSize,
+                             packet.canBePrefix, packet.lifetime);
+    return nullopt;
+  case TrafficStatistics::PacketType::DATA:
+    return m_exchanges->addData(out.timestamp, out.flow, packet.name, packet.nameSize);
+  case TrafficStatistics::PacketType::NACK:
+    return m_exchanges->addNack(out.timestamp, out.flow, packet.name, packet.nameSize);
+  }
+  return nullopt;
+}
+
+void
+NdnDump::printRecord(OutputFormatter& out, const PacketSummary& packet,
+                     const optional<time::microseconds>& rtt) const
+{
+  PacketRecord record;
+  record.timestamp = out.timestamp;
+  record.flow = out.flow;
+  record.type = packet.type;
+  record.name = packet.name;
+  record.nameSize = packet.nameSize;
+  if (packet.type != TrafficStatistics::PacketType::DATA) {
+    record.nonce = packet.nonce;
+    record.lifetime = packet.lifetime;
+  }
+  record.nackReason = packet.nackReason;
+  record.packetSize = packet.size;
+  record.frameSize = out.frameSize;
+  record.rtt = rtt;
+
+  if (outputFormat == OutputFormat::JSON) {
+    writeJsonRecord(out.getStream(), record);
+  }
+  else {
+    writeBinaryRecord(out.getStream(), record);
+  }
+}
+
+bool
+NdnDump::matchesFilter(const Name& name) const
+{
+  if (nameFilter && !nameFilter->match(name))
+    return false;
 
   /// \todo Switch to NDN regular expressions
-  return std::regex_match(name.toUri(), *nameFilter);
+  return !nameRegex || std::regex_match(name.toUri(), *nameRegex);
 }
 
 } // namespace dump
@@ -20,7 +20,16 @@
 #ifndef NDN_TOOLS_DUMP_NDNDUMP_HPP
 #define NDN_TOOLS_DUMP_NDNDUMP_HPP
 
-#include "core/common.hpp"
+#include "exchange-tracker.hpp"
+#include "fragment-reassembler.hpp"
+#include "name-filter.hpp"
+#include "output-buffer.hpp"
+#include "packet-record.hpp"
+#include "packet-view.hpp"
+#include "tcp-reassembler.hpp"
+#include "traffic-statistics.hpp"
+
+#include <atomic>
 
 #include <pcap.h>
 #include <regex>
@@ -40,7 +49,11 @@
 namespace ndn {
 namespace dump {
 
+class CaptureFile;
+class DecodePipeline;
+class FileDecoder;
 class OutputFormatter;
+class PacketMmapCapture;
 
 class NdnDump : noncopyable
 {
@@ -51,13 +64,38 @@ public:
     using std::runtime_error::runtime_error;
   };
 
+  NdnDump();
+
   ~NdnDump();
 
   void
   run();
 
+  /**
+   * @brief Make run() return after the packets captured so far have been printed
+   *
+   * Can be called from a signal handler.
+   */
+  void
+  stop();
+
+  /**
+   * @brief Format one captured packet and print it
+   *
+   * Inside run(), the output is written to the standard output once per batch of packets
+   * returned by libpcap; otherwise, it is written immediately.
+   */
   void
-  printPacket(const pcap_pkthdr* pkthdr, const uint8_t* payload) const;
+  printPacket(const pcap_pkthdr* pkthdr, const uint8_t* payload);
+
+  /**
+   * @brief Format one captured packet into @p out
+   *
+   * Nothing is written if the packet should not be printed. Can be called concurrently
+   * from several threads.
+   */
+  void
+  formatPacket(OutputBuffer& out, const pcap_pkthdr* pkthdr, const uint8_t* payload) const;
 
   static constexpr const char*
   getDefaultPcapFilter() noexcept
@@ -66,6 +104,12 @@ public:
   }
 
 private:
+  /**
+   * @brief Print the packet, or queue it for a decoder thread
+   */
+  void
+  handlePacket(const pcap_pkthdr* pkthdr, const uint8_t* payload);
+
   void
   printTimestamp(std::ostream& os, const timeval& tv) const;
 
@@ -93,12 +137,63 @@ private:
   bool
   printTcp(OutputFormatter& out, const uint8_t* pkt, size_t len) const;
 
+  /**
+   * @brief pass a TCP segment to the stream reassembler, and print the NDN packets it completes
+   */
+  bool
+  printTcpStream(OutputFormatter& out, const TcpReassembler::Segment& segment) const;
+
   bool
   printUdp(OutputFormatter& out, const uint8_t* pkt, size_t len) const;
 
   bool
   printNdn(OutputFormatter& out, const uint8_t* pkt, size_t len) const;
 
+  bool
+  printPacketView(OutputFormatter& out, const PacketView& packet) const;
+
+  /**
+   * @brief pass an NDNLPv2 fragment to the reassembler, and print the packet once complete
+   */
+  bool
+  printFragment(OutputFormatter& out, const uint8_t* pkt, size_t len,
+                uint64_t fragIndex, uint64_t fragCount) const;
+
+  /**
+   * @brief Fields of a decoded Interest, Data, or Nack that are counted or matched
+   */
+  struct PacketSummary
+  {
+    TrafficStatistics::PacketType type;
+    const uint8_t* name; ///< TLV-VALUE of the Name
+    size_t nameSize;
+    size_t size; ///< size of the network packet
+    bool canBePrefix;
+    time::milliseconds lifetime;
+    lp::NackReason nackReason;
+    const uint8_t* nonce = nullptr; ///< 4 octets, Interests and Nacks only
+  };
+
+  /**
+   * @brief pass the packet to the statistics and the exchange tracker, if enabled
+   * @return RTT of the exchange completed by the packet, if any
+   */
+  optional<time::microseconds>
+  analyzePacket(const OutputFormatter& out, const PacketSummary& packet) const;
+
+  /**
+   * @brief write the packet as a JSON or binary record, instead of a line of text
+   */
+  void
+  printRecord(OutputFormatter& out, const PacketSummary& packet,
+              const optional<time::microseconds>& rtt) const;
+
+  void
+  flushOutput();
+
+  void
+  printStatistics() const;
+
   bool
   matchesFilter(const Name& name) const;
 
@@ -106,16 +201,43 @@ public: // options
   std::string interface;
   std::string inputFile;
   std::string pcapFilter = getDefaultPcapFilter();
-  optional<std::regex> nameFilter;
+  optional<NameFilter> nameFilter;
+  optional<std::regex> nameRegex; ///< matched against the Name URI, much slower than nameFilter
   bool wantPromisc = true;
   bool wantTimestamp = true;
   bool wantVerbose = false;
+  OutputFormat outputFormat = OutputFormat::TEXT;
+  size_t nDecoders = 0; ///< if not zero, decode packets on this many threads
+  size_t queueCapacity = 4096; ///< capacity of the queue of each decoder thread, in packets
+  size_t fileChunkSize = 4 << 20; ///< size of the chunks of a file decoded in parallel, in bytes
+  bool wantPacketMmap = false; ///< capture with a TPACKET_V3 ring instead of libpcap (Linux only)
+  size_t ringSize = 64 << 20; ///< size of the TPACKET_V3 ring, in bytes
+  optional<uint16_t> fanoutGroup; ///< if set, share the interface with other sockets in this group
+  bool wantStatistics = false; ///< count packets per prefix and per face instead of printing them
+  TrafficStatistics::Options statisticsOptions;
+  bool wantRtt = false; ///< match Data and Nacks to Interests, and print the RTT of each exchange
+  ExchangeTracker::Options exchangeOptions;
+  bool wantReassembly = false; ///< reassemble NDNLPv2 fragments and TCP streams before decoding them
+  FragmentReassembler::Options reassemblyOptions;
+  TcpReassembler::Options tcpReassemblyOptions;
 
 private:
   pcap_t* m_pcap = nullptr;
+  unique_ptr<PacketMmapCapture> m_mmapCapture;
+  std::atomic<bool> m_shouldStop{false};
+  OutputBuffer m_output;
+  bool m_isBatching = false;
+  unique_ptr<DecodePipeline> m_pipeline;
+  unique_ptr<CaptureFile> m_captureFile; ///< set when a file is decoded in parallel
+  unique_ptr<FileDecoder> m_fileDecoder;
+  bpf_program m_fileFilter{}; ///< pcap filter applied by the file decoder threads
+  unique_ptr<TrafficStatistics> m_statistics; ///< updated while formatting on the main thread
+  unique_ptr<ExchangeTracker> m_exchanges; ///< updated while formatting on the main thread
 
 PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   int m_dataLinkType = -1;
+  unique_ptr<FragmentReassembler> m_reassembler; ///< updated while formatting on the main thread
+  unique_ptr<TcpReassembler> m_tcpReassembler; ///< updated while formatting on the main thread
 };
 
 } // namespace dump
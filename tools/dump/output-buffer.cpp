@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "output-buffer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace ndn {
+namespace dump {
+
+constexpr size_t OutputBuffer::FLUSH_THRESHOLD;
+
+OutputBuffer::OutputBuffer(size_t initialCapacity)
+  : m_buffer(std::max<size_t>(initialCapacity, 1))
+{
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+void
+OutputBuffer::flushTo(std::ostream& os)
+{
+  os.write(pbase(), static_cast<std::streamsize>(size()));
+  os.flush();
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+void
+OutputBuffer::truncate(size_t newSize)
+{
+  BOOST_ASSERT(newSize <= size());
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+  advance(newSize);
+}
+
+void
+OutputBuffer::advance(size_t n)
+{
+  // pbump() takes an int, advance in steps to support buffers larger than INT_MAX
+  while (n > 0) {
+    int step = static_cast<int>(std::min<size_t>(n, std::numeric_limits<int>::max()));
+    pbump(step);
+    n -= static_cast<size_t>(step);
+  }
+}
+
+OutputBuffer::int_type
+OutputBuffer::overflow(int_type ch)
+{
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+
+  size_t used = size();
+  m_buffer.resize(m_buffer.size() * 2);
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+  advance(used);
+
+  *pptr() = traits_type::to_char_type(ch);
+  pbump(1);
+  return ch;
+}
+
+} // namespace dump
+} // namespace ndn
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_OUTPUT_BUFFER_HPP
+#define NDN_TOOLS_DUMP_OUTPUT_BUFFER_HPP
+
+#include "core/common.hpp"
+
+#include <ostream>
+#include <streambuf>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Growable stream buffer that is written out in large chunks
+ *
+ * Formatted output accumulates in memory, which is reused after each flush, so that printing
+ * a packet does not allocate once the buffer has grown to its working size. getStream()
+ * returns an std::ostream that writes into the buffer.
+ */
+class OutputBuffer : public std::streambuf
+{
+public:
+  /// batched output is written out as soon as this many bytes are buffered
+  static constexpr size_t FLUSH_THRESHOLD = 65536;
+
+  explicit
+  OutputBuffer(size_t initialCapacity = FLUSH_THRESHOLD);
+
+  std::ostream&
+  getStream()
+  {
+    return m_stream;
+  }
+
+  /**
+   * @brief the bytes waiting to be written
+   */
+  const char*
+  data() const
+  {
+    return pbase();
+  }
+
+  /**
+   * @brief number of bytes waiting to be written
+   */
+  size_t
+  size() const
+  {
+    return static_cast<size_t>(pptr() - pbase());
+  }
+
+  /**
+   * @brief write the buffered bytes to @p os and empty the buffer
+   */
+  void
+  flushTo(std::ostream& os);
+
+  /**
+   * @brief discard the bytes written after the first @p newSize
+   */
+  void
+  truncate(size_t newSize);
+
+protected:
+  int_type
+  overflow(int_type ch) override;
+
+private:
+  void
+  advance(size_t n);
+
+private:
+  std::vector<char> m_buffer;
+  std::ostream m_stream{this};
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_OUTPUT_BUFFER_HPP
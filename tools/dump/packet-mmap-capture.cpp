@@ -0,0 +1,258 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packet-mmap-capture.hpp"
+
+#include <algorithm>
+
+#ifdef HAVE_TPACKET_V3
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif // HAVE_TPACKET_V3
+
+namespace ndn {
+namespace dump {
+
+#ifdef HAVE_TPACKET_V3
+
+static std::string
+describeErrno(const std::string& what)
+{
+  return what + ": " + std::strerror(errno);
+}
+
+PacketMmapCapture::PacketMmapCapture(const Options& options)
+  : m_blockSize(options.blockSize)
+  , m_nBlocks(std::max<size_t>(options.ringSize / options.blockSize, 1))
+{
+  unsigned int ifIndex = if_nametoindex(options.interface.data());
+  if (ifIndex == 0) {
+    NDN_THROW(Error(describeErrno("Cannot find interface " + options.interface)));
+  }
+
+  // protocol 0: nothing is received until bind(), which happens after the filter is attached
+  m_fd = socket(AF_PACKET, SOCK_RAW, 0);
+  if (m_fd < 0) {
+    NDN_THROW(Error(describeErrno("Cannot open AF_PACKET socket")));
+  }
+
+  try {
+    // AF_PACKET delivers frames with the interface's own link-layer header
+    ifreq ifr{};
+    std::strncpy(ifr.ifr_name, options.interface.data(), IFNAMSIZ - 1);
+    if (ioctl(m_fd, SIOCGIFHWADDR, &ifr) < 0) {
+      NDN_THROW(Error(describeErrno("Cannot get the hardware type of " + options.interface)));
+    }
+    switch (ifr.ifr_hwaddr.sa_family) {
+    case ARPHRD_ETHER:
+    case ARPHRD_LOOPBACK:
+      // the loopback interface has an Ethernet header filled with zeros
+      m_linkType = DLT_EN10MB;
+      break;
+    default:
+      NDN_THROW(Error("Interface " + options.interface + " has unsupported hardware type " +
+                      to_string(ifr.ifr_hwaddr.sa_family) + ", TPACKET_V3 capture requires "
+                      "an Ethernet interface"));
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+      NDN_THROW(Error(describeErrno("Cannot select TPACKET_V3")));
+    }
+
+    if (!options.filter.empty()) {
+      pcap_t* dead = pcap_open_dead(m_linkType, 65535);
+      bpf_program program;
+      if (pcap_compile(dead, &program, options.filter.data(), 1, PCAP_NETMASK_UNKNOWN) < 0) {
+        std::string err = pcap_geterr(dead);
+        pcap_close(dead);
+        NDN_THROW(Error("Cannot compile pcap filter '" + options.filter + "': " + err));
+      }
+      // bpf_insn and sock_filter have the same layout
+      sock_fprog fprog{};
+      fprog.len = static_cast<unsigned short>(program.bf_len);
+      fprog.filter = reinterpret_cast<sock_filter*>(program.bf_insns);
+      int res = setsockopt(m_fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog));
+      pcap_freecode(&program);
+      pcap_close(dead);
+      if (res < 0) {
+        NDN_THROW(Error(describeErrno("Cannot attach pcap filter")));
+      }
+    }
+
+    tpacket_req3 req{};
+    req.tp_block_size = static_cast<unsigned int>(m_blockSize);
+    req.tp_block_nr = static_cast<unsigned int>(m_nBlocks);
+    req.tp_frame_size = TPACKET_ALIGNMENT << 7;
+    req.tp_frame_nr = static_cast<unsigned int>(m_blockSize / req.tp_frame_size * m_nBlocks);
+    req.tp_retire_blk_tov = static_cast<unsigned int>(options.blockTimeout.count());
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+      NDN_THROW(Error(describeErrno("Cannot create a ring of " + to_string(m_nBlocks) +
+                                    " blocks of " + to_string(m_blockSize) + " bytes")));
+    }
+
+    void* ring = mmap(nullptr, m_blockSize * m_nBlocks, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (ring == MAP_FAILED) {
+      NDN_THROW(Error(describeErrno("Cannot map the ring buffer")));
+    }
+    m_ring = static_cast<uint8_t*>(ring);
+
+    sockaddr_ll addr{};
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = static_cast<int>(ifIndex);
+    if (bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      NDN_THROW(Error(describeErrno("Cannot bind to interface " + options.interface)));
+    }
+
+    if (options.wantPromisc) {
+      packet_mreq mreq{};
+      mreq.mr_ifindex = static_cast<int>(ifIndex);
+      mreq.mr_type = PACKET_MR_PROMISC;
+      if (setsockopt(m_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        NDN_THROW(Error(describeErrno("Cannot enable promiscuous mode")));
+      }
+    }
+
+    if (options.fanoutGroup) {
+      // packets of the same flow always go to the same socket of the group
+      int fanout = *options.fanoutGroup | (PACKET_FANOUT_HASH << 16);
+      if (setsockopt(m_fd, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof(fanout)) < 0) {
+        NDN_THROW(Error(describeErrno("Cannot join fanout group " + to_string(*options.fanoutGroup))));
+      }
+    }
+  }
+  catch (const Error&) {
+    if (m_ring != nullptr) {
+      munmap(m_ring, m_blockSize * m_nBlocks);
+    }
+    close(m_fd);
+    throw;
+  }
+}
+
+PacketMmapCapture::~PacketMmapCapture()
+{
+  munmap(m_ring, m_blockSize * m_nBlocks);
+  close(m_fd);
+}
+
+void
+PacketMmapCapture::run(const PacketCallback& onPacket, const BatchCallback& onBatchEnd)
+{
+  size_t blockNo = 0;
+  while (!m_shouldStop) {
+    auto block = reinterpret_cast<tpacket_block_desc*>(m_ring + blockNo * m_blockSize);
+    if ((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) {
+      pollfd pfd{};
+      pfd.fd = m_fd;
+      pfd.events = POLLIN | POLLERR;
+      if (poll(&pfd, 1, 100) < 0 && errno != EINTR) {
+        NDN_THROW(Error(describeErrno("poll")));
+      }
+      continue;
+    }
+
+    forEachPacket(reinterpret_cast<const uint8_t*>(block), onPacket);
+    onBatchEnd();
+
+    // give the block back to the kernel
+    __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    blockNo = (blockNo + 1) % m_nBlocks;
+  }
+}
+
+size_t
+PacketMmapCapture::forEachPacket(const uint8_t* block, const PacketCallback& onPacket)
+{
+  auto desc = reinterpret_cast<const tpacket_block_desc*>(block);
+  const uint32_t nPackets = desc->hdr.bh1.num_pkts;
+
+  auto pkt = reinterpret_cast<const tpacket3_hdr*>(block + desc->hdr.bh1.offset_to_first_pkt);
+  for (uint32_t i = 0; i < nPackets; ++i) {
+    pcap_pkthdr pkthdr{};
+    pkthdr.ts.tv_sec = pkt->tp_sec;
+    pkthdr.ts.tv_usec = pkt->tp_nsec / 1000;
+    pkthdr.caplen = pkt->tp_snaplen;
+    pkthdr.len = pkt->tp_len;
+    onPacket(&pkthdr, reinterpret_cast<const uint8_t*>(pkt) + pkt->tp_mac);
+
+    pkt = reinterpret_cast<const tpacket3_hdr*>(reinterpret_cast<const uint8_t*>(pkt) +
+                                                pkt->tp_next_offset);
+  }
+  return nPackets;
+}
+
+PacketMmapCapture::Statistics
+PacketMmapCapture::getStatistics() const
+{
+  tpacket_stats_v3 stats{};
+  socklen_t len = sizeof(stats);
+  Statistics result;
+  if (getsockopt(m_fd, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+    // tp_packets includes the dropped packets
+    result.nReceived = stats.tp_packets;
+    result.nDropped = stats.tp_drops;
+    result.nFreezes = stats.tp_freeze_q_cnt;
+  }
+  return result;
+}
+
+#else // HAVE_TPACKET_V3
+
+PacketMmapCapture::PacketMmapCapture(const Options&)
+{
+  NDN_THROW(Error("TPACKET_V3 capture is not supported on this platform"));
+}
+
+PacketMmapCapture::~PacketMmapCapture() = default;
+
+void
+PacketMmapCapture::run(const PacketCallback&, const BatchCallback&)
+{
+}
+
+PacketMmapCapture::Statistics
+PacketMmapCapture::getStatistics() const
+{
+  return {};
+}
+
+size_t
+PacketMmapCapture::forEachPacket(const uint8_t*, const PacketCallback&)
+{
+  return 0;
+}
+
+#endif // HAVE_TPACKET_V3
+
+} // namespace dump
+} // namespace ndn
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_PACKET_MMAP_CAPTURE_HPP
+#define NDN_TOOLS_DUMP_PACKET_MMAP_CAPTURE_HPP
+
+#include "core/common.hpp"
+
+#include <pcap.h>
+
+#include <atomic>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Captures packets from a Linux AF_PACKET socket with a TPACKET_V3 ring buffer
+ *
+ * The kernel fills the memory-mapped ring one block at a time; packets are handed to the
+ * caller block by block, without a system call per packet. Several sockets, possibly in
+ * different processes, can join the same fanout group to share the traffic of an interface.
+ *
+ * Only available on Linux; elsewhere, the constructor throws.
+ */
+class PacketMmapCapture : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  struct Options
+  {
+    std::string interface;
+    std::string filter; ///< pcap-filter(7) expression, empty to capture everything
+    size_t ringSize = 64 << 20; ///< total size of the ring buffer, in bytes
+    size_t blockSize = 1 << 20; ///< size of each ring block, a multiple of the page size
+    time::milliseconds blockTimeout = 100_ms; ///< a partially filled block is handed over after this time
+    optional<uint16_t> fanoutGroup; ///< if set, join this PACKET_FANOUT_HASH group
+    bool wantPromisc = true;
+  };
+
+  struct Statistics
+  {
+    uint64_t nReceived = 0;
+    uint64_t nDropped = 0; ///< dropped by the kernel because the ring was full
+    uint64_t nFreezes = 0; ///< times the ring was full
+  };
+
+  using PacketCallback = std::function<void(const pcap_pkthdr*, const uint8_t*)>;
+  using BatchCallback = std::function<void()>;
+
+  /**
+   * @brief Open the socket, attach the filter, map the ring, and bind to the interface
+   * @throw Error the interface is not an Ethernet or loopback interface, or a system call failed
+   */
+  explicit
+  PacketMmapCapture(const Options& options);
+
+  ~PacketMmapCapture();
+
+  /**
+   * @brief Deliver captured packets until stop() is called
+   *
+   * @p onPacket is called for each packet of a block, then @p onBatchEnd once per block.
+   * Packets start with a link-layer header of getLinkType().
+   */
+  void
+  run(const PacketCallback& onPacket, const BatchCallback& onBatchEnd);
+
+  /**
+   * @brief DLT_ value of the captured packets, determined by the hardware type of the interface
+   */
+  int
+  getLinkType() const
+  {
+    return m_linkType;
+  }
+
+  /**
+   * @brief Make run() return; can be called from a signal handler
+   */
+  void
+  stop()
+  {
+    m_shouldStop = true;
+  }
+
+  /**
+   * @brief counters of the socket since the previous call
+   */
+  Statistics
+  getStatistics() const;
+
+  /**
+   * @brief call @p onPacket for each packet of a ring block, in TPACKET_V3 layout
+   * @return number of packets in the block
+   */
+  static size_t
+  forEachPacket(const uint8_t* block, const PacketCallback& onPacket);
+
+private:
+  int m_fd = -1;
+  uint8_t* m_ring = nullptr;
+  size_t m_blockSize = 0;
+  size_t m_nBlocks = 0;
+  int m_linkType = -1;
+  std::atomic<bool> m_shouldStop{false};
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_PACKET_MMAP_CAPTURE_HPP
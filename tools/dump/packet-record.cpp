@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packet-record.hpp"
+#include "exchange-tracker.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+#include <ndn-cxx/name-component.hpp>
+#include <ndn-cxx/util/string-helper.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+#include <netinet/in.h>
+
+namespace ndn {
+namespace dump {
+
+namespace endian = boost::endian;
+
+static const char*
+getTypeString(TrafficStatistics::PacketType type)
+{
+  switch (type) {
+  case TrafficStatistics::PacketType::INTEREST:
+    return "interest";
+  case TrafficStatistics::PacketType::DATA:
+    return "data";
+  case TrafficStatistics::PacketType::NACK:
+    return "nack";
+  }
+  return "unknown";
+}
+
+static void
+writeJsonName(std::ostream& os, const uint8_t* name, size_t nameSize)
+{
+  os << '[';
+  const uint8_t* pos = name;
+  const uint8_t* end = name + nameSize;
+  while (pos != end) {
+    uint32_t type = 0;
+    uint64_t length = 0;
+    if (!tlv::readType(pos, end, type) || !tlv::readVarNumber(pos, end, length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      // the name has been decoded already, so this is not expected
+      break;
+    }
+
+    // a component in URI format needs no escaping in a JSON string
+    os << '"';
+    if (type == tlv::GenericNameComponent &&
+        !std::all_of(pos, pos + length, [] (uint8_t c) { return c == '.'; })) {
+      escape(os, reinterpret_cast<const char*>(pos), static_cast<size_t>(length));
+    }
+    else {
+      os << name::Component(type, pos, static_cast<size_t>(length));
+    }
+    os << '"';
+    pos += length;
+    if (pos != end) {
+      os << ',';
+    }
+  }
+  os << ']';
+}
+
+void
+writeJsonRecord(std::ostream& os, const PacketRecord& record)
+{
+  char fill = os.fill('0');
+  os << "{\"time\":" << record.timestamp.tv_sec << '.' << std::setw(6) << record.timestamp.tv_usec;
+  os.fill(fill);
+  os << ",\"type\":\"" << getTypeString(record.type) << '"';
+
+  const FlowKey& flow = record.flow;
+  if (flow.family != FlowKey::Family::UNKNOWN) {
+    bool isEthernet = flow.family == FlowKey::Family::ETHERNET;
+    os << ",\"proto\":\"" << (isEthernet ? "ether" : flow.protocol == IPPROTO_TCP ? "tcp" : "udp");
+    os << "\",\"src\":\"";
+    printAddress(os, flow.family, flow.srcAddr);
+    os << '"';
+    if (!isEthernet) {
+      os << ",\"sport\":" << flow.srcPort;
+    }
+    os << ",\"dst\":\"";
+    printAddress(os, flow.family, flow.dstAddr);
+    os << '"';
+    if (!isEthernet) {
+      os << ",\"dport\":" << flow.dstPort;
+    }
+  }
+
+  os << ",\"name\":";
+  writeJsonName(os, record.name, record.nameSize);
+
+  if (record.nonce != nullptr) {
+    os << ",\"nonce\":\"";
+    printHex(os, record.nonce, 4, false);
+    os << '"';
+  }
+  if (record.lifetime) {
+    os << ",\"lifetime\":" << record.lifetime->count();
+  }
+  if (record.type == TrafficStatistics::PacketType::NACK) {
+    os << ",\"reason\":\"" << record.nackReason << '"';
+  }
+  if (record.rtt) {
+    os << ",\"rtt\":" << AsMilliseconds{*record.rtt};
+  }
+  os << ",\"size\":" << record.packetSize << ",\"length\":" << record.frameSize << "}\n";
+}
+
+template<typename T>
+static void
+writeLittleEndian(std::ostream& os, T value)
+{
+  endian::native_to_little_inplace(value);
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void
+writeBinaryRecord(std::ostream& os, const PacketRecord& record)
+{
+  enum : uint8_t {
+    HAS_NONCE = 1,
+    HAS_LIFETIME = 2,
+    HAS_RTT = 4,
+  };
+
+  static const uint8_t ZEROS[4] = {};
+  uint8_t flags = (record.nonce != nullptr ? HAS_NONCE : 0) |
+                  (record.lifetime ? HAS_LIFETIME : 0) |
+                  (record.rtt ? HAS_RTT : 0);
+
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(BINARY_RECORD_FIXED_SIZE - 4 + record.nameSize));
+  // PacketType starts at INTEREST = 0
+  writeLittleEndian<uint8_t>(os, static_cast<uint8_t>(static_cast<int>(record.type) + 1));
+  writeLittleEndian<uint8_t>(os, static_cast<uint8_t>(record.flow.family));
+  writeLittleEndian<uint8_t>(os, record.flow.protocol);
+  writeLittleEndian<uint8_t>(os, flags);
+  writeLittleEndian<int64_t>(os, record.timestamp.tv_sec);
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(record.timestamp.tv_usec));
+  writeLittleEndian<uint16_t>(os, record.flow.srcPort);
+  writeLittleEndian<uint16_t>(os, record.flow.dstPort);
+  os.write(reinterpret_cast<const char*>(record.flow.srcAddr.data()), record.flow.srcAddr.size());
+  os.write(reinterpret_cast<const char*>(record.flow.dstAddr.data()), record.flow.dstAddr.size());
+  os.write(reinterpret_cast<const char*>(record.nonce != nullptr ? record.nonce : ZEROS), 4);
+  writeLittleEndian<uint32_t>(os, record.lifetime ? static_cast<uint32_t>(record.lifetime->count()) : 0);
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(record.nackReason));
+  writeLittleEndian<uint32_t>(os, record.rtt ? static_cast<uint32_t>(record.rtt->count()) : 0);
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(record.packetSize));
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(record.frameSize));
+  writeLittleEndian<uint32_t>(os, static_cast<uint32_t>(record.nameSize));
+  os.write(reinterpret_cast<const char*>(record.name), static_cast<std::streamsize>(record.nameSize));
+}
+
+} // namespace dump
+} // namespace ndn
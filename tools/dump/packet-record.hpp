@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_PACKET_RECORD_HPP
+#define NDN_TOOLS_DUMP_PACKET_RECORD_HPP
+
+#include "flow-key.hpp"
+#include "traffic-statistics.hpp"
+
+#include <sys/time.h>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief How ndndump prints each packet
+ */
+enum class OutputFormat {
+  TEXT, ///< one human-readable line per packet
+  JSON, ///< one JSON object per line, see writeJsonRecord()
+  BINARY, ///< length-prefixed records after a file header, see writeBinaryRecord()
+};
+
+/**
+ * @brief Fields of one Interest, Data, or Nack in the structured output formats
+ */
+struct PacketRecord
+{
+  timeval timestamp{};
+  FlowKey flow;
+  TrafficStatistics::PacketType type = TrafficStatistics::PacketType::INTEREST;
+  const uint8_t* name = nullptr; ///< TLV-VALUE of the Name
+  size_t nameSize = 0;
+  const uint8_t* nonce = nullptr; ///< 4 octets, or nullptr if absent or not an Interest
+  optional<time::milliseconds> lifetime; ///< InterestLifetime, Interests and Nacks only
+  lp::NackReason nackReason = lp::NackReason::NONE;
+  size_t packetSize = 0; ///< size of the network packet
+  size_t frameSize = 0; ///< size of the captured frame, on the wire
+  optional<time::microseconds> rtt; ///< set on Data and Nacks matched by '--rtt'
+};
+
+/**
+ * @brief Write @p record as a JSON object on one line
+ *
+ * For example:
+ * @code
+ * {"time":1571091605.129263,"type":"interest","proto":"tcp","src":"127.0.0.1","sport":59212,
+ *  "dst":"127.0.0.1","dport":6363,"name":["producer","nack","no-route"],"nonce":"827bcac4",
+ *  "lifetime":4000,"size":36,"length":102}
+ * @endcode
+ * Name components are in URI format. Addresses and ports are omitted when unknown, and
+ * "reason" and "rtt" (in milliseconds) are present only on Nacks and matched exchanges.
+ */
+void
+writeJsonRecord(std::ostream& os, const PacketRecord& record);
+
+/// written once at the beginning of the binary output: "NDNDUMP" and a format version
+constexpr char BINARY_HEADER[8] = {'N', 'D', 'N', 'D', 'U', 'M', 'P', 1};
+
+/// size of the fixed part of a binary record, including the length prefix
+constexpr size_t BINARY_RECORD_FIXED_SIZE = 84;
+
+/**
+ * @brief Write @p record in the binary format
+ *
+ * Integers are little-endian; addresses and the nonce are in network order, as on the wire.
+ * | offset | size | field |
+ * |--------|------|-------|
+ * | 0      | 4    | number of octets that follow in this record |
+ * | 4      | 1    | type: 1 Interest, 2 Data, 3 Nack |
+ * | 5      | 1    | address family: 0 unknown, 1 Ethernet, 2 IPv4, 3 IPv6 |
+ * | 6      | 1    | IP protocol, zero for Ethernet |
+ * | 7      | 1    | flags: 1 nonce present, 2 lifetime present, 4 RTT present |
+ * | 8      | 8    | timestamp, seconds |
+ * | 16     | 4    | timestamp, microseconds |
+ * | 20     | 2    | source port |
+ * | 22     | 2    | destination port |
+ * | 24     | 16   | source address, a MAC address uses the first 6 octets |
+ * | 40     | 16   | destination address |
+ * | 56     | 4    | nonce |
+ * | 60     | 4    | InterestLifetime, milliseconds |
+ * | 64     | 4    | Nack reason |
+ * | 68     | 4    | RTT, microseconds |
+ * | 72     | 4    | size of the network packet |
+ * | 76     | 4    | size of the captured frame, on the wire |
+ * | 80     | 4    | size of the Name TLV-VALUE |
+ * | 84     |      | Name TLV-VALUE, i.e. the encoded name components |
+ *
+ * Readers must use the length prefix to find the next record, so that fields can be
+ * appended in later versions of the format.
+ */
+void
+writeBinaryRecord(std::ostream& os, const PacketRecord& record);
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_PACKET_RECORD_HPP
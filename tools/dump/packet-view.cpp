@@ -0,0 +1,576 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packet-view.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+#include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/lp/tlv.hpp>
+#include <ndn-cxx/name-component.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief read TLV-TYPE and TLV-LENGTH at @p pos
+ *
+ * On success, @p pos points to the TLV-VALUE, which is known to end before @p end.
+ */
+static bool
+readTlv(const uint8_t*& pos, const uint8_t* end, uint32_t& type, size_t& length)
+{
+  uint64_t len = 0;
+  if (!tlv::readType(pos, end, type) || !tlv::readVarNumber(pos, end, len) ||
+      len > static_cast<uint64_t>(end - pos)) {
+    return false;
+  }
+  length = static_cast<size_t>(len);
+  return true;
+}
+
+static bool
+readNonNegativeInteger(const uint8_t* value, size_t size, uint64_t& number)
+{
+  switch (size) {
+  case 1:
+  case 2:
+  case 4:
+  case 8:
+    break;
+  default:
+    return false;
+  }
+
+  number = 0;
+  for (size_t i = 0; i < size; ++i) {
+    number = (number << 8) | value[i];
+  }
+  return true;
+}
+
+/**
+ * @return whether [begin, end) is a sequence of well-formed TLV elements
+ */
+static bool
+isWellFormed(const uint8_t* begin, const uint8_t* end)
+{
+  while (begin != end) {
+    uint32_t type = 0;
+    size_t length = 0;
+    if (!readTlv(begin, end, type, length)) {
+      return false;
+    }
+    begin += length;
+  }
+  return true;
+}
+
+/**
+ * @return whether [begin, end) is the TLV-VALUE of a non-empty Name that NameView can print
+ */
+static bool
+isSupportedName(const uint8_t* begin, const uint8_t* end)
+{
+  if (begin == end) {
+    return false;
+  }
+
+  while (begin != end) {
+    uint32_t type = 0;
+    size_t length = 0;
+    if (!readTlv(begin, end, type, length)) {
+      return false;
+    }
+
+    uint64_t number = 0;
+    switch (type) {
+    case tlv::GenericNameComponent:
+      break;
+    case tlv::SegmentNameComponent:
+    case tlv::VersionNameComponent:
+      if (!readNonNegativeInteger(begin, length, number)) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+    begin += length;
+  }
+  return true;
+}
+
+/**
+ * @return whether ndn-cxx prints typed name components in the alternate URI format (e.g. seg=1)
+ */
+static bool
+wantAltUri()
+{
+  static const bool value = name::Component::fromSegment(0).toUri() == "seg=0";
+  return value;
+}
+
+static void
+printEscaped(std::ostream& os, const uint8_t* value, size_t size)
+{
+  static const char HEX[] = "0123456789ABCDEF";
+
+  if (std::all_of(value, value + size, [] (uint8_t c) { return c == '.'; })) {
+    os << "...";
+  }
+
+  for (size_t i = 0; i < size; ++i) {
+    char c = static_cast<char>(value[i]);
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+        c == '-' || c == '.' || c == '_' || c == '~') {
+      os.put(c);
+    }
+    else {
+      const char escaped[] = {'%', HEX[value[i] >> 4], HEX[value[i] & 0xf]};
+      os.write(escaped, sizeof(escaped));
+    }
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const NameView& name)
+{
+  const uint8_t* pos = name.value;
+  const uint8_t* end = name.value + name.size;
+  while (pos != end) {
+    uint32_t type = 0;
+    size_t length = 0;
+    readTlv(pos, end, type, length);
+
+    os.put('/');
+    uint64_t number = 0;
+    if (type == tlv::GenericNameComponent) {
+      printEscaped(os, pos, length);
+    }
+    else if (!wantAltUri()) {
+      os << type << '=';
+      printEscaped(os, pos, length);
+    }
+    else if (type == tlv::SegmentNameComponent) {
+      readNonNegativeInteger(pos, length, number);
+      os << "seg=" << number;
+    }
+    else {
+      BOOST_ASSERT(type == tlv::VersionNameComponent);
+      readNonNegativeInteger(pos, length, number);
+      os << "v=" << number;
+    }
+    pos += length;
+  }
+  return os;
+}
+
+bool
+PacketView::decode(const uint8_t* buf, size_t size)
+{
+  *this = PacketView();
+
+  const uint8_t* pos = buf;
+  const uint8_t* end = buf + size;
+  uint32_t type = 0;
+  size_t length = 0;
+  if (!readTlv(pos, end, type, length)) {
+    return false;
+  }
+
+  if (type == lp::tlv::LpPacket) {
+    isLp = true;
+    return decodeLp(pos, pos + length);
+  }
+  return decodeNetworkPacket(buf, pos + length);
+}
+
+bool
+PacketView::decodeLp(const uint8_t* pos, const uint8_t* end)
+{
+  bool hasCongestionMark = false;
+  bool hasTxSequence = false;
+
+  while (pos != end) {
+    if (fragment != nullptr) {
+      // Fragment must be the last field
+      return false;
+    }
+
+    uint32_t type = 0;
+    size_t length = 0;
+    if (!readTlv(pos, end, type, length)) {
+      return false;
+    }
+    const uint8_t* value = pos;
+    pos += length;
+
+    uint64_t number = 0;
+    switch (type) {
+    case lp::tlv::Fragment:
+      fragment = value;
+      fragmentSize = length;
+      break;
+    case lp::tlv::Sequence:
+      if (lpSequence || !readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      lpSequence = number;
+      break;
+    case lp::tlv::FragIndex:
+      if (fragIndex || !readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      fragIndex = number;
+      break;
+    case lp::tlv::FragCount:
+      if (fragCount || !readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      fragCount = number;
+      break;
+    case lp::tlv::Nack: {
+      if (nackReason || !isWellFormed(value, value + length)) {
+        return false;
+      }
+      nackReason = lp::NackReason::NONE;
+      if (length > 0) {
+        uint32_t reasonType = 0;
+        size_t reasonLength = 0;
+        readTlv(value, value + length, reasonType, reasonLength);
+        if (reasonType != lp::tlv::NackReason || !readNonNegativeInteger(value, reasonLength, number)) {
+          return false;
+        }
+        switch (static_cast<lp::NackReason>(number)) {
+        case lp::NackReason::CONGESTION:
+        case lp::NackReason::DUPLICATE:
+        case lp::NackReason::NO_ROUTE:
+          nackReason = static_cast<lp::NackReason>(number);
+          break;
+        default:
+          break;
+        }
+      }
+      break;
+    }
+    case lp::tlv::CongestionMark:
+      if (hasCongestionMark || !readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      hasCongestionMark = true;
+      break;
+    case lp::tlv::Ack:
+      if (!readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      break;
+    case lp::tlv::TxSequence:
+      if (hasTxSequence || !readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      hasTxSequence = true;
+      break;
+    default:
+      // other fields are rarely seen on the wire, leave them to the ndn-cxx decoder
+      return false;
+    }
+  }
+
+  if (fragment == nullptr) {
+    isIdle = true;
+    return true;
+  }
+
+  // as with the ndn-cxx decoder, only a fragment that starts with a complete network packet
+  // is decoded, even if FragCount is greater than one
+  const uint8_t* fragPos = fragment;
+  uint32_t type = 0;
+  size_t length = 0;
+  if (!readTlv(fragPos, fragment + fragmentSize, type, length)) {
+    isFragment = true;
+    return true;
+  }
+  return decodeNetworkPacket(fragment, fragPos + length);
+}
+
+bool
+PacketView::decodeNetworkPacket(const uint8_t* begin, const uint8_t* end)
+{
+  const uint8_t* pos = begin;
+  size_t length = 0;
+  if (!readTlv(pos, end, type, length)) {
+    return false;
+  }
+  wire = begin;
+  wireSize = static_cast<size_t>(pos - begin) + length;
+
+  switch (type) {
+  case tlv::Interest:
+    return decodeInterest(pos, pos + length);
+  case tlv::Data:
+    return decodeData(pos, pos + length);
+  default:
+    return false;
+  }
+}
+
+bool
+PacketView::decodeInterest(const uint8_t* pos, const uint8_t* end)
+{
+  uint32_t type = 0;
+  size_t length = 0;
+  if (!readTlv(pos, end, type, length) || type != tlv::Name || !isSupportedName(pos, pos + length)) {
+    return false;
+  }
+  name = {pos, length};
+  pos += length;
+
+  // elements must appear in this order, at most once each
+  int lastRank = 0;
+  while (pos != end) {
+    if (!readTlv(pos, end, type, length)) {
+      return false;
+    }
+    const uint8_t* value = pos;
+    pos += length;
+
+    int rank = 0;
+    uint64_t number = 0;
+    switch (type) {
+    case tlv::CanBePrefix:
+      rank = 1;
+      if (length != 0) {
+        return false;
+      }
+      canBePrefix = true;
+      break;
+    case tlv::MustBeFresh:
+      rank = 2;
+      if (length != 0) {
+        return false;
+      }
+      mustBeFresh = true;
+      break;
+    case tlv::Nonce:
+      rank = 3;
+      if (length != 4) {
+        return false;
+      }
+      nonce = value;
+      break;
+    case tlv::InterestLifetime:
+      rank = 4;
+      if (!readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      lifetime = number;
+      break;
+    default:
+      // ForwardingHint, HopLimit, ApplicationParameters, signed Interests, unknown elements
+      return false;
+    }
+
+    if (rank <= lastRank) {
+      return false;
+    }
+    lastRank = rank;
+  }
+  return true;
+}
+
+static bool
+isSupportedMetaInfo(const uint8_t* pos, const uint8_t* end)
+{
+  int lastRank = 0;
+  while (pos != end) {
+    uint32_t type = 0;
+    size_t length = 0;
+    if (!readTlv(pos, end, type, length)) {
+      return false;
+    }
+    const uint8_t* value = pos;
+    pos += length;
+
+    int rank = 0;
+    uint64_t number = 0;
+    switch (type) {
+    case tlv::ContentType:
+      rank = 1;
+      if (!readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      break;
+    case tlv::FreshnessPeriod:
+      rank = 2;
+      if (!readNonNegativeInteger(value, length, number)) {
+        return false;
+      }
+      break;
+    case tlv::FinalBlockId: {
+      rank = 3;
+      uint32_t componentType = 0;
+      size_t componentLength = 0;
+      if (!readTlv(value, pos, componentType, componentLength) || componentType > 0xFFFF ||
+          value + componentLength != pos) {
+        return false;
+      }
+      break;
+    }
+    default:
+      return false;
+    }
+
+    if (rank <= lastRank) {
+      return false;
+    }
+    lastRank = rank;
+  }
+  return true;
+}
+
+static bool
+isSupportedSignatureInfo(const uint8_t* pos, const uint8_t* end)
+{
+  uint32_t type = 0;
+  size_t length = 0;
+  uint64_t number = 0;
+  if (!readTlv(pos, end, type, length) || type != tlv::SignatureType ||
+      !readNonNegativeInteger(pos, length, number)) {
+    return false;
+  }
+  pos += length;
+
+  if (pos == end) {
+    return true;
+  }
+
+  // KeyLocator, containing either a Name or a KeyDigest
+  if (!readTlv(pos, end, type, length) || type != tlv::KeyLocator || pos + length != end) {
+    return false;
+  }
+  const uint8_t* keyEnd = pos + length;
+  if (!readTlv(pos, keyEnd, type, length) || pos + length != keyEnd) {
+    return false;
+  }
+  if (type == tlv::KeyDigest) {
+    return true;
+  }
+  if (type != tlv::Name) {
+    return false;
+  }
+  while (pos != keyEnd) {
+    if (!readTlv(pos, keyEnd, type, length) || type > 0xFFFF) {
+      return false;
+    }
+    pos += length;
+  }
+  return true;
+}
+
+bool
+PacketView::decodeData(const uint8_t* pos, const uint8_t* end)
+{
+  uint32_t type = 0;
+  size_t length = 0;
+  if (!readTlv(pos, end, type, length) || type != tlv::Name || !isSupportedName(pos, pos + length)) {
+    return false;
+  }
+  name = {pos, length};
+  pos += length;
+
+  // MetaInfo and Content are optional, SignatureInfo and SignatureValue are required
+  int lastRank = 0;
+  bool hasSignatureInfo = false;
+  while (pos != end) {
+    if (!readTlv(pos, end, type, length)) {
+      return false;
+    }
+    const uint8_t* value = pos;
+    pos += length;
+
+    int rank = 0;
+    switch (type) {
+    case tlv::MetaInfo:
+      rank = 1;
+      if (!isSupportedMetaInfo(value, pos)) {
+        return false;
+      }
+      break;
+    case tlv::Content:
+      rank = 2;
+      break;
+    case tlv::SignatureInfo:
+      rank = 3;
+      if (!isSupportedSignatureInfo(value, pos)) {
+        return false;
+      }
+      break;
+    case tlv::SignatureValue:
+      rank = 4;
+      break;
+    default:
+      return false;
+    }
+
+    if (rank <= lastRank) {
+      return false;
+    }
+    hasSignatureInfo = hasSignatureInfo || rank == 3;
+    lastRank = rank;
+  }
+  return hasSignatureInfo && lastRank == 4;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const AsInterest& interest)
+{
+  static const char HEX[] = "0123456789abcdef";
+  const PacketView& packet = interest.packet;
+
+  os << packet.name;
+
+  char delim = '?';
+  if (packet.canBePrefix) {
+    os << delim << "CanBePrefix";
+    delim = '&';
+  }
+  if (packet.mustBeFresh) {
+    os << delim << "MustBeFresh";
+    delim = '&';
+  }
+  if (packet.nonce != nullptr) {
+    char hex[8];
+    for (size_t i = 0; i < 4; ++i) {
+      hex[2 * i] = HEX[packet.nonce[i] >> 4];
+      hex[2 * i + 1] = HEX[packet.nonce[i] & 0xf];
+    }
+    os << delim << "Nonce=";
+    os.write(hex, sizeof(hex));
+    delim = '&';
+  }
+  if (packet.lifetime && *packet.lifetime != static_cast<uint64_t>(DEFAULT_INTEREST_LIFETIME.count())) {
+    os << delim << "Lifetime=" << *packet.lifetime;
+  }
+  return os;
+}
+
+} // namespace dump
+} // namespace ndn
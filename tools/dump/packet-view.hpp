@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_PACKET_VIEW_HPP
+#define NDN_TOOLS_DUMP_PACKET_VIEW_HPP
+
+#include "core/common.hpp"
+
+#include <ndn-cxx/lp/nack-header.hpp>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Non-owning view of the TLV-VALUE of a Name element
+ *
+ * Printing a NameView produces the same URI as ndn::Name, as long as the view was filled in
+ * by PacketView::decode(), which only accepts the name component types handled here.
+ */
+struct NameView
+{
+  const uint8_t* value = nullptr;
+  size_t size = 0;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const NameView& name);
+
+/**
+ * @brief Non-owning view of the fields of an NDN packet that ndndump prints
+ *
+ * decode() parses the packet in place, without copying or allocating, and reads only the
+ * fields ndndump needs. It rejects every packet that it does not fully understand, including
+ * malformed ones, so that the caller can fall back to the ndn-cxx decoder, which produces the
+ * detailed error messages.
+ */
+class PacketView
+{
+public:
+  /**
+   * @brief decode the NDN packet at the beginning of @p buf
+   * @return whether the packet is supported; if false, the view is in an unspecified state
+   */
+  bool
+  decode(const uint8_t* buf, size_t size);
+
+public: // NDNLPv2 header
+  bool isLp = false;
+  bool isIdle = false; ///< LpPacket without fragment
+  bool isFragment = false; ///< fragment does not contain a complete network packet
+  optional<uint64_t> lpSequence;
+  optional<uint64_t> fragIndex;
+  optional<uint64_t> fragCount;
+  optional<lp::NackReason> nackReason;
+  const uint8_t* fragment = nullptr; ///< TLV-VALUE of the Fragment field
+  size_t fragmentSize = 0;
+
+public: // network packet, valid if isIdle and isFragment are false
+  uint32_t type = 0; ///< tlv::Interest or tlv::Data
+  const uint8_t* wire = nullptr; ///< the whole network packet
+  size_t wireSize = 0;
+  NameView name;
+
+public: // Interest only
+  bool canBePrefix = false;
+  bool mustBeFresh = false;
+  const uint8_t* nonce = nullptr; ///< 4 octets, or nullptr if absent
+  optional<uint64_t> lifetime; ///< InterestLifetime in milliseconds
+
+private:
+  bool
+  decodeLp(const uint8_t* begin, const uint8_t* end);
+
+  bool
+  decodeNetworkPacket(const uint8_t* begin, const uint8_t* end);
+
+  bool
+  decodeInterest(const uint8_t* begin, const uint8_t* end);
+
+  bool
+  decodeData(const uint8_t* begin, const uint8_t* end);
+};
+
+/**
+ * @brief Helper to print the Interest in a PacketView in the same format as ndn::Interest
+ */
+struct AsInterest
+{
+  const PacketView& packet;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const AsInterest& interest);
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_PACKET_VIEW_HPP
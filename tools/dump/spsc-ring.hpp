@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_SPSC_RING_HPP
+#define NDN_TOOLS_DUMP_SPSC_RING_HPP
+
+#include "core/common.hpp"
+
+#include <atomic>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Bounded lock-free queue with a single producer thread and a single consumer thread
+ *
+ * Slots are preallocated and reused: the producer fills the slot returned by prepareWrite()
+ * in place, and the consumer reads the slot returned by front() in place, so that a slot can
+ * keep its own buffers across uses.
+ */
+template<typename T>
+class SpscRing : noncopyable
+{
+public:
+  /**
+   * @param capacity minimum number of slots, rounded up to a power of two
+   */
+  explicit
+  SpscRing(size_t capacity)
+    : m_slots(roundUpToPowerOfTwo(capacity))
+    , m_mask(m_slots.size() - 1)
+  {
+  }
+
+  size_t
+  capacity() const
+  {
+    return m_slots.size();
+  }
+
+  /**
+   * @brief producer: return the next free slot, or nullptr if the ring is full
+   */
+  T*
+  prepareWrite()
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tailCache >= m_slots.size()) {
+      m_tailCache = m_tail.load(std::memory_order_acquire);
+      if (head - m_tailCache >= m_slots.size()) {
+        return nullptr;
+      }
+    }
+    return &m_slots[head & m_mask];
+  }
+
+  /**
+   * @brief producer: publish the slot returned by prepareWrite()
+   */
+  void
+  commitWrite()
+  {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief consumer: return the oldest published slot, or nullptr if the ring is empty
+   */
+  T*
+  front()
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_headCache) {
+      m_headCache = m_head.load(std::memory_order_acquire);
+      if (tail == m_headCache) {
+        return nullptr;
+      }
+    }
+    return &m_slots[tail & m_mask];
+  }
+
+  /**
+   * @brief consumer: release the slot returned by front()
+   */
+  void
+  pop()
+  {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+private:
+  static size_t
+  roundUpToPowerOfTwo(size_t n)
+  {
+    size_t size = 1;
+    while (size < n) {
+      size <<= 1;
+    }
+    return size;
+  }
+
+private:
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  std::vector<T> m_slots;
+  const size_t m_mask;
+
+  // the producer and the consumer indexes are kept on separate cache lines
+  char m_pad0[CACHE_LINE_SIZE];
+  std::atomic<size_t> m_head{0}; ///< next slot to write, owned by the producer
+  size_t m_tailCache = 0; ///< producer's copy of m_tail
+  char m_pad1[CACHE_LINE_SIZE];
+  std::atomic<size_t> m_tail{0}; ///< next slot to read, owned by the consumer
+  size_t m_headCache = 0; ///< consumer's copy of m_head
+  char m_pad2[CACHE_LINE_SIZE];
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_SPSC_RING_HPP
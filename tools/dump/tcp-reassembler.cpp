@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tcp-reassembler.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+#include <ndn-cxx/lp/tlv.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace dump {
+
+static int64_t
+toMicroseconds(const timeval& ts)
+{
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_usec;
+}
+
+/**
+ * @return distance from @p from to @p to in sequence number space, negative if @p to is before
+ */
+static int32_t
+sequenceOffset(uint32_t from, uint32_t to)
+{
+  return static_cast<int32_t>(to - from);
+}
+
+enum class HeaderStatus {
+  INCOMPLETE,
+  VALID,
+  INVALID,
+};
+
+/**
+ * @brief parse the header of the NDN packet at @p pos
+ * @param[out] packetSize size of the whole packet, if the header is valid
+ */
+static HeaderStatus
+readPacketHeader(const uint8_t* pos, const uint8_t* end, size_t& packetSize)
+{
+  const uint8_t* begin = pos;
+  if (pos == end) {
+    return HeaderStatus::INCOMPLETE;
+  }
+
+  // Interest, Data, and LpPacket all have a one-octet TLV-TYPE
+  switch (*pos) {
+  case tlv::Interest:
+  case tlv::Data:
+  case lp::tlv::LpPacket:
+    ++pos;
+    break;
+  default:
+    return HeaderStatus::INVALID;
+  }
+
+  if (pos == end) {
+    return HeaderStatus::INCOMPLETE;
+  }
+  size_t lengthSize = *pos < 253 ? 1 : *pos == 253 ? 3 : *pos == 254 ? 5 : 9;
+  if (static_cast<size_t>(end - pos) < lengthSize) {
+    return HeaderStatus::INCOMPLETE;
+  }
+
+  uint64_t length = 0;
+  if (!tlv::readVarNumber(pos, end, length) ||
+      length > MAX_NDN_PACKET_SIZE - static_cast<size_t>(pos - begin)) {
+    return HeaderStatus::INVALID;
+  }
+  packetSize = static_cast<size_t>(pos - begin) + static_cast<size_t>(length);
+  return HeaderStatus::VALID;
+}
+
+TcpReassembler::TcpReassembler(const Options& options)
+  : m_options(options)
+{
+}
+
+size_t
+TcpReassembler::add(const timeval& ts, const FlowKey& flow, const Segment& segment,
+                    const PacketCallback& onPacket)
+{
+  int64_t now = toMicroseconds(ts);
+  expire(now);
+
+  auto it = m_streams.find(flow);
+  if (segment.isSyn) {
+    // a new connection, or a retransmitted SYN: frame the stream from the start
+    it = findOrInsert(flow, now);
+    Stream& stream = it->second;
+    m_nSkippedBytes += stream.partial.size() + stream.nEarlyBytes;
+    stream.partial.clear();
+    stream.early.clear();
+    stream.nEarlyBytes = 0;
+    stream.nextSequence = segment.sequence + 1;
+    stream.isFramed = true;
+  }
+  else if (it == m_streams.end()) {
+    if (segment.size == 0 || segment.isFin) {
+      // nothing to reassemble
+      return 0;
+    }
+    // the capture started after the SYN, try to frame the stream from this segment
+    it = findOrInsert(flow, now);
+    it->second.nextSequence = segment.sequence;
+  }
+  else {
+    it = findOrInsert(flow, now);
+  }
+
+  Stream& stream = it->second;
+  uint32_t sequence = segment.sequence + (segment.isSyn ? 1 : 0);
+  int32_t offset = sequenceOffset(stream.nextSequence, sequence);
+  size_t nPackets = 0;
+
+  if (segment.size == 0) {
+    // only an acknowledgment
+  }
+  else if (offset > 0) {
+    // a gap precedes this segment; keep it until the gap is filled
+    stream.early.emplace_back(sequence, std::string(reinterpret_cast<const char*>(segment.payload),
+                                                    segment.size));
+    stream.nEarlyBytes += segment.size;
+    if (stream.nEarlyBytes > m_options.maxEarlyBytes) {
+      // the missing bytes were not captured, or will not arrive in time
+      resync(stream);
+      nPackets += deliverEarly(stream, onPacket);
+    }
+  }
+  else if (static_cast<size_t>(-static_cast<int64_t>(offset)) < segment.size) {
+    // skip the bytes that were delivered already, if this is a partial retransmission
+    size_t overlap = static_cast<size_t>(-static_cast<int64_t>(offset));
+    nPackets += deliver(stream, segment.payload + overlap, segment.size - overlap, overlap == 0, onPacket);
+    nPackets += deliverEarly(stream, onPacket);
+  }
+
+  if (segment.isFin) {
+    erase(it);
+  }
+  return nPackets;
+}
+
+size_t
+TcpReassembler::deliver(Stream& stream, const uint8_t* data, size_t size, bool isSegmentStart,
+                        const PacketCallback& onPacket)
+{
+  stream.nextSequence += static_cast<uint32_t>(size);
+
+  size_t packetSize = 0;
+  if (!stream.isFramed) {
+    if (!isSegmentStart || readPacketHeader(data, data + size, packetSize) == HeaderStatus::INVALID) {
+      m_nSkippedBytes += size;
+      return 0;
+    }
+    stream.isFramed = true;
+  }
+
+  // when no packet is pending, the packets are passed directly from the segment
+  const uint8_t* pos = data;
+  const uint8_t* end = data + size;
+  if (!stream.partial.empty()) {
+    stream.partial.append(reinterpret_cast<const char*>(data), size);
+    pos = reinterpret_cast<const uint8_t*>(stream.partial.data());
+    end = pos + stream.partial.size();
+  }
+
+  size_t nPackets = 0;
+  while (pos != end) {
+    auto status = readPacketHeader(pos, end, packetSize);
+    if (status == HeaderStatus::INVALID) {
+      // not an NDN packet: the stream is out of sync
+      ++m_nResyncs;
+      m_nSkippedBytes += static_cast<size_t>(end - pos);
+      stream.isFramed = false;
+      pos = end;
+      break;
+    }
+    if (status == HeaderStatus::INCOMPLETE || static_cast<size_t>(end - pos) < packetSize) {
+      break;
+    }
+
+    onPacket(pos, packetSize);
+    ++nPackets;
+    ++m_nPackets;
+    pos += packetSize;
+  }
+
+  if (stream.partial.empty()) {
+    stream.partial.assign(reinterpret_cast<const char*>(pos), static_cast<size_t>(end - pos));
+  }
+  else {
+    stream.partial.erase(0, static_cast<size_t>(pos - reinterpret_cast<const uint8_t*>(stream.partial.data())));
+  }
+  return nPackets;
+}
+
+size_t
+TcpReassembler::deliverEarly(Stream& stream, const PacketCallback& onPacket)
+{
+  size_t nPackets = 0;
+  bool hasDelivered = true;
+  while (hasDelivered) {
+    hasDelivered = false;
+    for (auto it = stream.early.begin(); it != stream.early.end(); ++it) {
+      int32_t offset = sequenceOffset(stream.nextSequence, it->first);
+      if (offset > 0) {
+        continue;
+      }
+
+      std::string data = std::move(it->second);
+      stream.early.erase(it);
+      stream.nEarlyBytes -= data.size();
+
+      size_t overlap = static_cast<size_t>(-static_cast<int64_t>(offset));
+      if (overlap < data.size()) {
+        nPackets += deliver(stream, reinterpret_cast<const uint8_t*>(data.data()) + overlap,
+                            data.size() - overlap, overlap == 0, onPacket);
+      }
+      hasDelivered = true;
+      break;
+    }
+  }
+  return nPackets;
+}
+
+void
+TcpReassembler::resync(Stream& stream)
+{
+  ++m_nResyncs;
+  m_nSkippedBytes += stream.partial.size();
+  stream.partial.clear();
+  stream.isFramed = false;
+
+  // give up on the gap, and continue from the earliest segment after it
+  auto earliest = std::min_element(stream.early.begin(), stream.early.end(),
+    [&stream] (const auto& a, const auto& b) {
+      return sequenceOffset(stream.nextSequence, a.first) < sequenceOffset(stream.nextSequence, b.first);
+    });
+  if (earliest != stream.early.end()) {
+    stream.nextSequence = earliest->first;
+  }
+}
+
+TcpReassembler::StreamTable::iterator
+TcpReassembler::findOrInsert(const FlowKey& flow, int64_t now)
+{
+  auto it = m_streams.find(flow);
+  if (it == m_streams.end()) {
+    if (m_streams.size() >= m_options.capacity) {
+      erase(m_streams.find(m_lru.back()));
+      ++m_nEvicted;
+    }
+    it = m_streams.emplace(flow, Stream{}).first;
+    m_lru.push_front(flow);
+    it->second.lru = m_lru.begin();
+  }
+  else {
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+  }
+  it->second.lastSeen = now;
+  return it;
+}
+
+void
+TcpReassembler::expire(int64_t now)
+{
+  int64_t timeout = time::duration_cast<time::microseconds>(m_options.idleTimeout).count();
+  while (!m_lru.empty()) {
+    auto it = m_streams.find(m_lru.back());
+    if (it->second.lastSeen + timeout > now) {
+      break;
+    }
+    erase(it);
+  }
+}
+
+void
+TcpReassembler::erase(StreamTable::iterator stream)
+{
+  m_nSkippedBytes += stream->second.partial.size() + stream->second.nEarlyBytes;
+  m_lru.erase(stream->second.lru);
+  m_streams.erase(stream);
+}
+
+} // namespace dump
+} // namespace ndn
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_TCP_REASSEMBLER_HPP
+#define NDN_TOOLS_DUMP_TCP_REASSEMBLER_HPP
+
+#include "flow-key.hpp"
+
+#include <list>
+#include <unordered_map>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Splits the captured TCP streams of NDN faces into NDN packets
+ *
+ * Each direction of a connection is a separate stream. Segments are put in order by their
+ * sequence number, and the stream is cut into TLV elements, which may span several segments
+ * or share one. Segments that arrive early are kept until the gap before them is filled.
+ *
+ * A stream is framed from its SYN, or, if the capture started after the SYN, from the first
+ * segment that starts with the header of an NDN packet. If a gap is never filled, or the
+ * stream does not contain an NDN packet where one is expected, the partial packet is
+ * dropped and the stream is framed again at a segment boundary.
+ *
+ * Memory is bounded: each stream buffers at most one partial packet and Options::maxEarlyBytes
+ * of early segments, at most Options::capacity streams are tracked, and streams without any
+ * segment for Options::idleTimeout of capture time are forgotten.
+ */
+class TcpReassembler : noncopyable
+{
+public:
+  struct Options
+  {
+    size_t capacity = 4096; ///< maximum number of streams
+    size_t maxEarlyBytes = 65536; ///< maximum size of the early segments of a stream
+    time::seconds idleTimeout = 60_s; ///< capture time after which an idle stream is forgotten
+  };
+
+  /**
+   * @brief TCP header fields used for reassembly
+   */
+  struct Segment
+  {
+    uint32_t sequence = 0;
+    bool isSyn = false;
+    bool isFin = false; ///< FIN or RST
+    const uint8_t* payload = nullptr;
+    size_t size = 0;
+  };
+
+  /**
+   * @brief called with each complete NDN packet, which is valid only during the call
+   */
+  using PacketCallback = std::function<void(const uint8_t* packet, size_t size)>;
+
+  explicit
+  TcpReassembler(const Options& options);
+
+  /**
+   * @brief add a segment, and call @p onPacket for each NDN packet that it completes
+   * @return number of packets completed by the segment
+   */
+  size_t
+  add(const timeval& ts, const FlowKey& flow, const Segment& segment, const PacketCallback& onPacket);
+
+  /**
+   * @brief number of tracked streams
+   */
+  size_t
+  size() const
+  {
+    return m_streams.size();
+  }
+
+  uint64_t
+  getNPackets() const
+  {
+    return m_nPackets;
+  }
+
+  /**
+   * @brief number of times a stream was framed again after a gap or invalid data
+   */
+  uint64_t
+  getNResyncs() const
+  {
+    return m_nResyncs;
+  }
+
+  /**
+   * @brief number of bytes that were not part of a complete NDN packet
+   */
+  uint64_t
+  getNSkippedBytes() const
+  {
+    return m_nSkippedBytes;
+  }
+
+  /**
+   * @brief number of streams forgotten to stay within the capacity
+   */
+  uint64_t
+  getNEvicted() const
+  {
+    return m_nEvicted;
+  }
+
+private:
+  struct Stream
+  {
+    uint32_t nextSequence = 0; ///< sequence number of the next in-order byte
+    bool isFramed = false; ///< whether the next in-order byte starts a TLV element
+    std::string partial; ///< beginning of an incomplete NDN packet
+    std::vector<std::pair<uint32_t, std::string>> early; ///< segments after a gap
+    size_t nEarlyBytes = 0;
+    int64_t lastSeen = 0; ///< capture time in microseconds
+    std::list<FlowKey>::iterator lru;
+  };
+
+  using StreamTable = std::unordered_map<FlowKey, Stream>;
+
+  void
+  expire(int64_t now);
+
+  StreamTable::iterator
+  findOrInsert(const FlowKey& flow, int64_t now);
+
+  void
+  erase(StreamTable::iterator stream);
+
+  /**
+   * @brief append the in-order bytes [@p data, @p data + @p size) to the stream
+   * @param isSegmentStart whether @p data is the start of a segment, where framing can resume
+   */
+  size_t
+  deliver(Stream& stream, const uint8_t* data, size_t size, bool isSegmentStart,
+          const PacketCallback& onPacket);
+
+  /**
+   * @brief deliver the early segments that are now in order
+   */
+  size_t
+  deliverEarly(Stream& stream, const PacketCallback& onPacket);
+
+  /**
+   * @brief drop the partial packet and skip to the first early segment
+   */
+  void
+  resync(Stream& stream);
+
+private:
+  const Options m_options;
+
+  StreamTable m_streams;
+  std::list<FlowKey> m_lru; ///< most recently used first
+
+  uint64_t m_nPackets = 0;
+  uint64_t m_nResyncs = 0;
+  uint64_t m_nSkippedBytes = 0;
+  uint64_t m_nEvicted = 0;
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_TCP_REASSEMBLER_HPP
@@ -0,0 +1,254 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "traffic-statistics.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <tuple>
+
+namespace ndn {
+namespace dump {
+
+static const lp::NackReason NACK_REASONS[] = {
+  lp::NackReason::NONE,
+  lp::NackReason::CONGESTION,
+  lp::NackReason::DUPLICATE,
+  lp::NackReason::NO_ROUTE,
+};
+
+void
+TrafficStatistics::Counters::add(PacketType type, size_t packetSize, lp::NackReason reason)
+{
+  switch (type) {
+  case PacketType::INTEREST:
+    ++nInterests;
+    break;
+  case PacketType::DATA:
+    ++nData;
+    break;
+  case PacketType::NACK: {
+    ++nNacks;
+    auto it = std::find(std::begin(NACK_REASONS), std::end(NACK_REASONS), reason);
+    // unknown reasons are counted as None, like lp::NackHeader does
+    ++nNackReasons[it == std::end(NACK_REASONS) ? 0 : std::distance(std::begin(NACK_REASONS), it)];
+    break;
+  }
+  }
+  nBytes += packetSize;
+}
+
+TrafficStatistics::TrafficStatistics(const Options& options, std::ostream& os)
+  : m_options(options)
+  , m_os(os)
+{
+  reset();
+}
+
+void
+TrafficStatistics::add(const timeval& ts, const FlowKey& flow, PacketType type,
+                       const uint8_t* name, size_t nameSize, size_t nBytes, lp::NackReason reason)
+{
+  int64_t now = static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_usec;
+  auto interval = time::duration_cast<time::microseconds>(m_options.interval).count();
+  if (m_intervalStart >= 0 && interval > 0 && now - m_intervalStart >= interval) {
+    printSnapshot();
+  }
+  if (m_intervalStart < 0) {
+    m_intervalStart = now;
+  }
+  m_lastPacket = now;
+  ++m_nPackets;
+
+  auto node = findOrInsert(name, nameSize);
+  (node ? m_nodes[*node].counters : m_otherPrefixes).add(type, nBytes, reason);
+
+  auto face = m_faceIndex.find(flow);
+  if (face == m_faceIndex.end() && m_faces.size() < m_options.maxEntries) {
+    face = m_faceIndex.emplace(flow, m_faces.size()).first;
+    m_faces.emplace_back(flow, Counters{});
+  }
+  (face != m_faceIndex.end() ? m_faces[face->second].second : m_otherFaces).add(type, nBytes, reason);
+}
+
+optional<size_t>
+TrafficStatistics::findOrInsert(const uint8_t* name, size_t nameSize)
+{
+  const uint8_t* pos = name;
+  const uint8_t* end = name + nameSize;
+  size_t index = 0;
+
+  for (size_t depth = 0; depth < m_options.depth && pos != end; ++depth) {
+    const uint8_t* begin = pos;
+    uint32_t type = 0;
+    uint64_t length = 0;
+    if (!tlv::readType(pos, end, type) || !tlv::readVarNumber(pos, end, length) ||
+        length > static_cast<uint64_t>(end - pos)) {
+      // count the packet under the components decoded so far
+      break;
+    }
+    pos += length;
+
+    m_key.assign(reinterpret_cast<const char*>(&index), sizeof(index));
+    m_key.append(reinterpret_cast<const char*>(begin), pos - begin);
+    auto it = m_children.find(m_key);
+    if (it != m_children.end()) {
+      index = it->second;
+      continue;
+    }
+
+    if (m_nodes.size() - 1 >= m_options.maxEntries) {
+      return nullopt;
+    }
+    m_nodes.push_back({index, name::Component(Block(begin, pos - begin)), {}});
+    index = m_nodes.size() - 1;
+    m_children.emplace(m_key, index);
+  }
+  return index;
+}
+
+Name
+TrafficStatistics::getPrefix(size_t index) const
+{
+  std::vector<const name::Component*> components;
+  for (; index != 0; index = m_nodes[index].parent) {
+    components.push_back(&m_nodes[index].component);
+  }
+
+  Name prefix;
+  std::for_each(components.rbegin(), components.rend(),
+                [&prefix] (const name::Component* c) { prefix.append(*c); });
+  return prefix;
+}
+
+static void
+printTimestamp(std::ostream& os, int64_t us)
+{
+  os << us / 1000000 << '.' << std::setfill('0') << std::setw(6) << us % 1000000 << std::setfill(' ');
+}
+
+static void
+printHeader(std::ostream& os, const std::string& label)
+{
+  os << "  " << std::left << std::setw(48) << label << std::right
+     << std::setw(10) << "INTERESTS" << std::setw(10) << "DATA" << std::setw(10) << "NACKS"
+     << std::setw(14) << "BYTES" << '\n';
+}
+
+static void
+printCounters(std::ostream& os, const std::string& label, const TrafficStatistics::Counters& counters)
+{
+  os << "  " << std::left << std::setw(48) << label << std::right
+     << std::setw(10) << counters.nInterests
+     << std::setw(10) << counters.nData
+     << std::setw(10) << counters.nNacks
+     << std::setw(14) << counters.nBytes;
+
+  for (size_t i = 0; i < counters.nNackReasons.size(); ++i) {
+    if (counters.nNackReasons[i] > 0) {
+      os << "  " << NACK_REASONS[i] << '=' << counters.nNackReasons[i];
+    }
+  }
+  os << '\n';
+}
+
+/**
+ * @brief keep the @p n indices of the busiest counters in @p indices, sorted by decreasing
+ *        packet count, byte count, and then increasing index
+ */
+template<typename GetCounters>
+static void
+sortTopN(std::vector<size_t>& indices, size_t n, const GetCounters& getCounters)
+{
+  n = std::min(n, indices.size());
+  std::partial_sort(indices.begin(), indices.begin() + n, indices.end(), [&getCounters] (size_t a, size_t b) {
+    const TrafficStatistics::Counters& ca = getCounters(a);
+    const TrafficStatistics::Counters& cb = getCounters(b);
+    return std::make_tuple(ca.getNPackets(), ca.nBytes, b) > std::make_tuple(cb.getNPackets(), cb.nBytes, a);
+  });
+  indices.resize(n);
+}
+
+void
+TrafficStatistics::printSnapshot()
+{
+  if (m_nPackets == 0) {
+    return;
+  }
+
+  // intermediate nodes of the trie have no packets of their own
+  std::vector<size_t> prefixes;
+  for (size_t i = 0; i < m_nodes.size(); ++i) {
+    if (m_nodes[i].counters.getNPackets() > 0) {
+      prefixes.push_back(i);
+    }
+  }
+
+  m_os << "--- ";
+  printTimestamp(m_os, m_intervalStart);
+  m_os << " - ";
+  printTimestamp(m_os, m_lastPacket);
+  m_os << ": " << m_nPackets << " packets, " << prefixes.size() << " prefixes, "
+       << m_faces.size() << " faces\n";
+
+  printHeader(m_os, "PREFIX");
+
+  sortTopN(prefixes, m_options.topN, [this] (size_t i) -> const Counters& { return m_nodes[i].counters; });
+  for (size_t i : prefixes) {
+    printCounters(m_os, getPrefix(i).toUri(), m_nodes[i].counters);
+  }
+  if (m_otherPrefixes.getNPackets() > 0) {
+    printCounters(m_os, "(other)", m_otherPrefixes);
+  }
+
+  printHeader(m_os, "FACE");
+
+  std::vector<size_t> faces(m_faces.size());
+  std::iota(faces.begin(), faces.end(), 0);
+  sortTopN(faces, m_options.topN, [this] (size_t i) -> const Counters& { return m_faces[i].second; });
+  for (size_t i : faces) {
+    printCounters(m_os, boost::lexical_cast<std::string>(m_faces[i].first), m_faces[i].second);
+  }
+  if (m_otherFaces.getNPackets() > 0) {
+    printCounters(m_os, "(other)", m_otherFaces);
+  }
+
+  m_os.flush();
+  reset();
+}
+
+void
+TrafficStatistics::reset()
+{
+  m_nodes.clear();
+  m_nodes.push_back({0, {}, {}});
+  m_children.clear();
+  m_faces.clear();
+  m_faceIndex.clear();
+  m_otherPrefixes = {};
+  m_otherFaces = {};
+  m_intervalStart = -1;
+  m_nPackets = 0;
+}
+
+} // namespace dump
+} // namespace ndn
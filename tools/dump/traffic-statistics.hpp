@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2021, Regents of the University of California.
+ *
+ * This file is part of ndn-tools (Named Data Networking Essential Tools).
+ * See AUTHORS.md for complete list of ndn-tools authors and contributors.
+ *
+ * ndn-tools is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndn-tools is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndn-tools, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDN_TOOLS_DUMP_TRAFFIC_STATISTICS_HPP
+#define NDN_TOOLS_DUMP_TRAFFIC_STATISTICS_HPP
+
+#include "flow-key.hpp"
+
+#include <ndn-cxx/lp/nack-header.hpp>
+
+#include <unordered_map>
+
+namespace ndn {
+namespace dump {
+
+/**
+ * @brief Per-prefix and per-face packet counters, printed as periodic top-N snapshots
+ *
+ * Names are truncated to Options::depth components and stored in a trie, so that the prefixes
+ * share their common components. Each packet is counted at the node of its truncated name
+ * and at its face. Every Options::interval of capture time, the busiest prefixes and faces
+ * are printed and all counters are reset, which also bounds the memory use to
+ * Options::maxEntries prefixes and faces per interval. Prefixes and faces with the same counts
+ * are printed in order of appearance.
+ */
+class TrafficStatistics : noncopyable
+{
+public:
+  struct Options
+  {
+    size_t depth = 3; ///< number of name components kept in a prefix
+    size_t topN = 10; ///< number of prefixes and faces printed in each snapshot
+    time::seconds interval = 10_s; ///< capture time between snapshots; zero means only at the end
+    size_t maxEntries = 65536; ///< prefixes or faces beyond this are counted as "(other)"
+  };
+
+  enum class PacketType {
+    INTEREST,
+    DATA,
+    NACK,
+  };
+
+  struct Counters
+  {
+    uint64_t nInterests = 0;
+    uint64_t nData = 0;
+    uint64_t nNacks = 0;
+    uint64_t nBytes = 0;
+    std::array<uint64_t, 4> nNackReasons{}; ///< None, Congestion, Duplicate, NoRoute
+
+    uint64_t
+    getNPackets() const
+    {
+      return nInterests + nData + nNacks;
+    }
+
+    void
+    add(PacketType type, size_t nBytes, lp::NackReason reason);
+  };
+
+  TrafficStatistics(const Options& options, std::ostream& os);
+
+  /**
+   * @brief count a packet
+   * @param ts capture time; if an interval has elapsed since the previous snapshot,
+   *           a snapshot is printed before counting the packet
+   * @param name TLV-VALUE of the packet's Name
+   * @param nBytes size of the network packet
+   */
+  void
+  add(const timeval& ts, const FlowKey& flow, PacketType type,
+      const uint8_t* name, size_t nameSize, size_t nBytes,
+      lp::NackReason reason = lp::NackReason::NONE);
+
+  /**
+   * @brief print the busiest prefixes and faces since the previous snapshot, then reset
+   *
+   * Does nothing if no packet was counted since the previous snapshot.
+   */
+  void
+  printSnapshot();
+
+  /**
+   * @brief number of prefixes in the trie, including the root
+   */
+  size_t
+  getNPrefixes() const
+  {
+    return m_nodes.size();
+  }
+
+  size_t
+  getNFaces() const
+  {
+    return m_faces.size();
+  }
+
+private:
+  /**
+   * @return index of the node of the first Options::depth components of @p name,
+   *         or nullopt if the trie is full
+   */
+  optional<size_t>
+  findOrInsert(const uint8_t* name, size_t nameSize);
+
+  Name
+  getPrefix(size_t index) const;
+
+  void
+  reset();
+
+private:
+  struct Node
+  {
+    size_t parent;
+    name::Component component;
+    Counters counters;
+  };
+
+  const Options m_options;
+  std::ostream& m_os;
+
+  std::vector<Node> m_nodes; ///< m_nodes[0] is the root
+  std::unordered_map<std::string, size_t> m_children; ///< parent index + component TLV => index
+  std::string m_key; ///< reused by findOrInsert() to avoid allocating on every lookup
+  std::vector<std::pair<FlowKey, Counters>> m_faces; ///< in order of appearance
+  std::unordered_map<FlowKey, size_t> m_faceIndex; ///< FlowKey => index in m_faces
+  Counters m_otherPrefixes;
+  Counters m_otherFaces;
+
+  int64_t m_intervalStart = -1; ///< capture time of the first packet of the interval, in microseconds
+  int64_t m_lastPacket = 0;
+  uint64_t m_nPackets = 0;
+};
+
+} // namespace dump
+} // namespace ndn
+
+#endif // NDN_TOOLS_DUMP_TRAFFIC_STATISTICS_HPP